@@ -0,0 +1,111 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <utility>
+
+// Ограниченная блокирующая очередь между стадиями конвейера паука.
+// push() ждёт, пока в очереди не появится место (backpressure),
+// pop() ждёт, пока не появится элемент. После close() обе операции
+// сразу возвращают false, а оставшиеся элементы отбрасываются.
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(capacity == 0 ? 1 : capacity)
+        , closed_(false)
+    {
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Добавление элемента (ждёт свободного места)
+    bool push(T item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+
+        if (closed_)
+        {
+            return false;
+        }
+
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // Добавление без ожидания: false, если очередь заполнена или закрыта
+    bool tryPush(T item)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || items_.size() >= capacity_)
+        {
+            return false;
+        }
+
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    // Извлечение элемента (ждёт, пока очередь не станет непустой)
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+
+        if (closed_)
+        {
+            return false;
+        }
+
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    // Закрытие очереди: будит все ожидающие потоки
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        items_.clear();
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+    // Повторное открытие (перед новым запуском)
+    void reopen()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = false;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    bool closed_;
+    mutable std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+};
+
+#endif // BOUNDEDQUEUE_H
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "BumpArena.h"
+#include <algorithm>
+
+BumpArena::BumpArena(size_t blockSize)
+    : blockSize_(std::max<size_t>(blockSize, 1024))
+    , current_(0)
+    , offset_(0)
+    , used_(0)
+{
+}
+
+char* BumpArena::allocate(size_t size)
+{
+    if (current_ < blocks_.size() && blocks_[current_].size - offset_ >= size)
+    {
+        char* pointer = blocks_[current_].data.get() + offset_;
+        offset_ += size;
+        used_ += size;
+        return pointer;
+    }
+
+    // Следующий сохранённый блок, в который поместится запрос. Остаток
+    // текущего блока пропадает до reset()
+    size_t next = current_ < blocks_.size() ? current_ + 1 : current_;
+    while (next < blocks_.size() && blocks_[next].size < size)
+    {
+        next++;
+    }
+
+    if (next >= blocks_.size())
+    {
+        size_t newSize = std::max(blockSize_, size);
+        blocks_.push_back({ std::make_unique<char[]>(newSize), newSize });
+        next = blocks_.size() - 1;
+    }
+    else if (next != current_ + 1 && current_ + 1 < blocks_.size())
+    {
+        // Пропущенные маленькие блоки ставим после найденного, чтобы
+        // они остались доступны следующим запросам
+        std::swap(blocks_[current_ + 1], blocks_[next]);
+        next = current_ + 1;
+    }
+
+    current_ = next;
+    offset_ = size;
+    used_ += size;
+    return blocks_[current_].data.get();
+}
+
+void BumpArena::reset()
+{
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t BumpArena::getUsed() const
+{
+    return used_;
+}
+
+size_t BumpArena::getCapacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : blocks_)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
\ No newline at end of file
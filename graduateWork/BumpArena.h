@@ -0,0 +1,46 @@
+#ifndef BUMPARENA_H
+#define BUMPARENA_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// Линейный распределитель памяти для данных одной страницы.
+// allocate() сдвигает указатель внутри текущего блока, освобождения
+// по отдельности нет - вся память возвращается разом через reset().
+// Блоки после reset() остаются и переиспользуются, поэтому на
+// установившемся потоке страниц арена не обращается к куче.
+// Объект не потокобезопасен: одна арена на поток.
+class BumpArena
+{
+public:
+    explicit BumpArena(size_t blockSize = 64 * 1024);
+
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    // size байт без выравнивания (для строк)
+    char* allocate(size_t size);
+
+    // Освобождение всей памяти (блоки сохраняются)
+    void reset();
+
+    // Занято байт с последнего reset() и выделено всего
+    size_t getUsed() const;
+    size_t getCapacity() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    const size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t current_;   // индекс текущего блока
+    size_t offset_;    // занято в текущем блоке
+    size_t used_;
+};
+
+#endif // BUMPARENA_H
\ No newline at end of file
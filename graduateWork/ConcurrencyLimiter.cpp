@@ -0,0 +1,122 @@
+#include "ConcurrencyLimiter.h"
+#include <algorithm>
+
+ConcurrencyLimiter::ConcurrencyLimiter(int initialLimit, int minLimit, int maxLimit)
+    : minLimit_(std::max(1, minLimit))
+    , maxLimit_(std::max(minLimit_, maxLimit))
+    , limit_(std::clamp<double>(initialLimit, minLimit_, maxLimit_))
+    , inFlight_(0)
+    , closed_(false)
+    , publishedLimit_(0)
+    , publishedInFlight_(0)
+{
+    publish();
+}
+
+void ConcurrencyLimiter::publish()
+{
+    publishedLimit_ = static_cast<int>(limit_);
+    publishedInFlight_ = inFlight_;
+}
+
+bool ConcurrencyLimiter::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    slotCV_.wait(lock, [this]() {
+        return closed_ || inFlight_ < static_cast<int>(limit_);
+        });
+
+    if (closed_)
+    {
+        return false;
+    }
+
+    inFlight_++;
+    publish();
+    return true;
+}
+
+void ConcurrencyLimiter::release(const std::string& host, double latencyMs, bool dropped, bool saturated)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Лимит используется, если занята хотя бы половина слотов
+    bool utilized = inFlight_ * 2 >= static_cast<int>(limit_);
+    inFlight_--;
+
+    if (!dropped && latencyMs > 0.0)
+    {
+        if (noLoadLatencyMs_.size() >= kMaxHosts && noLoadLatencyMs_.count(host) == 0)
+        {
+            for (auto it = noLoadLatencyMs_.begin(); it != noLoadLatencyMs_.end() && noLoadLatencyMs_.size() > kMaxHosts / 2;)
+            {
+                it = noLoadLatencyMs_.erase(it);
+            }
+        }
+
+        // Задержка хоста без нагрузки: минимум с медленным дрейфом вверх,
+        // чтобы оценка не застревала на случайно быстром ответе
+        double& noLoadLatencyMs = noLoadLatencyMs_[host];
+        if (noLoadLatencyMs <= 0.0 || latencyMs < noLoadLatencyMs)
+        {
+            noLoadLatencyMs = latencyMs;
+        }
+        else
+        {
+            noLoadLatencyMs += (latencyMs - noLoadLatencyMs) * 0.01;
+        }
+
+        if (latencyMs > noLoadLatencyMs * kTolerance)
+        {
+            dropped = true;
+        }
+    }
+
+    if (dropped)
+    {
+        limit_ = std::max<double>(minLimit_, limit_ * kBackoffRatio);
+    }
+    else if (utilized && !saturated)
+    {
+        limit_ = std::min<double>(maxLimit_, limit_ + 1.0);
+    }
+
+    publish();
+    slotCV_.notify_all();
+}
+
+void ConcurrencyLimiter::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    inFlight_--;
+    publish();
+    slotCV_.notify_one();
+}
+
+void ConcurrencyLimiter::close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    slotCV_.notify_all();
+}
+
+void ConcurrencyLimiter::reopen()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = false;
+}
+
+int ConcurrencyLimiter::getLimit() const
+{
+    return publishedLimit_;
+}
+
+int ConcurrencyLimiter::getMaxLimit() const
+{
+    return maxLimit_;
+}
+
+int ConcurrencyLimiter::getInFlight() const
+{
+    return publishedInFlight_;
+}
\ No newline at end of file
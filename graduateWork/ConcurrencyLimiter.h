@@ -0,0 +1,71 @@
+#ifndef CONCURRENCYLIMITER_H
+#define CONCURRENCYLIMITER_H
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Адаптивный ограничитель числа одновременных операций (AIMD).
+// Идея взята из Netflix concurrency-limits: лимит растёт на единицу после
+// каждой успешной операции, пока он действительно используется, и
+// умножается на коэффициент < 1 при ошибке, таймауте или росте задержки
+// относительно задержки "без нагрузки". Так число одновременных загрузок
+// само подстраивается под сеть, процессор и скорость следующих стадий.
+// Задержка без нагрузки своя у каждого хоста: иначе один быстрый хост
+// делал бы все медленные "перегруженными" и лимит падал бы до минимума.
+class ConcurrencyLimiter
+{
+public:
+    ConcurrencyLimiter(int initialLimit, int minLimit, int maxLimit);
+
+    // Ожидание свободного слота. false - ограничитель закрыт
+    bool acquire();
+
+    // Освобождение слота с результатом операции:
+    // host - с кем шла операция, latencyMs - длительность,
+    // dropped - признак перегрузки (таймаут, 429/503),
+    // saturated - следующая стадия не успевает
+    void release(const std::string& host, double latencyMs, bool dropped, bool saturated);
+
+    // Освобождение слота без влияния на лимит (операция не состоялась)
+    void cancel();
+
+    // Закрытие: будит все ожидающие потоки
+    void close();
+    void reopen();
+
+    int getLimit() const;
+    int getMaxLimit() const;
+    int getInFlight() const;
+
+private:
+    const int minLimit_;
+    const int maxLimit_;
+
+    // Во сколько раз задержка может превысить задержку без нагрузки,
+    // прежде чем это считается перегрузкой
+    static constexpr double kTolerance = 2.0;
+
+    // Множитель при перегрузке
+    static constexpr double kBackoffRatio = 0.9;
+
+    // Сколько хостов помнить; при переполнении забывается половина
+    static constexpr size_t kMaxHosts = 4096;
+
+    mutable std::mutex mutex_;
+    std::condition_variable slotCV_;
+    double limit_;
+    int inFlight_;
+    std::unordered_map<std::string, double> noLoadLatencyMs_;  // по хостам
+    bool closed_;
+
+    // Копии для чтения статистики без блокировки
+    std::atomic<int> publishedLimit_;
+    std::atomic<int> publishedInFlight_;
+
+    void publish();
+};
+
+#endif // CONCURRENCYLIMITER_H
\ No newline at end of file
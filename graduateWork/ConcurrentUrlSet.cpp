@@ -0,0 +1,66 @@
+#include "ConcurrentUrlSet.h"
+#include <functional>
+
+ConcurrentUrlSet::Shard& ConcurrentUrlSet::shardFor(size_t hash)
+{
+    // Старшие биты хеша перемешиваем с младшими: у std::hash для строк
+    // младшие биты могут быть распределены неравномерно
+    return shards_[(hash ^ (hash >> 17)) & (kShardCount - 1)];
+}
+
+const ConcurrentUrlSet::Shard& ConcurrentUrlSet::shardFor(size_t hash) const
+{
+    return shards_[(hash ^ (hash >> 17)) & (kShardCount - 1)];
+}
+
+bool ConcurrentUrlSet::insertIfAbsent(const std::string& url)
+{
+    size_t hash = std::hash<std::string>{}(url);
+    Shard& shard = shardFor(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.urls.insert(url).second;
+}
+
+bool ConcurrentUrlSet::contains(const std::string& url) const
+{
+    size_t hash = std::hash<std::string>{}(url);
+    const Shard& shard = shardFor(hash);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.urls.find(url) != shard.urls.end();
+}
+
+size_t ConcurrentUrlSet::size() const
+{
+    size_t total = 0;
+    for (const auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.urls.size();
+    }
+    return total;
+}
+
+std::vector<std::string> ConcurrentUrlSet::snapshot() const
+{
+    std::vector<std::string> urls;
+    urls.reserve(size());
+
+    for (const auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        urls.insert(urls.end(), shard.urls.begin(), shard.urls.end());
+    }
+
+    return urls;
+}
+
+void ConcurrentUrlSet::clear()
+{
+    for (auto& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.urls.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef CONCURRENTURLSET_H
+#define CONCURRENTURLSET_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <mutex>
+#include <unordered_set>
+#include <cstddef>
+
+// Потокобезопасное множество URL с разбиением на сегменты (lock striping).
+// Каждый сегмент защищён своим мьютексом, поэтому потоки, работающие
+// с разными URL, практически не конкурируют за блокировку.
+class ConcurrentUrlSet
+{
+public:
+    ConcurrentUrlSet() = default;
+
+    ConcurrentUrlSet(const ConcurrentUrlSet&) = delete;
+    ConcurrentUrlSet& operator=(const ConcurrentUrlSet&) = delete;
+
+    // Атомарная проверка и вставка.
+    // Возвращает true, если URL добавлен впервые, и false, если он уже был
+    bool insertIfAbsent(const std::string& url);
+
+    // Проверка наличия URL
+    bool contains(const std::string& url) const;
+
+    // Количество URL во всех сегментах
+    size_t size() const;
+
+    // Копия всех URL (для сохранения состояния)
+    std::vector<std::string> snapshot() const;
+
+    // Очистка множества
+    void clear();
+
+private:
+    // Количество сегментов (степень двойки)
+    static constexpr size_t kShardCount = 64;
+
+    // Сегмент выравниваем по строке кэша, чтобы мьютексы соседних
+    // сегментов не делили одну линию (false sharing)
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        std::unordered_set<std::string> urls;
+    };
+
+    std::array<Shard, kShardCount> shards_;
+
+    // Выбор сегмента по хешу URL
+    Shard& shardFor(size_t hash);
+    const Shard& shardFor(size_t hash) const;
+};
+
+#endif // CONCURRENTURLSET_H
\ No newline at end of file
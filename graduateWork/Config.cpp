@@ -1,6 +1,25 @@
 #include "Config.h"
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
+#include <sstream>
+
+// Разбор списка значений через запятую
+static std::vector<std::string> splitList(const std::string& list)
+{
+	std::vector<std::string> items;
+	std::istringstream stream(list);
+	std::string item;
+	while (std::getline(stream, item, ','))
+	{
+		item.erase(0, item.find_first_not_of(" \t"));
+		item.erase(item.find_last_not_of(" \t") + 1);
+		if (!item.empty())
+		{
+			items.push_back(item);
+		}
+	}
+	return items;
+}
 
 Config::Config(const std::string& filePath)
 {
@@ -21,9 +40,70 @@ Config::Config(const std::string& filePath)
 		spiderMaxDepth_ = config.get<int>("spider.maxDepth");
 		spiderStartUrl_ = config.get<std::string>("spider.startUrl");
 		runSpider_ = config.get<bool>("spider.runSpider");
+		spiderStateDir_ = config.get<std::string>("spider.stateDir", "");
+		spiderFrontierMemoryLimit_ = config.get<int>("spider.frontierMemoryLimit", 100000);
+		spiderCheckpointInterval_ = config.get<int>("spider.checkpointInterval", 60);
+		spiderSortQueryParams_ = config.get<bool>("spider.sortQueryParams", true);
+		spiderFetchWorkers_ = config.get<int>("spider.fetchWorkers", 0);
+		spiderParseWorkers_ = config.get<int>("spider.parseWorkers", 0);
+		spiderIndexWorkers_ = config.get<int>("spider.indexWorkers", 0);
+		spiderStoreWorkers_ = config.get<int>("spider.storeWorkers", 0);
+		spiderStageQueueCapacity_ = config.get<int>("spider.stageQueueCapacity", 256);
+		spiderAdaptiveConcurrency_ = config.get<bool>("spider.adaptiveConcurrency", true);
+		spiderMinFetchConcurrency_ = config.get<int>("spider.minFetchConcurrency", 2);
+		spiderMaxFetchConcurrency_ = config.get<int>("spider.maxFetchConcurrency", 0);
+		spiderMaxBodySize_ = config.get<long long>("spider.maxBodySize", 5 * 1024 * 1024);
+		spiderAllowedContentTypes_ = splitList(config.get<std::string>("spider.allowedContentTypes", "text/html, application/xhtml+xml"));
+		spiderCompressedTransfer_ = config.get<bool>("spider.compressedTransfer", true);
+		spiderAcceptEncoding_ = config.get<std::string>("spider.acceptEncoding", "");
+		spiderMaxCompressionRatio_ = config.get<double>("spider.maxCompressionRatio", 100.0);
+		spiderDuplicatePolicy_ = config.get<std::string>("spider.duplicatePolicy", "skip");
+		spiderDuplicateHistory_ = config.get<int>("spider.duplicateHistory", 100000);
+		spiderDuplicateMaxDistance_ = config.get<int>("spider.duplicateMaxDistance", 3);
+		spiderWarcRecordPath_ = config.get<std::string>("spider.warcRecordPath", "");
+		spiderWarcReplayPath_ = config.get<std::string>("spider.warcReplayPath", "");
+		spiderShardIndex_ = config.get<int>("spider.shardIndex", 0);
+		spiderShardPeers_ = splitList(config.get<std::string>("spider.shardPeers", ""));
+		spiderShardBatchSize_ = config.get<int>("spider.shardBatchSize", 256);
+		spiderShardFlushMillis_ = config.get<int>("spider.shardFlushMillis", 200);
+		spiderRespectRobots_ = config.get<bool>("spider.respectRobots", true);
+		spiderRobotsCacheTtl_ = config.get<int>("spider.robotsCacheTtl", 3600);
+		spiderRobotsCacheHosts_ = config.get<int>("spider.robotsCacheHosts", 100000);
+		spiderUseSitemaps_ = config.get<bool>("spider.useSitemaps", true);
+		spiderSitemapMaxUrls_ = config.get<int>("spider.sitemapMaxUrls", 50000);
+		spiderMaxRetries_ = config.get<int>("spider.maxRetries", 3);
+		spiderRetryBaseDelayMs_ = config.get<int>("spider.retryBaseDelayMs", 1000);
+		spiderRetryMaxDelayMs_ = config.get<int>("spider.retryMaxDelayMs", 60000);
+		spiderBreakerFailures_ = config.get<int>("spider.breakerFailures", 5);
+		spiderBreakerOpenSeconds_ = config.get<int>("spider.breakerOpenSeconds", 30);
+		spiderMinFetchTimeoutMs_ = config.get<int>("spider.minFetchTimeoutMs", 2000);
+		spiderMaxFetchTimeoutMs_ = config.get<int>("spider.maxFetchTimeoutMs", 30000);
+		spiderContinuous_ = config.get<bool>("spider.continuous", false);
+		spiderRecrawlMinInterval_ = config.get<int>("spider.recrawlMinInterval", 3600);
+		spiderRecrawlMaxInterval_ = config.get<int>("spider.recrawlMaxInterval", 2592000);
+		spiderRecrawlInitialInterval_ = config.get<int>("spider.recrawlInitialInterval", 86400);
+		spiderRecrawlBudget_ = config.get<int>("spider.recrawlBudget", 120);
+		spiderStripQueryParams_ = splitList(config.get<std::string>("spider.stripQueryParams", ""));
 
 		// Читаем настройки поисковика
 		searcherPort_ = config.get<int>("searcher.port");
+		searcherCandidateLimit_ = config.get<int>("searcher.candidateLimit", 1000);
+
+		// Читаем настройки индексации
+		indexStemmers_ = splitList(config.get<std::string>("index.stemmers", "russian, english"));
+		indexStopWords_ = splitList(config.get<std::string>("index.stopWords", "russian, english"));
+		indexStopWordsFile_ = config.get<std::string>("index.stopWordsFile", "");
+
+		// Читаем настройки нагрузочного стенда (секция необязательна)
+		benchPages_ = config.get<int>("bench.pages", 2000);
+		benchFanout_ = config.get<int>("bench.fanout", 10);
+		benchPageSize_ = config.get<int>("bench.pageSize", 16384);
+		benchLatencyMs_ = config.get<int>("bench.latencyMs", 20);
+		benchErrorRate_ = config.get<double>("bench.errorRate", 0.01);
+		benchHosts_ = config.get<int>("bench.hosts", 4);
+		benchPort_ = config.get<int>("bench.port", 8090);
+		benchServerThreads_ = config.get<int>("bench.serverThreads", 4);
+		benchTimeLimit_ = config.get<int>("bench.timeLimit", 600);
 	}
 	catch (const std::exception& e)
 	{
@@ -48,5 +128,126 @@ const std::string& Config::getSpiderStartUrl() const { return spiderStartUrl_; }
 int Config::getSpiderMaxDepth() const { return spiderMaxDepth_; }
 
 int Config::getSearcherPort() const { return searcherPort_; }
+int Config::getSearcherCandidateLimit() const { return searcherCandidateLimit_; }
+
+const std::vector<std::string>& Config::getIndexStemmers() const { return indexStemmers_; }
+
+const std::vector<std::string>& Config::getIndexStopWords() const { return indexStopWords_; }
+
+const std::string& Config::getIndexStopWordsFile() const { return indexStopWordsFile_; }
+
+int Config::getBenchPages() const { return benchPages_; }
+
+int Config::getBenchFanout() const { return benchFanout_; }
+
+int Config::getBenchPageSize() const { return benchPageSize_; }
+
+int Config::getBenchLatencyMs() const { return benchLatencyMs_; }
+
+double Config::getBenchErrorRate() const { return benchErrorRate_; }
+
+int Config::getBenchHosts() const { return benchHosts_; }
+
+int Config::getBenchPort() const { return benchPort_; }
+
+int Config::getBenchServerThreads() const { return benchServerThreads_; }
+
+int Config::getBenchTimeLimit() const { return benchTimeLimit_; }
+
+void Config::setSpiderStartUrl(const std::string& url) { spiderStartUrl_ = url; }
+
+void Config::setSpiderMaxDepth(int depth) { spiderMaxDepth_ = depth; }
+
+void Config::setSpiderStateDir(const std::string& dir) { spiderStateDir_ = dir; }
+
+void Config::setSpiderShardIndex(int index) { spiderShardIndex_ = index; }
+
+bool Config::shouldRunSpider() const { return runSpider_; }
+
+const std::string& Config::getSpiderStateDir() const { return spiderStateDir_; }
+
+int Config::getSpiderFrontierMemoryLimit() const { return spiderFrontierMemoryLimit_; }
+
+int Config::getSpiderCheckpointInterval() const { return spiderCheckpointInterval_; }
+
+const std::vector<std::string>& Config::getSpiderStripQueryParams() const { return spiderStripQueryParams_; }
+
+bool Config::shouldSortQueryParams() const { return spiderSortQueryParams_; }
+
+int Config::getSpiderFetchWorkers() const { return spiderFetchWorkers_; }
+
+int Config::getSpiderParseWorkers() const { return spiderParseWorkers_; }
+
+int Config::getSpiderIndexWorkers() const { return spiderIndexWorkers_; }
+
+int Config::getSpiderStoreWorkers() const { return spiderStoreWorkers_; }
+
+int Config::getSpiderStageQueueCapacity() const { return spiderStageQueueCapacity_; }
+
+bool Config::isAdaptiveConcurrency() const { return spiderAdaptiveConcurrency_; }
+
+int Config::getSpiderMinFetchConcurrency() const { return spiderMinFetchConcurrency_; }
+
+int Config::getSpiderMaxFetchConcurrency() const { return spiderMaxFetchConcurrency_; }
+
+long long Config::getSpiderMaxBodySize() const { return spiderMaxBodySize_; }
+
+const std::vector<std::string>& Config::getSpiderAllowedContentTypes() const { return spiderAllowedContentTypes_; }
+
+bool Config::isCompressedTransfer() const { return spiderCompressedTransfer_; }
+
+const std::string& Config::getSpiderAcceptEncoding() const { return spiderAcceptEncoding_; }
+
+double Config::getSpiderMaxCompressionRatio() const { return spiderMaxCompressionRatio_; }
+
+const std::string& Config::getSpiderDuplicatePolicy() const { return spiderDuplicatePolicy_; }
+
+int Config::getSpiderDuplicateHistory() const { return spiderDuplicateHistory_; }
+
+int Config::getSpiderDuplicateMaxDistance() const { return spiderDuplicateMaxDistance_; }
+
+const std::string& Config::getSpiderWarcRecordPath() const { return spiderWarcRecordPath_; }
+
+const std::string& Config::getSpiderWarcReplayPath() const { return spiderWarcReplayPath_; }
+
+int Config::getSpiderShardIndex() const { return spiderShardIndex_; }
+
+const std::vector<std::string>& Config::getSpiderShardPeers() const { return spiderShardPeers_; }
+
+int Config::getSpiderShardBatchSize() const { return spiderShardBatchSize_; }
+
+int Config::getSpiderShardFlushMillis() const { return spiderShardFlushMillis_; }
+
+bool Config::shouldRespectRobots() const { return spiderRespectRobots_; }
+
+int Config::getSpiderRobotsCacheTtl() const { return spiderRobotsCacheTtl_; }
+
+int Config::getSpiderRobotsCacheHosts() const { return spiderRobotsCacheHosts_; }
+
+bool Config::shouldUseSitemaps() const { return spiderUseSitemaps_; }
+
+int Config::getSpiderSitemapMaxUrls() const { return spiderSitemapMaxUrls_; }
+
+int Config::getSpiderMaxRetries() const { return spiderMaxRetries_; }
+
+int Config::getSpiderRetryBaseDelayMs() const { return spiderRetryBaseDelayMs_; }
+
+int Config::getSpiderRetryMaxDelayMs() const { return spiderRetryMaxDelayMs_; }
+
+int Config::getSpiderBreakerFailures() const { return spiderBreakerFailures_; }
+
+int Config::getSpiderBreakerOpenSeconds() const { return spiderBreakerOpenSeconds_; }
+
+int Config::getSpiderMinFetchTimeoutMs() const { return spiderMinFetchTimeoutMs_; }
+
+int Config::getSpiderMaxFetchTimeoutMs() const { return spiderMaxFetchTimeoutMs_; }
+
+bool Config::isContinuousCrawl() const { return spiderContinuous_; }
+
+int Config::getSpiderRecrawlMinInterval() const { return spiderRecrawlMinInterval_; }
+
+int Config::getSpiderRecrawlMaxInterval() const { return spiderRecrawlMaxInterval_; }
+
+int Config::getSpiderRecrawlInitialInterval() const { return spiderRecrawlInitialInterval_; }
 
-bool Config::shouldRunSpider() const { return runSpider_; }
\ No newline at end of file
+int Config::getSpiderRecrawlBudget() const { return spiderRecrawlBudget_; }
\ No newline at end of file
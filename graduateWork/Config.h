@@ -2,6 +2,7 @@
 #define CONFIG_H
 
 #include <iostream>
+#include <vector>
 
 class Config
 {
@@ -17,9 +18,70 @@ private:
 	std::string spiderStartUrl_{};
 	int spiderMaxDepth_{};
 	bool runSpider_;
+	std::string spiderStateDir_{};
+	int spiderFrontierMemoryLimit_{};
+	int spiderCheckpointInterval_{};
+	std::vector<std::string> spiderStripQueryParams_{};
+	bool spiderSortQueryParams_{};
+	int spiderFetchWorkers_{};
+	int spiderParseWorkers_{};
+	int spiderIndexWorkers_{};
+	int spiderStoreWorkers_{};
+	int spiderStageQueueCapacity_{};
+	bool spiderAdaptiveConcurrency_{};
+	int spiderMinFetchConcurrency_{};
+	int spiderMaxFetchConcurrency_{};
+	long long spiderMaxBodySize_{};
+	std::vector<std::string> spiderAllowedContentTypes_{};
+	bool spiderCompressedTransfer_{};
+	std::string spiderAcceptEncoding_{};
+	double spiderMaxCompressionRatio_{};
+	std::string spiderDuplicatePolicy_{};
+	int spiderDuplicateHistory_{};
+	int spiderDuplicateMaxDistance_{};
+	std::string spiderWarcRecordPath_{};
+	std::string spiderWarcReplayPath_{};
+	int spiderShardIndex_{};
+	std::vector<std::string> spiderShardPeers_{};
+	int spiderShardBatchSize_{};
+	int spiderShardFlushMillis_{};
+	bool spiderRespectRobots_{};
+	int spiderRobotsCacheTtl_{};
+	int spiderRobotsCacheHosts_{};
+	bool spiderUseSitemaps_{};
+	int spiderSitemapMaxUrls_{};
+	int spiderMaxRetries_{};
+	int spiderRetryBaseDelayMs_{};
+	int spiderRetryMaxDelayMs_{};
+	int spiderBreakerFailures_{};
+	int spiderBreakerOpenSeconds_{};
+	int spiderMinFetchTimeoutMs_{};
+	int spiderMaxFetchTimeoutMs_{};
+	bool spiderContinuous_{};
+	int spiderRecrawlMinInterval_{};
+	int spiderRecrawlMaxInterval_{};
+	int spiderRecrawlInitialInterval_{};
+	int spiderRecrawlBudget_{};
 
 	// Параметры поисковика
 	int searcherPort_{};
+	int searcherCandidateLimit_{};
+
+	// Параметры индексации
+	std::vector<std::string> indexStemmers_{};
+	std::vector<std::string> indexStopWords_{};
+	std::string indexStopWordsFile_{};
+
+	// Параметры нагрузочного стенда (синтетический сайт)
+	int benchPages_{};
+	int benchFanout_{};
+	int benchPageSize_{};
+	int benchLatencyMs_{};
+	double benchErrorRate_{};
+	int benchHosts_{};
+	int benchPort_{};
+	int benchServerThreads_{};
+	int benchTimeLimit_{};
 
 public:
 	// Конструктор с указанием пути к файлу
@@ -36,9 +98,76 @@ public:
 	const std::string& getSpiderStartUrl() const;
 	int getSpiderMaxDepth() const;
 	bool shouldRunSpider() const;
+	const std::string& getSpiderStateDir() const;
+	int getSpiderFrontierMemoryLimit() const;
+	int getSpiderCheckpointInterval() const;
+	const std::vector<std::string>& getSpiderStripQueryParams() const;
+	bool shouldSortQueryParams() const;
+	int getSpiderFetchWorkers() const;
+	int getSpiderParseWorkers() const;
+	int getSpiderIndexWorkers() const;
+	int getSpiderStoreWorkers() const;
+	int getSpiderStageQueueCapacity() const;
+	bool isAdaptiveConcurrency() const;
+	int getSpiderMinFetchConcurrency() const;
+	int getSpiderMaxFetchConcurrency() const;
+	long long getSpiderMaxBodySize() const;
+	const std::vector<std::string>& getSpiderAllowedContentTypes() const;
+	bool isCompressedTransfer() const;
+	const std::string& getSpiderAcceptEncoding() const;
+	double getSpiderMaxCompressionRatio() const;
+	const std::string& getSpiderDuplicatePolicy() const;
+	int getSpiderDuplicateHistory() const;
+	int getSpiderDuplicateMaxDistance() const;
+	const std::string& getSpiderWarcRecordPath() const;
+	const std::string& getSpiderWarcReplayPath() const;
+	int getSpiderShardIndex() const;
+	const std::vector<std::string>& getSpiderShardPeers() const;
+	int getSpiderShardBatchSize() const;
+	int getSpiderShardFlushMillis() const;
+	bool shouldRespectRobots() const;
+	int getSpiderRobotsCacheTtl() const;
+	int getSpiderRobotsCacheHosts() const;
+	bool shouldUseSitemaps() const;
+	int getSpiderSitemapMaxUrls() const;
+	int getSpiderMaxRetries() const;
+	int getSpiderRetryBaseDelayMs() const;
+	int getSpiderRetryMaxDelayMs() const;
+	int getSpiderBreakerFailures() const;
+	int getSpiderBreakerOpenSeconds() const;
+	int getSpiderMinFetchTimeoutMs() const;
+	int getSpiderMaxFetchTimeoutMs() const;
+	bool isContinuousCrawl() const;
+	int getSpiderRecrawlMinInterval() const;
+	int getSpiderRecrawlMaxInterval() const;
+	int getSpiderRecrawlInitialInterval() const;
+	int getSpiderRecrawlBudget() const;
 
 	// Получение параметров поисковика
 	int getSearcherPort() const;
+	int getSearcherCandidateLimit() const;
+
+	// Получение параметров индексации
+	const std::vector<std::string>& getIndexStemmers() const;
+	const std::vector<std::string>& getIndexStopWords() const;
+	const std::string& getIndexStopWordsFile() const;
+
+	// Получение параметров нагрузочного стенда
+	int getBenchPages() const;
+	int getBenchFanout() const;
+	int getBenchPageSize() const;
+	int getBenchLatencyMs() const;
+	double getBenchErrorRate() const;
+	int getBenchHosts() const;
+	int getBenchPort() const;
+	int getBenchServerThreads() const;
+	int getBenchTimeLimit() const;
+
+	// Переопределение параметров паука (нагрузочный стенд обходит свой сайт)
+	void setSpiderStartUrl(const std::string& url);
+	void setSpiderMaxDepth(int depth);
+	void setSpiderStateDir(const std::string& dir);
+	void setSpiderShardIndex(int index);
 };
 
 
@@ -0,0 +1,117 @@
+#include "CrawlBenchmark.h"
+#include "SyntheticSite.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <algorithm>
+
+CrawlBenchmark::CrawlBenchmark(Config& config, Database& db)
+    : config_(config)
+    , database_(db)
+{
+}
+
+CrawlBenchmark::Report CrawlBenchmark::run()
+{
+    // Уникальный префикс путей: страницы прошлых запусков уже есть в БД
+    // и были бы пропущены пауком
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    SyntheticSite::Options options;
+    options.pages = config_.getBenchPages();
+    options.fanout = config_.getBenchFanout();
+    options.pageSize = config_.getBenchPageSize();
+    options.latencyMs = config_.getBenchLatencyMs();
+    options.errorRate = config_.getBenchErrorRate();
+    options.hosts = config_.getBenchHosts();
+    options.port = config_.getBenchPort();
+    options.threads = config_.getBenchServerThreads();
+    options.runId = "run" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+
+    SyntheticSite site(options);
+    site.start();
+
+    // Паук обходит только синтетический сайт, без восстановления прошлого состояния
+    config_.setSpiderStartUrl(site.getStartUrl());
+    config_.setSpiderMaxDepth(std::max(config_.getSpiderMaxDepth(), site.requiredDepth()));
+    config_.setSpiderStateDir("");
+
+    Report report;
+    report.sitePages = options.pages;
+
+    Spider spider(config_, database_);
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto deadline = startTime + std::chrono::seconds(config_.getBenchTimeLimit());
+    spider.start();
+
+    // Паук сообщает о завершении сам - время замера не включает опрос
+    report.completed = spider.getCompletion().wait_until(deadline) == std::future_status::ready;
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    spider.stop();
+    Spider::SpiderStats stats = spider.getStats();
+    site.stop();
+
+    report.requestsServed = site.getRequestsServed();
+    report.errorsServed = site.getErrorsServed();
+    report.pagesDownloaded = stats.totalDownloaded;
+    report.pagesIndexed = stats.totalIndexed;
+    report.wireBytes = stats.wireBytes;
+    report.decodedBytes = stats.decodedBytes;
+    report.stages = stats.stages;
+
+    for (const auto& stage : stats.stages)
+    {
+        if (stage.name == "store")
+        {
+            report.documentsStored = stage.processed;
+        }
+    }
+
+    if (report.seconds > 0.0)
+    {
+        report.pagesPerSecond = report.pagesDownloaded / report.seconds;
+        report.bytesPerSecond = report.wireBytes / report.seconds;
+        report.dbWritesPerSecond = report.documentsStored / report.seconds;
+    }
+
+    return report;
+}
+
+void CrawlBenchmark::printReport(const Report& report)
+{
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "⏱️  Результаты замера" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "   Обход: " << (report.completed ? "завершён" : "остановлен по времени")
+        << " за " << report.seconds << " с" << std::endl;
+    std::cout << "   Страниц на сайте: " << report.sitePages
+        << ", запросов: " << report.requestsServed
+        << " (ошибок: " << report.errorsServed << ")" << std::endl;
+    std::cout << "   Загружено: " << report.pagesDownloaded
+        << ", проиндексировано: " << report.pagesIndexed
+        << ", сохранено: " << report.documentsStored << std::endl;
+    std::cout << "   Страниц/с: " << report.pagesPerSecond << std::endl;
+    std::cout << "   Трафик: " << report.bytesPerSecond / 1024 << " КБ/с по сети, "
+        << report.decodedBytes / 1024 << " КБ HTML всего" << std::endl;
+    std::cout << "   Запись в БД: " << report.dbWritesPerSecond << " документов/с" << std::endl;
+
+    std::cout << "\n   Время обработки по стадиям (мс):" << std::endl;
+    // Заголовок выровнен вручную: setw считает байты, а не символы UTF-8
+    std::cout << "   стадия         p50       p90       p99   среднее  обработано" << std::endl;
+    std::cout << std::setprecision(2);
+    for (const auto& stage : report.stages)
+    {
+        std::cout << "   " << std::left << std::setw(8) << stage.name << std::right
+            << std::setw(10) << stage.p50Millis
+            << std::setw(10) << stage.p90Millis
+            << std::setw(10) << stage.p99Millis
+            << std::setw(10) << stage.avgMillis
+            << std::setw(12) << stage.processed << std::endl;
+    }
+    std::cout << std::defaultfloat;
+    std::cout << "========================================" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef CRAWLBENCHMARK_H
+#define CRAWLBENCHMARK_H
+
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "Database.h"
+#include "Spider.h"
+
+// Нагрузочный замер паука: запускает SyntheticSite, обходит его пауком
+// с текущими настройками и собирает показатели производительности.
+// Каждое изменение паука, влияющее на скорость, стоит проверять этим замером
+class CrawlBenchmark
+{
+public:
+    struct Report
+    {
+        bool completed = false;       // сайт обойдён полностью (не по таймауту)
+        double seconds = 0.0;
+        int sitePages = 0;
+        long long requestsServed = 0; // запросов к синтетическому сайту
+        long long errorsServed = 0;   // из них с ошибкой
+        int pagesDownloaded = 0;
+        int pagesIndexed = 0;
+        long long documentsStored = 0;
+        long long wireBytes = 0;
+        long long decodedBytes = 0;
+        double pagesPerSecond = 0.0;
+        double bytesPerSecond = 0.0;
+        double dbWritesPerSecond = 0.0;
+        std::vector<Spider::StageStats> stages;
+    };
+
+    CrawlBenchmark(Config& config, Database& db);
+
+    // Полный прогон: сайт, обход, отчёт
+    Report run();
+
+    static void printReport(const Report& report);
+
+private:
+    Config& config_;
+    Database& database_;
+};
+
+#endif // CRAWLBENCHMARK_H
\ No newline at end of file
@@ -0,0 +1,370 @@
+#include "CrawlFrontier.h"
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <iostream>
+#include <algorithm>
+#include <unordered_set>
+#include <cstdlib>
+#include <charconv>
+
+namespace fs = std::filesystem;
+
+CrawlFrontier::CrawlFrontier(const std::string& directory, size_t memoryLimit)
+    : directory_(directory)
+    , memoryLimit_(std::max<size_t>(memoryLimit, 2))
+    , diskTasks_(0)
+    , nextSegmentId_(0)
+{
+    if (isPersistent())
+    {
+        std::error_code ec;
+        fs::create_directories(directory_, ec);
+        if (ec)
+        {
+            throw std::runtime_error("Не удалось создать каталог состояния " + directory_ + ": " + ec.message());
+        }
+    }
+}
+
+bool CrawlFrontier::isPersistent() const
+{
+    return !directory_.empty();
+}
+
+std::string CrawlFrontier::statePath(const std::string& fileName) const
+{
+    return (fs::path(directory_) / fileName).string();
+}
+
+std::string CrawlFrontier::segmentPath(uint64_t id) const
+{
+    return statePath("segment_" + std::to_string(id) + ".log");
+}
+
+// Строка задачи: "глубина\tURL" или "глубина,повтор\tURL" - номер
+// повтора переживает выгрузку на диск, иначе недоступный URL
+// повторялся бы бесконечно
+void CrawlFrontier::writeTask(std::ostream& out, char kind, const Task& task)
+{
+    if (kind != 0)
+    {
+        out << kind << '\t';
+    }
+    out << task.depth;
+    if (task.attempt > 0)
+    {
+        out << ',' << task.attempt;
+    }
+    out << '\t' << task.url << '\n';
+}
+
+bool CrawlFrontier::parseTask(const std::string& line, Task& task)
+{
+    size_t tabPos = line.find('\t');
+    if (tabPos == std::string::npos || tabPos + 1 >= line.size())
+    {
+        return false;
+    }
+
+    const char* end = line.data() + tabPos;
+    auto [ptr, ec] = std::from_chars(line.data(), end, task.depth);
+    if (ec != std::errc())
+    {
+        return false;
+    }
+
+    task.attempt = 0;
+    if (ptr != end)
+    {
+        if (*ptr != ',')
+        {
+            return false;
+        }
+        auto [attemptPtr, attemptEc] = std::from_chars(ptr + 1, end, task.attempt);
+        if (attemptEc != std::errc() || attemptPtr != end)
+        {
+            return false;
+        }
+    }
+
+    task.url = line.substr(tabPos + 1);
+    return true;
+}
+
+void CrawlFrontier::push(const Task& task)
+{
+    // Перевод строки сломал бы формат сегментов
+    if (task.url.find('\n') != std::string::npos)
+    {
+        return;
+    }
+
+    tail_.push_back(task);
+
+    if (isPersistent() && tail_.size() >= memoryLimit_ / 2)
+    {
+        spillTail();
+    }
+}
+
+bool CrawlFrontier::pop(Task& task)
+{
+    if (head_.empty())
+    {
+        if (!segments_.empty())
+        {
+            loadSegment();
+        }
+        else
+        {
+            head_.swap(tail_);
+        }
+    }
+
+    if (head_.empty())
+    {
+        return false;
+    }
+
+    task = std::move(head_.front());
+    head_.pop_front();
+    return true;
+}
+
+bool CrawlFrontier::empty() const
+{
+    return head_.empty() && tail_.empty() && segments_.empty();
+}
+
+size_t CrawlFrontier::size() const
+{
+    return head_.size() + diskTasks_ + tail_.size();
+}
+
+void CrawlFrontier::spillTail()
+{
+    // Если на диске ничего нет и голова пуста, выгружать незачем
+    if (segments_.empty() && head_.empty())
+    {
+        head_.swap(tail_);
+        return;
+    }
+
+    uint64_t id = nextSegmentId_++;
+    std::ofstream out(segmentPath(id), std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw std::runtime_error("Не удалось создать сегмент очереди: " + segmentPath(id));
+    }
+
+    for (const auto& task : tail_)
+    {
+        writeTask(out, 0, task);
+    }
+
+    out.flush();
+    if (!out)
+    {
+        throw std::runtime_error("Ошибка записи сегмента очереди: " + segmentPath(id));
+    }
+
+    segments_.emplace_back(id, tail_.size());
+    diskTasks_ += tail_.size();
+    tail_.clear();
+}
+
+void CrawlFrontier::loadSegment()
+{
+    auto [id, count] = segments_.front();
+    segments_.pop_front();
+    diskTasks_ -= count;
+
+    std::ifstream in(segmentPath(id), std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "⚠️  Сегмент очереди не найден: " << segmentPath(id) << std::endl;
+        return;
+    }
+
+    std::string line;
+    Task task;
+    while (std::getline(in, line))
+    {
+        if (parseTask(line, task))
+        {
+            head_.push_back(std::move(task));
+        }
+    }
+
+    consumedSegments_.push_back(id);
+}
+
+CrawlFrontier::Snapshot CrawlFrontier::snapshot(const std::vector<Task>& inFlight)
+{
+    Snapshot result;
+    if (!isPersistent())
+    {
+        return result;
+    }
+
+    result.nextSegmentId = nextSegmentId_;
+    result.head.reserve(inFlight.size() + head_.size());
+    result.head.insert(result.head.end(), inFlight.begin(), inFlight.end());
+    result.head.insert(result.head.end(), head_.begin(), head_.end());
+    result.segments.assign(segments_.begin(), segments_.end());
+    result.tail.assign(tail_.begin(), tail_.end());
+
+    // Сегменты, загруженные позже снимка, остаются в манифесте
+    // и удаляются только следующей контрольной точкой
+    result.consumedSegments.swap(consumedSegments_);
+    return result;
+}
+
+void CrawlFrontier::writeCheckpoint(const Snapshot& snapshot) const
+{
+    if (!isPersistent())
+    {
+        return;
+    }
+
+    // Пишем во временный файл и атомарно подменяем манифест
+    std::string manifestPath = statePath("frontier.manifest");
+    std::string tmpPath = manifestPath + ".tmp";
+
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Не удалось создать манифест очереди: " + tmpPath);
+        }
+
+        out << "next\t" << snapshot.nextSegmentId << '\n';
+
+        for (const auto& task : snapshot.head)
+        {
+            writeTask(out, 'H', task);
+        }
+        for (const auto& [id, count] : snapshot.segments)
+        {
+            out << "S\t" << id << '\t' << count << '\n';
+        }
+        for (const auto& task : snapshot.tail)
+        {
+            writeTask(out, 'T', task);
+        }
+
+        out.flush();
+        if (!out)
+        {
+            throw std::runtime_error("Ошибка записи манифеста очереди: " + tmpPath);
+        }
+    }
+
+    fs::rename(tmpPath, manifestPath);
+
+    // Теперь загруженные сегменты больше не нужны. Если запись не удалась,
+    // они остаются на диске и удаляются при восстановлении
+    for (uint64_t id : snapshot.consumedSegments)
+    {
+        std::error_code ec;
+        fs::remove(segmentPath(id), ec);
+    }
+}
+
+bool CrawlFrontier::restore()
+{
+    if (!isPersistent())
+    {
+        return false;
+    }
+
+    std::ifstream in(statePath("frontier.manifest"), std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    head_.clear();
+    tail_.clear();
+    segments_.clear();
+    consumedSegments_.clear();
+    diskTasks_ = 0;
+    nextSegmentId_ = 0;
+
+    std::string line;
+    Task task;
+    while (std::getline(in, line))
+    {
+        if (line.size() < 2 || line[1] != '\t')
+        {
+            if (line.rfind("next\t", 0) == 0)
+            {
+                nextSegmentId_ = std::stoull(line.substr(5));
+            }
+            continue;
+        }
+
+        std::string payload = line.substr(2);
+        switch (line[0])
+        {
+        case 'H':
+            if (parseTask(payload, task))
+            {
+                head_.push_back(std::move(task));
+            }
+            break;
+        case 'T':
+            if (parseTask(payload, task))
+            {
+                tail_.push_back(std::move(task));
+            }
+            break;
+        case 'S':
+        {
+            size_t tabPos = payload.find('\t');
+            if (tabPos == std::string::npos)
+            {
+                break;
+            }
+            uint64_t id = std::stoull(payload.substr(0, tabPos));
+            size_t count = std::stoull(payload.substr(tabPos + 1));
+            if (fs::exists(segmentPath(id)))
+            {
+                segments_.emplace_back(id, count);
+                diskTasks_ += count;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // Удаляем сегменты, записанные после контрольной точки:
+    // манифест о них не знает
+    std::unordered_set<uint64_t> known;
+    for (const auto& [id, count] : segments_)
+    {
+        known.insert(id);
+    }
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory_, ec))
+    {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("segment_", 0) != 0)
+        {
+            continue;
+        }
+
+        uint64_t id = std::strtoull(name.c_str() + 8, nullptr, 10);
+        if (known.find(id) == known.end())
+        {
+            std::error_code removeEc;
+            fs::remove(entry.path(), removeEc);
+        }
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef CRAWLFRONTIER_H
+#define CRAWLFRONTIER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+// Очередь обхода (frontier) с выгрузкой на диск.
+// В памяти держатся только голова (откуда берутся задачи) и хвост
+// (куда добавляются новые). Когда хвост превышает половину бюджета,
+// он целиком дописывается на диск отдельным сегментом. Порядок FIFO
+// сохраняется: голова -> сегменты на диске -> хвост.
+//
+// Класс не потокобезопасен, синхронизацию обеспечивает владелец.
+class CrawlFrontier
+{
+public:
+    // Задача обхода
+    struct Task
+    {
+        std::string url;
+        int depth;
+        int attempt = 0;  // номер повтора после сбоя
+    };
+
+    // directory - каталог для сегментов и контрольных точек
+    // (пустая строка - очередь живёт только в памяти)
+    // memoryLimit - сколько задач держать в памяти
+    CrawlFrontier(const std::string& directory, size_t memoryLimit);
+
+    // Добавление задачи в конец очереди
+    void push(const Task& task);
+
+    // Извлечение задачи из начала очереди (false, если очередь пуста)
+    bool pop(Task& task);
+
+    bool empty() const;
+
+    // Общее количество задач (в памяти и на диске)
+    size_t size() const;
+
+    // Работает ли очередь с диском
+    bool isPersistent() const;
+
+    // Снимок очереди для контрольной точки. Задачи inFlight (взятые
+    // в работу, но не завершённые) ставятся в начало очереди, чтобы после
+    // перезапуска они были обработаны повторно
+    struct Snapshot
+    {
+        uint64_t nextSegmentId = 0;
+        std::vector<Task> head;
+        std::vector<std::pair<uint64_t, size_t>> segments;
+        std::vector<Task> tail;
+
+        // Сегменты, которые можно удалить после записи манифеста
+        std::vector<uint64_t> consumedSegments;
+    };
+
+    // Снимок делается под блокировкой владельца и стоит одного копирования
+    // задач из памяти; медленная запись на диск - в writeCheckpoint
+    Snapshot snapshot(const std::vector<Task>& inFlight);
+
+    // Запись снимка на диск. Не трогает состояние очереди, поэтому
+    // может выполняться без блокировки, параллельно с push/pop
+    void writeCheckpoint(const Snapshot& snapshot) const;
+
+    // Восстановление из последней контрольной точки.
+    // Возвращает false, если контрольной точки нет
+    bool restore();
+
+    // Путь к файлу в каталоге состояния
+    std::string statePath(const std::string& fileName) const;
+
+private:
+    std::string directory_;
+    size_t memoryLimit_;
+
+    std::deque<Task> head_;
+    std::deque<Task> tail_;
+
+    // Сегменты на диске (по порядку) и количество задач в каждом
+    std::deque<std::pair<uint64_t, size_t>> segments_;
+    size_t diskTasks_;
+    uint64_t nextSegmentId_;
+
+    // Сегменты, уже загруженные в память. Удаляются с диска только
+    // после следующей контрольной точки, иначе при падении их задачи
+    // были бы потеряны
+    std::vector<uint64_t> consumedSegments_;
+
+    std::string segmentPath(uint64_t id) const;
+
+    // Запись хвоста на диск новым сегментом
+    void spillTail();
+
+    // Загрузка самого старого сегмента в голову
+    void loadSegment();
+
+    static void writeTask(std::ostream& out, char kind, const Task& task);
+    static bool parseTask(const std::string& line, Task& task);
+};
+
+#endif // CRAWLFRONTIER_H
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "Database.h"
+#include "SnippetBuilder.h"
 #include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
 
 Database::Database(const Config& config) :
     connectionString_(
@@ -17,6 +20,15 @@ Database::Database(const Config& config) :
         {
             std::cout << "✔ Подключение к БД установлено" << std::endl;
             std::cout << "Название БД: " << testConn.dbname() << std::endl;
+
+            // Смещения слов для сниппетов считаются в символах UTF-8,
+            // а substring считает символы в кодировке сервера
+            pqxx::work check(testConn);
+            std::string encoding = check.exec("SHOW server_encoding")[0][0].as<std::string>();
+            if (encoding != "UTF8")
+            {
+                throw std::runtime_error("Кодировка БД " + encoding + ", требуется UTF8");
+            }
         }
         else
         {
@@ -69,10 +81,14 @@ void Database::creatingTables()
             "url TEXT UNIQUE NOT NULL,"
             "title TEXT,"
             "content TEXT,"
+            "word_offsets BYTEA,"
             "created_at TIMESTAMP DEFAULT NOW()"
             ");"
         );
 
+        // Смещения слов для сниппетов в базах, созданных до их появления
+        db.exec("ALTER TABLE documents ADD COLUMN IF NOT EXISTS word_offsets BYTEA;");
+
         // Создание таблицы слов
         db.exec(
             "CREATE TABLE IF NOT EXISTS words("
@@ -87,10 +103,14 @@ void Database::creatingTables()
             "document_id INTEGER NOT NULL REFERENCES documents(id) ON DELETE CASCADE,"
             "word_id INTEGER NOT NULL REFERENCES words(id) ON DELETE CASCADE,"
             "frequency INTEGER NOT NULL CHECK (frequency > 0),"
+            "positions BYTEA,"
             "PRIMARY KEY (document_id, word_id)"
             ");"
         );
 
+        // Позиции слов (PositionList) в базах, созданных до их появления
+        db.exec("ALTER TABLE document_words ADD COLUMN IF NOT EXISTS positions BYTEA;");
+
         db.commit();
         std::cout << "✔ Таблицы созданы успешно" << std::endl;
     }
@@ -104,7 +124,84 @@ void Database::creatingTables()
     }
 }
 
-int Database::savingDocument(const std::string& url, const std::string& title, const std::string& content)
+int Database::insertDocument(pqxx::work& db, const std::string& url, const std::string& title,
+    const std::string& content, const std::string& wordOffsets)
+{
+    std::basic_string_view<std::byte> offsetBytes(
+        reinterpret_cast<const std::byte*>(wordOffsets.data()), wordOffsets.size());
+
+    // Добавляем или обновляем документ
+    pqxx::result result = db.exec(
+        "INSERT INTO documents (url, title, content, word_offsets) "
+        "VALUES ($1, $2, $3, $4) "
+        "ON CONFLICT (url) DO UPDATE "
+        "SET title = $2, content = $3, word_offsets = $4 "
+        "RETURNING id",
+        pqxx::params{ url, title, content, offsetBytes });
+    return result[0][0].as<int>();
+}
+
+void Database::insertWords(pqxx::work& db, int documentId, const TermList& wordsAndFrequency,
+    std::unordered_map<std::string, int>* wordIds)
+{
+    // Слова прошлой версии документа (при повторном визите) заменяются целиком
+    db.exec(
+        "DELETE FROM document_words WHERE document_id = $1",
+        pqxx::params{ documentId });
+
+    // Проходимся по всем словам
+    for (size_t i = 0; i < wordsAndFrequency.size(); ++i)
+    {
+        auto [wordText, frequency] = wordsAndFrequency[i];
+        std::string_view positions = wordsAndFrequency.getPositions(i);
+        std::basic_string_view<std::byte> positionBytes(
+            reinterpret_cast<const std::byte*>(positions.data()), positions.size());
+
+        // ID слова: из уже найденных в пакете, иначе из таблицы words
+        int wordId = 0;
+        if (wordIds)
+        {
+            auto known = wordIds->find(std::string(wordText));
+            if (known != wordIds->end())
+            {
+                wordId = known->second;
+            }
+        }
+        if (wordId == 0)
+        {
+            // Ищем слово в таблице words
+            pqxx::result wordResult = db.exec(
+                "SELECT id FROM words WHERE word = $1",
+                pqxx::params{ wordText });
+
+            // Если слово не найдено - добавляем
+            if (wordResult.empty())
+            {
+                // Добавляем новое слово и получаем его ID
+                wordResult = db.exec(
+                    "INSERT INTO words (word) VALUES ($1) RETURNING id",
+                    pqxx::params{ wordText });
+            }
+            wordId = wordResult[0][0].as<int>();
+
+            if (wordIds)
+            {
+                wordIds->emplace(std::string(wordText), wordId);
+            }
+        }
+
+        // Добавляем или обновляем связь в document_words
+        db.exec(
+            "INSERT INTO document_words (document_id, word_id, frequency, positions) "
+            "VALUES ($1, $2, $3, $4) "
+            "ON CONFLICT (document_id, word_id) "
+            "DO UPDATE SET frequency = $3, positions = $4",
+            pqxx::params{ documentId, wordId, frequency, positionBytes });
+    }
+}
+
+int Database::savingDocument(const std::string& url, const std::string& title, const std::string& content,
+    const std::string& wordOffsets)
 {
     // Захватываем мьютекс
     std::unique_lock<std::shared_mutex> lock(databaseMutex_);
@@ -115,18 +212,9 @@ int Database::savingDocument(const std::string& url, const std::string& title, c
         pqxx::connection conn(connectionString_);
         pqxx::work db(conn);
 
-        // Добавляем или обновляем документ
-        pqxx::result result = db.exec(
-            "INSERT INTO documents (url, title, content) "
-            "VALUES ($1, $2, $3) "
-            "ON CONFLICT (url) DO UPDATE "
-            "SET title = $2, content = $3 "
-            "RETURNING id",
-            pqxx::params{ url, title, content });
-
+        int documentId = insertDocument(db, url, title, content, wordOffsets);
         db.commit();
 
-        int documentId = result[0][0].as<int>();
         std::cout << "✔ Документ сохранён, ID: " << documentId << std::endl;
         return documentId;
     }
@@ -140,7 +228,7 @@ int Database::savingDocument(const std::string& url, const std::string& title, c
     }
 }
 
-void Database::savingWords(int documentId, const std::vector<std::pair<std::string, int>>& wordsAndFrequency)
+void Database::savingWords(int documentId, const TermList& wordsAndFrequency)
 {
     // Захватываем мьютекс
     std::unique_lock<std::shared_mutex> lock(databaseMutex_);
@@ -151,50 +239,54 @@ void Database::savingWords(int documentId, const std::vector<std::pair<std::stri
         pqxx::connection conn(connectionString_);
         pqxx::work db(conn);
 
-        // Проходимся по всем парам слов и значений
-        for (const auto& [wordText, frequency] : wordsAndFrequency)
-        {
-            // Ищем слово в таблице words
-            pqxx::result wordResult = db.exec(
-                "SELECT id FROM words WHERE word = $1",
-                pqxx::params{ wordText });
+        insertWords(db, documentId, wordsAndFrequency, nullptr);
 
-            int wordId;
+        db.commit();
+        std::cout << "✔ Слова сохранены для документа ID: " << documentId << std::endl;
+    }
+    catch (const pqxx::sql_error& e)
+    {
+        throw std::runtime_error("SQL ошибка при сохранении слов: " + std::string(e.what()));
+    }
+    catch (const std::exception& e)
+    {
+        throw std::runtime_error("Системная ошибка при сохранении слов: " + std::string(e.what()));
+    }
+}
 
-            // Если слово не найдено - добавляем
-            if (wordResult.empty())
-            {
-                // Добавляем новое слово и получаем его ID
-                wordResult = db.exec(
-                    "INSERT INTO words (word) VALUES ($1) RETURNING id",
-                    pqxx::params{ wordText });
-                wordId = wordResult[0][0].as<int>();
-            }
-            else
-            {
-                // Слово уже есть - берём существующий ID
-                wordId = wordResult[0][0].as<int>();
-            }
+void Database::savingDocuments(std::span<const DocumentData> documents)
+{
+    if (documents.empty())
+    {
+        return;
+    }
 
-            // Добавляем или обновляем связь в document_words
-            db.exec(
-                "INSERT INTO document_words (document_id, word_id, frequency) "
-                "VALUES ($1, $2, $3) "
-                "ON CONFLICT (document_id, word_id) "
-                "DO UPDATE SET frequency = $3",
-                pqxx::params{ documentId, wordId, frequency });
+    // Захватываем мьютекс
+    std::unique_lock<std::shared_mutex> lock(databaseMutex_);
+
+    try
+    {
+        // Одно соединение и одна транзакция на пакет. Слова страниц пакета
+        // во многом совпадают - их ID ищутся в БД один раз
+        pqxx::connection conn(connectionString_);
+        pqxx::work db(conn);
+        std::unordered_map<std::string, int> wordIds;
+
+        for (const auto& document : documents)
+        {
+            int documentId = insertDocument(db, document.url, document.title, document.content, document.wordOffsets);
+            insertWords(db, documentId, document.words, &wordIds);
         }
 
         db.commit();
-        std::cout << "✔ Слова сохранены для документа ID: " << documentId << std::endl;
     }
     catch (const pqxx::sql_error& e)
     {
-        throw std::runtime_error("SQL ошибка при сохранении слов: " + std::string(e.what()));
+        throw std::runtime_error("SQL ошибка при сохранении документов: " + std::string(e.what()));
     }
     catch (const std::exception& e)
     {
-        throw std::runtime_error("Системная ошибка при сохранении слов: " + std::string(e.what()));
+        throw std::runtime_error("Системная ошибка при сохранении документов: " + std::string(e.what()));
     }
 }
 
@@ -281,16 +373,15 @@ int Database::getWordId(const std::string& word)
     }
 }
 
-std::vector<Database::SearchResult> Database::searchDocuments(const std::vector<std::string>& words, int limit)
+void Database::searchCandidates(const std::vector<std::string>& words, int pageSize,
+    const std::function<bool(std::vector<Candidate>&)>& accept)
 {
     // Захватываем мьютекс для чтения
     std::shared_lock<std::shared_mutex> lock(databaseMutex_);
 
-    std::vector<SearchResult> results;
-
     if (words.empty())
     {
-        return results;
+        return;
     }
 
     try
@@ -299,39 +390,80 @@ std::vector<Database::SearchResult> Database::searchDocuments(const std::vector<
         pqxx::connection conn(connectionString_);
         pqxx::work db(conn);
 
-        // Создаём временную таблицу с искомыми словами
+        // Искомые слова с их номерами в запросе
         std::string tempTableSql = "WITH search_words AS (";
         for (size_t i = 0; i < words.size(); ++i)
         {
             if (i > 0) tempTableSql += " UNION ALL ";
-            tempTableSql += "SELECT '" + conn.esc(words[i]) + "'::text AS word";
+            tempTableSql += "SELECT '" + conn.esc(words[i]) + "'::text AS word, " + std::to_string(i) + " AS idx";
         }
         tempTableSql += ") ";
 
-        // Основной запрос поиска
-        std::string query = tempTableSql +
-            "SELECT d.url, d.title, SUM(dw.frequency) as relevance "
-            "FROM documents d "
-            "JOIN document_words dw ON d.id = dw.document_id "
+        // Пересечение по частотам считается один раз, курсор отдаёт его
+        // страницами. Позиции слов читаются только для выданных страниц
+        db.exec(
+            "DECLARE candidates NO SCROLL CURSOR FOR " + tempTableSql +
+            "SELECT dw.document_id, SUM(dw.frequency) AS relevance "
+            "FROM document_words dw "
             "JOIN words w ON dw.word_id = w.id "
             "JOIN search_words sw ON w.word = sw.word "
-            "GROUP BY d.id, d.url, d.title "
+            "GROUP BY dw.document_id "
             "HAVING COUNT(DISTINCT w.word) = " + std::to_string(words.size()) + " "
-            "ORDER BY relevance DESC "
-            "LIMIT " + std::to_string(limit);
-
-        pqxx::result dbResult = db.exec(query);
+            "ORDER BY relevance DESC, dw.document_id");
 
-        for (const auto& row : dbResult)
+        pageSize = std::max(pageSize, 1);
+        while (true)
         {
-            SearchResult result;
-            result.url = row["url"].as<std::string>();
-            result.title = row["title"].as<std::string>();
-            result.relevance = row["relevance"].as<int>();
-            results.push_back(result);
-        }
+            pqxx::result page = db.exec("FETCH " + std::to_string(pageSize) + " FROM candidates");
+            if (page.empty())
+            {
+                break;
+            }
+
+            std::vector<Candidate> candidates(page.size());
+            std::unordered_map<int, size_t> indexById;
+            std::string ids;
+            for (size_t i = 0; i < page.size(); ++i)
+            {
+                candidates[i].documentId = page[i]["document_id"].as<int>();
+                candidates[i].relevance = page[i]["relevance"].as<int>();
+                candidates[i].positions.resize(words.size());
+                indexById[candidates[i].documentId] = i;
 
-        return results;
+                if (i > 0) ids += ',';
+                ids += std::to_string(candidates[i].documentId);
+            }
+
+            pqxx::result dbResult = db.exec(tempTableSql +
+                "SELECT d.id, d.url, d.title, sw.idx, dw.positions "
+                "FROM documents d "
+                "JOIN document_words dw ON dw.document_id = d.id "
+                "JOIN words w ON dw.word_id = w.id "
+                "JOIN search_words sw ON w.word = sw.word "
+                "WHERE d.id IN (" + ids + ")");
+
+            for (const auto& row : dbResult)
+            {
+                Candidate& candidate = candidates[indexById.at(row["id"].as<int>())];
+                candidate.url = row["url"].as<std::string>();
+                candidate.title = row["title"].as<std::string>();
+
+                // NULL - документ проиндексирован до появления позиций
+                if (!row["positions"].is_null())
+                {
+                    auto bytes = row["positions"].as<std::basic_string<std::byte>>();
+                    size_t index = row["idx"].as<size_t>();
+                    candidate.positions[index].assign(
+                        reinterpret_cast<const char*>(bytes.data()), bytes.size());
+                }
+            }
+
+            bool lastPage = page.size() < static_cast<size_t>(pageSize);
+            if (!accept(candidates) || lastPage)
+            {
+                break;
+            }
+        }
     }
     catch (const pqxx::sql_error& e)
     {
@@ -343,6 +475,93 @@ std::vector<Database::SearchResult> Database::searchDocuments(const std::vector<
     }
 }
 
+void Database::loadSnippets(std::vector<SearchResult>& results)
+{
+    // Захватываем мьютекс для чтения
+    std::shared_lock<std::shared_mutex> lock(databaseMutex_);
+
+    if (results.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        // Создаём отдельное соединение
+        pqxx::connection conn(connectionString_);
+        pqxx::work db(conn);
+
+        // Смещения слов - несколько сотен байт на документ
+        std::string ids;
+        for (const auto& result : results)
+        {
+            if (!ids.empty()) ids += ", ";
+            ids += std::to_string(result.documentId);
+        }
+        pqxx::result offsetRows = db.exec(
+            "SELECT id, word_offsets FROM documents "
+            "WHERE id IN (" + ids + ") AND word_offsets IS NOT NULL");
+
+        // Диапазоны символов вокруг окон. Без смещений (документ
+        // проиндексирован раньше) сниппета нет - весь текст не читается
+        std::string ranges;
+        for (const auto& row : offsetRows)
+        {
+            int documentId = row["id"].as<int>();
+            auto bytes = row["word_offsets"].as<std::basic_string<std::byte>>();
+            std::string_view offsets(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                SnippetBuilder::Range range;
+                if (results[i].documentId != documentId ||
+                    !SnippetBuilder::findRange(offsets, results[i].snippet.start, range))
+                {
+                    continue;
+                }
+
+                results[i].snippet.firstWord = range.firstWord;
+                results[i].snippet.truncated = range.truncated;
+                if (!ranges.empty()) ranges += ", ";
+                ranges += "(" + std::to_string(i) + ", " + std::to_string(documentId) + ", " +
+                    std::to_string(range.from + 1) + ", " + std::to_string(range.length) + ")";
+            }
+        }
+
+        if (ranges.empty())
+        {
+            return;
+        }
+
+        // Длина известна всегда (последнее смещение - конец текста), поэтому
+        // substring читает значение не целиком: внешний (TOAST) текст - только
+        // нужные куски, сжатый - распаковывается префикс. В многобайтовой
+        // кодировке префикс берётся с запасом: до (start + len) * 4 байт,
+        // то есть стоимость растёт с позицией окна, но не с размером текста
+        pqxx::result textRows = db.exec(
+            "SELECT r.idx, substring(d.content FROM r.start FOR r.len) AS text "
+            "FROM (VALUES " + ranges + ") AS r(idx, id, start, len) "
+            "JOIN documents d ON d.id = r.id");
+
+        for (const auto& row : textRows)
+        {
+            size_t index = row["idx"].as<size_t>();
+            if (index < results.size() && !row["text"].is_null())
+            {
+                results[index].snippet.text = row["text"].as<std::string>();
+            }
+        }
+    }
+    catch (const pqxx::sql_error& e)
+    {
+        throw std::runtime_error("SQL ошибка при загрузке сниппетов: " + std::string(e.what()));
+    }
+    catch (const std::exception& e)
+    {
+        throw std::runtime_error("Системная ошибка при загрузке сниппетов: " + std::string(e.what()));
+    }
+}
+
 std::vector<std::tuple<int, std::string, std::string>> Database::getAllDocuments()
 {
     // Захватываем мьютекс для чтения
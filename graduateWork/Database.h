@@ -4,9 +4,14 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
 #include <pqxx/pqxx>
 #include <shared_mutex>
+#include <functional>
+#include <span>
+#include <unordered_map>
 #include "Config.h"
+#include "TermList.h"
 
 class Database
 {
@@ -21,11 +26,27 @@ public:
     // Создание таблиц
     void creatingTables();
 
-    // Сохранение документа (возвращает ID)
-    int savingDocument(const std::string& url, const std::string& title, const std::string& content);
+    // Сохранение документа (возвращает ID). wordOffsets - смещения слов
+    // content для сниппетов (SnippetBuilder::encodeWordOffsets)
+    int savingDocument(const std::string& url, const std::string& title, const std::string& content,
+        const std::string& wordOffsets);
 
-    // Сохранение слов и их частоты
-    void savingWords(int documentId, const std::vector<std::pair<std::string, int>>& wordsAndFrequency);
+    // Сохранение слов, их частоты и позиций
+    void savingWords(int documentId, const TermList& wordsAndFrequency);
+
+    // Документ со словами для пакетного сохранения
+    struct DocumentData
+    {
+        std::string url;
+        std::string title;
+        std::string content;
+        std::string wordOffsets;
+        TermList words;
+    };
+
+    // Сохранение пакета документов со словами на одном соединении в одной
+    // транзакции: ошибка откатывает весь пакет
+    void savingDocuments(std::span<const DocumentData> documents);
 
     // Проверка существует ли URL
     bool urlExists(const std::string& url);
@@ -36,15 +57,48 @@ public:
     // Получить ID слова
     int getWordId(const std::string& word);
 
-    // Поиск документов по словам
+    // Фрагмент текста документа для выдачи
+    struct Snippet
+    {
+        uint32_t start = 0;                // первое слово окна
+        std::vector<uint32_t> highlights;  // позиции слов запроса в окне
+        uint32_t firstWord = 0;            // номер первого слова text
+        std::string text;                  // слова через пробел, пусто - не загружен
+        bool truncated = false;            // за text в документе есть ещё слова
+    };
+
+    // Документ в выдаче поиска
     struct SearchResult
     {
         std::string url;
         std::string title;
         int relevance;
+        int window = 0;   // наименьшее окно со всеми словами запроса (в словах), 0 - не считалось
+        int documentId = 0;
+        Snippet snippet;
     };
 
-    std::vector<SearchResult> searchDocuments(const std::vector<std::string>& words, int limit = 10);
+
+    // Документ со всеми словами запроса и позициями этих слов в нём
+    struct Candidate
+    {
+        int documentId;
+        std::string url;
+        std::string title;
+        int relevance;
+        std::vector<std::string> positions;   // по порядку words, в формате PositionList; пусто - не записаны
+    };
+
+    // Пересечение списков документов слов запроса с позициями, страницами
+    // по pageSize документов по убыванию суммы частот. accept получает
+    // каждую страницу и возвращает true, чтобы получить следующую. Фразы и
+    // близость слов проверяются по позициям без чтения текста документов
+    void searchCandidates(const std::vector<std::string>& words, int pageSize,
+        const std::function<bool(std::vector<Candidate>&)>& accept);
+
+    // Текст окон сниппетов (snippet.start уже выбран). Из content читаются
+    // только символы между сохранёнными смещениями слов вокруг окна
+    void loadSnippets(std::vector<SearchResult>& results);
 
     // Получить все документы (для отладки)
     std::vector<std::tuple<int, std::string, std::string>> getAllDocuments();
@@ -75,9 +129,12 @@ public:
     void deleteAllDocuments();
 
 private:
-    // Вспомогательный метод для выполнения операций в транзакции
-    template<typename Func>
-    auto executeTransaction(Func&& func) -> decltype(func(std::declval<pqxx::work&>()));
+    // Запись документа и его слов в открытой транзакции. wordIds - ID уже
+    // найденных слов (общие для пакета документов, может быть nullptr)
+    static int insertDocument(pqxx::work& db, const std::string& url, const std::string& title,
+        const std::string& content, const std::string& wordOffsets);
+    static void insertWords(pqxx::work& db, int documentId, const TermList& wordsAndFrequency,
+        std::unordered_map<std::string, int>* wordIds);
 };
 
 #endif // !DATABASE_H
\ No newline at end of file
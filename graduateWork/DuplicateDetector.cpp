@@ -0,0 +1,198 @@
+#include "DuplicateDetector.h"
+#include <algorithm>
+#include <bitset>
+
+namespace
+{
+    // FNV-1a: быстрый хеш строки
+    uint64_t fnv1a(std::string_view data)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : data)
+        {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Финальное перемешивание splitmix64: у FNV старшие биты
+    // коротких слов распределены плохо, а SimHash использует все 64
+    uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    int hammingDistance(uint64_t a, uint64_t b)
+    {
+        return static_cast<int>(std::bitset<64>(a ^ b).count());
+    }
+}
+
+DuplicateDetector::DuplicateDetector(size_t capacity, int maxDistance)
+    : capacity_(std::max<size_t>(capacity, 1))
+    , maxDistance_(std::clamp(maxDistance, 0, kMaxBands - 1))
+    , bands_(maxDistance_ + 1)
+    , nextId_(0)
+    , exactDuplicates_(0)
+    , nearDuplicates_(0)
+{
+}
+
+DuplicateDetector::Fingerprint DuplicateDetector::computeFingerprint(std::string_view cleanContent,
+    const TermList& wordsFrequency)
+{
+    Fingerprint fingerprint;
+    fingerprint.contentHash = mix(fnv1a(cleanContent));
+    fingerprint.features = wordsFrequency.size();
+    fingerprint.empty = cleanContent.empty();
+
+    // Каждое слово голосует за каждый бит: +вес, если бит хеша слова
+    // равен 1, и -вес, если 0. Итоговый бит - знак суммы
+    std::array<long long, 64> votes{};
+    for (const auto& [word, frequency] : wordsFrequency)
+    {
+        uint64_t hash = mix(fnv1a(word));
+        for (int bit = 0; bit < 64; ++bit)
+        {
+            votes[bit] += ((hash >> bit) & 1ULL) ? frequency : -frequency;
+        }
+    }
+
+    for (int bit = 0; bit < 64; ++bit)
+    {
+        if (votes[bit] > 0)
+        {
+            fingerprint.simHash |= (1ULL << bit);
+        }
+    }
+
+    return fingerprint;
+}
+
+uint64_t DuplicateDetector::bandKey(uint64_t simHash, int band) const
+{
+    int width = 64 / bands_;
+    int shift = band * width;
+    int bits = (band == bands_ - 1) ? 64 - shift : width;
+    uint64_t mask = bits >= 64 ? ~0ULL : ((1ULL << bits) - 1);
+    return (simHash >> shift) & mask;
+}
+
+const DuplicateDetector::Entry* DuplicateDetector::findEntry(uint64_t id) const
+{
+    if (entries_.empty() || id < entries_.front().id)
+    {
+        return nullptr;
+    }
+
+    size_t index = static_cast<size_t>(id - entries_.front().id);
+    return index < entries_.size() ? &entries_[index] : nullptr;
+}
+
+void DuplicateDetector::evictOldest()
+{
+    const Entry& oldest = entries_.front();
+
+    auto hashIt = byContentHash_.find(oldest.fingerprint.contentHash);
+    if (hashIt != byContentHash_.end() && hashIt->second == oldest.id)
+    {
+        byContentHash_.erase(hashIt);
+    }
+
+    if (oldest.fingerprint.features >= kMinFeatures)
+    {
+        for (int band = 0; band < bands_; ++band)
+        {
+            auto range = byBand_[band].equal_range(bandKey(oldest.fingerprint.simHash, band));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (it->second == oldest.id)
+                {
+                    byBand_[band].erase(it);
+                    break;
+                }
+            }
+        }
+    }
+
+    entries_.pop_front();
+}
+
+DuplicateDetector::Verdict DuplicateDetector::checkAndInsert(const Fingerprint& fingerprint,
+    const std::string& url, std::string& originalUrl)
+{
+    if (fingerprint.empty)
+    {
+        return Verdict::Unique;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Точный дубликат
+    auto hashIt = byContentHash_.find(fingerprint.contentHash);
+    if (hashIt != byContentHash_.end())
+    {
+        if (const Entry* entry = findEntry(hashIt->second))
+        {
+            originalUrl = entry->url;
+            exactDuplicates_++;
+            return Verdict::ExactDuplicate;
+        }
+    }
+
+    // Почти-дубликат: кандидаты из совпавших полос проверяем по расстоянию
+    bool useSimHash = fingerprint.features >= kMinFeatures;
+    if (useSimHash)
+    {
+        for (int band = 0; band < bands_; ++band)
+        {
+            auto range = byBand_[band].equal_range(bandKey(fingerprint.simHash, band));
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                const Entry* entry = findEntry(it->second);
+                if (entry && hammingDistance(entry->fingerprint.simHash, fingerprint.simHash) <= maxDistance_)
+                {
+                    originalUrl = entry->url;
+                    nearDuplicates_++;
+                    return Verdict::NearDuplicate;
+                }
+            }
+        }
+    }
+
+    // Уникальная страница - запоминаем
+    if (entries_.size() >= capacity_)
+    {
+        evictOldest();
+    }
+
+    uint64_t id = nextId_++;
+    entries_.push_back({ id, fingerprint, url });
+    byContentHash_[fingerprint.contentHash] = id;
+
+    if (useSimHash)
+    {
+        for (int band = 0; band < bands_; ++band)
+        {
+            byBand_[band].emplace(bandKey(fingerprint.simHash, band), id);
+        }
+    }
+
+    return Verdict::Unique;
+}
+
+long long DuplicateDetector::getExactDuplicates() const
+{
+    return exactDuplicates_;
+}
+
+long long DuplicateDetector::getNearDuplicates() const
+{
+    return nearDuplicates_;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef DUPLICATEDETECTOR_H
+#define DUPLICATEDETECTOR_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <array>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include "TermList.h"
+
+// Поиск дубликатов и почти-дубликатов страниц.
+// Для каждой страницы считаются два отпечатка:
+//  - точный хеш очищенного текста;
+//  - 64-битный SimHash по словам с весом по частоте.
+// У похожих страниц SimHash отличается в небольшом числе бит, поэтому
+// почти-дубликат - это отпечаток на расстоянии Хэмминга <= maxDistance.
+// Поиск идёт по полосам: 64 бита делятся на (maxDistance + 1) полос, и при
+// расстоянии <= maxDistance хотя бы одна полоса совпадает целиком.
+class DuplicateDetector
+{
+public:
+    struct Fingerprint
+    {
+        uint64_t contentHash = 0;
+        uint64_t simHash = 0;
+        size_t features = 0;  // сколько разных слов учтено в SimHash
+        bool empty = true;    // очищенный текст пуст
+    };
+
+    enum class Verdict
+    {
+        Unique,
+        ExactDuplicate,
+        NearDuplicate
+    };
+
+    // capacity - сколько последних отпечатков хранить
+    // maxDistance - порог расстояния Хэмминга для почти-дубликатов (0..7)
+    DuplicateDetector(size_t capacity, int maxDistance);
+
+    // Расчёт отпечатка страницы
+    static Fingerprint computeFingerprint(std::string_view cleanContent,
+        const TermList& wordsFrequency);
+
+    // Проверка страницы и запоминание её отпечатка, если она уникальна.
+    // Для дубликата в originalUrl возвращается адрес найденного оригинала.
+    // Страница без текста (пустая или собираемая скриптом) всегда
+    // уникальна и не запоминается: иначе все такие страницы оказались
+    // бы дубликатами первой из них
+    Verdict checkAndInsert(const Fingerprint& fingerprint, const std::string& url, std::string& originalUrl);
+
+    long long getExactDuplicates() const;
+    long long getNearDuplicates() const;
+
+private:
+    // Меньше слов - SimHash ненадёжен, сравниваем только точный хеш
+    static constexpr size_t kMinFeatures = 8;
+    static constexpr int kMaxBands = 8;
+
+    struct Entry
+    {
+        uint64_t id;
+        Fingerprint fingerprint;
+        std::string url;
+    };
+
+    const size_t capacity_;
+    const int maxDistance_;
+    const int bands_;
+
+    mutable std::mutex mutex_;
+
+    // Последние отпечатки в порядке добавления (id растёт)
+    std::deque<Entry> entries_;
+    uint64_t nextId_;
+
+    std::unordered_map<uint64_t, uint64_t> byContentHash_;
+    std::array<std::unordered_multimap<uint64_t, uint64_t>, kMaxBands> byBand_;
+
+    std::atomic<long long> exactDuplicates_;
+    std::atomic<long long> nearDuplicates_;
+
+    uint64_t bandKey(uint64_t simHash, int band) const;
+    const Entry* findEntry(uint64_t id) const;
+    void evictOldest();
+};
+
+#endif // DUPLICATEDETECTOR_H
\ No newline at end of file
@@ -1,19 +1,259 @@
 #include "HTMLDownloader.h"
-#include <regex>
+#include "WarcWriter.h"
+#include "HostHealth.h"
 #include <stdexcept>
 #include <algorithm>
 #include <iostream>
+#include <cctype>
+#include <cstdlib>
 #include <curl/curl.h>
 
+namespace
+{
+    // Таймаут загрузки по умолчанию
+    constexpr long kDefaultTimeoutMs = 30000;
+
+    // Состояние одной загрузки, общее для callback-функций CURL
+    struct TransferState
+    {
+        // Куда складывать тело: в строку или по кускам в sink
+        std::string* body = nullptr;
+        const std::function<bool(const char*, size_t)>* sink = nullptr;
+        size_t received = 0;
+
+        size_t maxBodySize = 0;
+        const std::vector<std::string>* allowedContentTypes = nullptr;
+        double maxCompressionRatio = 0.0;
+
+        // Запрос, к которому относится состояние: из него WriteCallback
+        // узнаёт, сколько байт уже принято по сети (до распаковки)
+        CURL* curl = nullptr;
+
+        // Данные текущего блока заголовков (при редиректах их несколько)
+        long statusCode = 0;
+        std::string contentType;
+        std::string contentEncoding;
+        long long contentLength = -1;
+
+        // Строка статуса и заголовки последнего ответа как есть (для WARC)
+        std::string rawHeaders;
+
+        // Условный запрос: дополнительные заголовки запроса и валидаторы
+        // версии из ответа
+        std::vector<std::string> requestHeaders;
+        std::string etag;
+        std::string lastModified;
+
+        // Причина досрочного прерывания (пусто - загрузка не прерывалась)
+        std::string rejectReason;
+        long rejectedCode = 0;
+    };
+
+    // Итог выполненного запроса
+    struct TransferResult
+    {
+        long httpCode = 0;
+        long long wireBytes = 0;
+    };
+
+    std::string toLowerAscii(std::string value)
+    {
+        std::transform(value.begin(), value.end(), value.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return value;
+    }
+
+    std::string trim(const std::string& value)
+    {
+        size_t start = value.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos)
+        {
+            return "";
+        }
+        size_t end = value.find_last_not_of(" \t\r\n");
+        return value.substr(start, end - start + 1);
+    }
+
+    // Проверка заголовков перед получением тела.
+    // Возвращает false, если загрузку нужно прервать
+    bool checkHeaders(TransferState& state)
+    {
+        // Ответы 1xx и редиректы пропускаем: за ними придёт следующий блок.
+        // 304 на условный запрос тела не содержит - это не ошибка
+        if (state.statusCode < 200 || (state.statusCode >= 300 && state.statusCode < 400))
+        {
+            return true;
+        }
+
+        // Ошибка HTTP: тело страницы с ошибкой нам не нужно
+        if (state.statusCode != 200)
+        {
+            state.rejectedCode = state.statusCode;
+            state.rejectReason = "HTTP ошибка " + std::to_string(state.statusCode);
+            return false;
+        }
+
+        // Тип содержимого: сравниваем без параметров (charset и т.п.)
+        if (!state.contentType.empty())
+        {
+            std::string mimeType = trim(state.contentType.substr(0, state.contentType.find(';')));
+            const auto& allowed = *state.allowedContentTypes;
+            if (!allowed.empty() && std::find(allowed.begin(), allowed.end(), mimeType) == allowed.end())
+            {
+                state.rejectReason = "неподходящий тип содержимого " + mimeType;
+                return false;
+            }
+        }
+
+        if (state.contentLength >= 0)
+        {
+            if (static_cast<unsigned long long>(state.contentLength) > state.maxBodySize)
+            {
+                state.rejectReason = "размер " + std::to_string(state.contentLength) + " байт превышает лимит";
+                return false;
+            }
+
+            // Выделяем буфер заранее по заявленному размеру. Для сжатого
+            // ответа Content-Length - это размер на проводе, HTML обычно
+            // больше в несколько раз
+            size_t expected = static_cast<size_t>(state.contentLength);
+            bool encoded = !state.contentEncoding.empty() && state.contentEncoding != "identity";
+            if (encoded)
+            {
+                expected = std::min(expected * 4, state.maxBodySize);
+            }
+            if (state.body)
+            {
+                state.body->reserve(expected);
+            }
+        }
+
+        return true;
+    }
+}
+
+// Callback для заголовков: вызывается для каждой строки заголовка
+static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, TransferState* state)
+{
+    size_t length = size * nitems;
+    std::string line(buffer, length);
+
+    if (line.rfind("HTTP/", 0) == 0)
+    {
+        // Строка статуса открывает новый блок заголовков
+        size_t spacePos = line.find(' ');
+        state->statusCode = spacePos != std::string::npos ? std::strtol(line.c_str() + spacePos + 1, nullptr, 10) : 0;
+        state->contentType.clear();
+        state->contentEncoding.clear();
+        state->contentLength = -1;
+        state->etag.clear();
+        state->lastModified.clear();
+        state->rawHeaders = line;
+        return length;
+    }
+
+    state->rawHeaders += line;
+
+    std::string trimmed = trim(line);
+    if (trimmed.empty())
+    {
+        // Конец блока заголовков - решаем, нужно ли тело
+        return checkHeaders(*state) ? length : 0;
+    }
+
+    size_t colonPos = trimmed.find(':');
+    if (colonPos == std::string::npos)
+    {
+        return length;
+    }
+
+    std::string name = toLowerAscii(trim(trimmed.substr(0, colonPos)));
+    std::string value = trim(trimmed.substr(colonPos + 1));
+
+    if (name == "content-type")
+    {
+        state->contentType = toLowerAscii(value);
+    }
+    else if (name == "content-encoding")
+    {
+        state->contentEncoding = toLowerAscii(value);
+    }
+    else if (name == "content-length")
+    {
+        state->contentLength = std::strtoll(value.c_str(), nullptr, 10);
+    }
+    else if (name == "etag")
+    {
+        state->etag = value;
+    }
+    else if (name == "last-modified")
+    {
+        state->lastModified = value;
+    }
+
+    return length;
+}
+
 // Callback для записи данных
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp)
+static size_t WriteCallback(void* contents, size_t size, size_t nmemb, TransferState* state)
 {
-    userp->append((char*)contents, size * nmemb);
-    return size * nmemb;
+    size_t length = size * nmemb;
+
+    // Сервер мог не указать Content-Length или указать неверный
+    if (state->received + length > state->maxBodySize)
+    {
+        state->rejectReason = "тело ответа превышает лимит " + std::to_string(state->maxBodySize) + " байт";
+        return 0;
+    }
+
+    // Защита от "бомб": маленький сжатый ответ, распаковывающийся
+    // в гигантский. Проверяем после первого мегабайта, сравнивая
+    // с числом байт, принятых по сети к этому моменту
+    size_t decoded = state->received + length;
+    if (state->maxCompressionRatio > 0.0 && decoded > 1024 * 1024)
+    {
+        curl_off_t wireBytes = 0;
+        curl_easy_getinfo(state->curl, CURLINFO_SIZE_DOWNLOAD_T, &wireBytes);
+        if (wireBytes > 0 &&
+            static_cast<double>(decoded) / static_cast<double>(wireBytes) > state->maxCompressionRatio)
+        {
+            state->rejectReason = "подозрительная степень сжатия";
+            return 0;
+        }
+    }
+
+    state->received += length;
+    if (state->sink)
+    {
+        if (!(*state->sink)(static_cast<const char*>(contents), length))
+        {
+            state->rejectReason = "загрузка прервана получателем";
+            return 0;
+        }
+    }
+    else
+    {
+        state->body->append(static_cast<const char*>(contents), length);
+    }
+    return length;
 }
 
-HTMLDownloader::HTMLDownloader()
+HTMLDownloader::HTMLDownloader(const Config& config)
+    : normalizer_(UrlNormalizer::Rules{ config.getSpiderStripQueryParams(), config.shouldSortQueryParams() })
+    , maxBodySize_(static_cast<size_t>(config.getSpiderMaxBodySize()))
+    , acceptEncoding_(config.getSpiderAcceptEncoding())
+    , compression_(config.isCompressedTransfer())
+    , maxCompressionRatio_(config.getSpiderMaxCompressionRatio())
+    , totalWireBytes_(0)
+    , totalDecodedBytes_(0)
+    , recorder_(nullptr)
+    , hostHealth_(nullptr)
 {
+    for (const auto& type : config.getSpiderAllowedContentTypes())
+    {
+        allowedContentTypes_.push_back(toLowerAscii(type));
+    }
+
     curl_global_init(CURL_GLOBAL_DEFAULT);
 }
 
@@ -22,7 +262,10 @@ HTMLDownloader::~HTMLDownloader()
     curl_global_cleanup();
 }
 
-std::string HTMLDownloader::download(const std::string& url)
+// Выполнение запроса с заданным состоянием загрузки.
+// Бросает DownloadError при ошибке сети или прерывании загрузки
+static TransferResult performTransfer(const std::string& url, TransferState& state,
+    bool compression, const std::string& acceptEncoding, long timeoutMs)
 {
     CURL* curl = curl_easy_init();
     if (!curl)
@@ -30,151 +273,239 @@ std::string HTMLDownloader::download(const std::string& url)
         throw std::runtime_error("Не удалось инициализировать CURL");
     }
 
-    std::string response;
-
+    state.curl = curl;
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &state);
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state);
+
+    // Сжатие: пустая строка в CURLOPT_ACCEPT_ENCODING означает
+    // "все кодировки, которые поддерживает сборка libcurl" (gzip, deflate, br).
+    // Распаковка происходит прозрачно, в WriteCallback приходит HTML
+    if (compression)
+    {
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, acceptEncoding.c_str());
+    }
     curl_easy_setopt(curl, CURLOPT_USERAGENT, "SearchEngineBot/1.0");
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, std::min(timeoutMs, 10000L));
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
 
     // Для HTTPS
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
 
+    curl_slist* headers = nullptr;
+    for (const auto& header : state.requestHeaders)
+    {
+        headers = curl_slist_append(headers, header.c_str());
+    }
+    if (headers)
+    {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    }
+
     CURLcode res = curl_easy_perform(curl);
+    curl_slist_free_all(headers);
+
+    // Загрузка прервана нашими callback-функциями
+    if (!state.rejectReason.empty())
+    {
+        curl_easy_cleanup(curl);
+        if (state.rejectedCode != 0)
+        {
+            throw DownloadError(DownloadError::Kind::Http, state.rejectedCode,
+                state.rejectReason + " для URL: " + url);
+        }
+        throw DownloadError(DownloadError::Kind::Rejected, 0,
+            "Ответ отброшен (" + state.rejectReason + ") для URL: " + url);
+    }
 
     if (res != CURLE_OK)
     {
         std::string error = curl_easy_strerror(res);
         curl_easy_cleanup(curl);
-        throw std::runtime_error("Ошибка CURL: " + error + " для URL: " + url);
+        throw DownloadError(
+            res == CURLE_OPERATION_TIMEDOUT ? DownloadError::Kind::Timeout : DownloadError::Kind::Transport,
+            0, "Ошибка CURL: " + error + " для URL: " + url);
     }
 
-    long http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+    TransferResult result;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.httpCode);
+
+    curl_off_t wireBytes = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &wireBytes);
+    result.wireBytes = static_cast<long long>(wireBytes);
 
     curl_easy_cleanup(curl);
+    return result;
+}
+
+std::string HTMLDownloader::download(const std::string& url)
+{
+    std::string response;
+    Validators current;
+    downloadIfModified(url, Validators(), response, current);
+    return response;
+}
 
-    if (http_code != 200)
+bool HTMLDownloader::downloadIfModified(const std::string& url, const Validators& known,
+    std::string& response, Validators& current)
+{
+    response.clear();
+
+    TransferState state;
+    state.body = &response;
+    state.maxBodySize = maxBodySize_;
+    state.allowedContentTypes = &allowedContentTypes_;
+    state.maxCompressionRatio = maxCompressionRatio_;
+
+    long timeoutMs = hostHealth_
+        ? hostHealth_->timeoutMillis(std::string(UrlNormalizer::parse(url).authority))
+        : kDefaultTimeoutMs;
+
+    if (!known.etag.empty())
+    {
+        state.requestHeaders.push_back("If-None-Match: " + known.etag);
+    }
+    if (!known.lastModified.empty())
     {
-        throw std::runtime_error("HTTP ошибка " + std::to_string(http_code) + " для URL: " + url);
+        state.requestHeaders.push_back("If-Modified-Since: " + known.lastModified);
     }
 
-    std::cout << "✔ Страница загружена: " << url << " (" << response.size() << " байт)" << std::endl;
+    // В архив попадает каждый полученный ответ - и 304, и редиректы,
+    // и ошибки: воспроизведение должно видеть то же, что видел паук
+    TransferResult result;
+    try
+    {
+        result = performTransfer(url, state, compression_, acceptEncoding_, timeoutMs);
+    }
+    catch (const DownloadError& e)
+    {
+        // Ответ с кодом ошибки прерывается до тела, но заголовки получены
+        if (e.getKind() == DownloadError::Kind::Http)
+        {
+            recordResponse(url, state.rawHeaders, response);
+        }
+        throw;
+    }
+    recordTransfer(result.wireBytes, static_cast<long long>(response.size()));
+    recordResponse(url, state.rawHeaders, response);
+
+    // Страница не изменилась: известная версия остаётся в силе
+    if (result.httpCode == 304 && !state.requestHeaders.empty())
+    {
+        current = known;
+        std::cout << "✔ Страница не изменилась: " << url << std::endl;
+        return false;
+    }
+
+    if (result.httpCode != 200)
+    {
+        throw DownloadError(DownloadError::Kind::Http, result.httpCode,
+            "HTTP ошибка " + std::to_string(result.httpCode) + " для URL: " + url);
+    }
+
+    current.etag = state.etag;
+    current.lastModified = state.lastModified;
+
+    std::cout << "✔ Страница загружена: " << url << " (" << response.size() << " байт, по сети "
+        << result.wireBytes << ")" << std::endl;
+    return true;
+}
+
+std::string HTMLDownloader::downloadResource(const std::string& url, size_t maxSize)
+{
+    std::string response;
+
+    // Пустой список типов - принимается любое содержимое
+    const std::vector<std::string> anyType;
+
+    TransferState state;
+    state.body = &response;
+    state.maxBodySize = maxSize;
+    state.allowedContentTypes = &anyType;
+    state.maxCompressionRatio = maxCompressionRatio_;
+
+    TransferResult result = performTransfer(url, state, compression_, acceptEncoding_, kDefaultTimeoutMs);
+    recordTransfer(result.wireBytes, static_cast<long long>(response.size()));
+
+    if (result.httpCode != 200)
+    {
+        throw DownloadError(DownloadError::Kind::Http, result.httpCode,
+            "HTTP ошибка " + std::to_string(result.httpCode) + " для URL: " + url);
+    }
     return response;
 }
 
-std::vector<std::string> HTMLDownloader::extractLinks(const std::string& html, const std::string& baseUrl)
+void HTMLDownloader::downloadStream(const std::string& url, const std::function<bool(const char*, size_t)>& sink,
+    size_t maxSize)
 {
-    std::vector<std::string> links;
+    const std::vector<std::string> anyType;
 
-    try
+    TransferState state;
+    state.sink = &sink;
+    state.maxBodySize = maxSize;
+    state.allowedContentTypes = &anyType;
+    state.maxCompressionRatio = maxCompressionRatio_;
+
+    TransferResult result = performTransfer(url, state, compression_, acceptEncoding_, kDefaultTimeoutMs);
+    recordTransfer(result.wireBytes, static_cast<long long>(state.received));
+
+    if (result.httpCode != 200)
     {
-        // Регулярное выражение для поиска ссылок
-        std::regex linkRegex(R"(<a\s[^>]*href\s*=\s*["']([^"']+)["'])", std::regex::icase);
+        throw DownloadError(DownloadError::Kind::Http, result.httpCode,
+            "HTTP ошибка " + std::to_string(result.httpCode) + " для URL: " + url);
+    }
+}
 
-        auto begin = std::sregex_iterator(html.begin(), html.end(), linkRegex);
-        auto end = std::sregex_iterator();
+void HTMLDownloader::setRecorder(WarcWriter* recorder)
+{
+    recorder_ = recorder;
+}
 
-        // Извлекаем базовый URL
-        std::string baseDomain;
-        size_t protoPos = baseUrl.find("://");
-        if (protoPos != std::string::npos)
-        {
-            size_t slashPos = baseUrl.find('/', protoPos + 3);
-            if (slashPos != std::string::npos)
-            {
-                baseDomain = baseUrl.substr(0, slashPos);
-            }
-            else
-            {
-                baseDomain = baseUrl;
-            }
-        }
-        else
-        {
-            baseDomain = "http://" + baseUrl;
-        }
+void HTMLDownloader::setHostHealth(const HostHealth* hostHealth)
+{
+    hostHealth_ = hostHealth;
+}
 
-        for (std::sregex_iterator i = begin; i != end; ++i)
-        {
-            std::smatch match = *i;
-            if (match.size() > 1)
-            {
-                std::string link = match[1].str();
-
-                // Пропускаем пустые и javascript ссылки
-                if (link.empty() ||
-                    link[0] == '#' ||
-                    link.find("javascript:") == 0 ||
-                    link.find("mailto:") == 0 ||
-                    link.find("tel:") == 0)
-                {
-                    continue;
-                }
-
-                // Преобразуем относительные ссылки в абсолютные
-                if (link.find("://") == std::string::npos)
-                {
-                    if (link[0] == '/')
-                    {
-                        // Абсолютный путь от корня
-                        if (baseDomain.back() == '/')
-                        {
-                            link = baseDomain.substr(0, baseDomain.length() - 1) + link;
-                        }
-                        else
-                        {
-                            link = baseDomain + link;
-                        }
-                    }
-                    else
-                    {
-                        // Относительный путь
-                        std::string basePath = baseUrl;
-                        size_t lastSlash = basePath.find_last_of('/');
-                        if (lastSlash != std::string::npos)
-                        {
-                            basePath = basePath.substr(0, lastSlash + 1);
-                            link = basePath + link;
-                        }
-                        else
-                        {
-                            link = baseDomain + "/" + link;
-                        }
-                    }
-                }
-
-                // Убираем якоря
-                size_t anchorPos = link.find('#');
-                if (anchorPos != std::string::npos)
-                {
-                    link = link.substr(0, anchorPos);
-                }
-
-                // Добавляем протокол если нужно
-                if (link.find("://") == std::string::npos && link[0] != '/')
-                {
-                    link = "http://" + link;
-                }
-
-                // Убираем дубликаты
-                if (std::find(links.begin(), links.end(), link) == links.end())
-                {
-                    links.push_back(link);
-                }
-            }
-        }
+void HTMLDownloader::recordResponse(const std::string& url, const std::string& rawHeaders, const std::string& body)
+{
+    if (!recorder_ || rawHeaders.empty())
+    {
+        return;
+    }
 
-        std::cout << "  Найдено ссылок: " << links.size() << std::endl;
+    // Сбой записи архива не делает загрузку неудачной
+    try
+    {
+        recorder_->writeResponse(url, rawHeaders, body);
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Ошибка при извлечении ссылок: " << e.what() << std::endl;
+        std::cerr << "⚠️  Ответ не записан в WARC-архив (" << url << "): " << e.what() << std::endl;
     }
+}
+
+void HTMLDownloader::recordTransfer(long long wireBytes, long long decodedBytes)
+{
+    totalWireBytes_ += wireBytes;
+    totalDecodedBytes_ += decodedBytes;
+}
 
-    return links;
+long long HTMLDownloader::getTotalWireBytes() const
+{
+    return totalWireBytes_;
+}
+
+long long HTMLDownloader::getTotalDecodedBytes() const
+{
+    return totalDecodedBytes_;
+}
+
+const UrlNormalizer& HTMLDownloader::getUrlNormalizer() const
+{
+    return normalizer_;
 }
\ No newline at end of file
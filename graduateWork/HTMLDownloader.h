@@ -2,19 +2,121 @@
 #define HTMLDOWNLOADER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <stdexcept>
+#include <atomic>
+#include <functional>
+#include "Config.h"
+#include "UrlNormalizer.h"
+#include "PageFetcher.h"
 
-class HTMLDownloader
+class WarcWriter;
+class HostHealth;
+
+// Ошибка загрузки с указанием причины
+class DownloadError : public std::runtime_error
 {
 public:
-    HTMLDownloader();
+    enum class Kind
+    {
+        Transport,  // ошибка соединения, DNS, TLS
+        Timeout,    // истёк таймаут
+        Http,       // сервер ответил кодом, отличным от 200
+        Rejected    // ответ отброшен: не HTML или слишком большой
+    };
+
+    DownloadError(Kind kind, long httpCode, const std::string& message)
+        : std::runtime_error(message)
+        , kind_(kind)
+        , httpCode_(httpCode)
+    {
+    }
+
+    Kind getKind() const { return kind_; }
+    long getHttpCode() const { return httpCode_; }
+
+    // Признак перегрузки сервера или сети
+    bool isOverload() const
+    {
+        return kind_ == Kind::Timeout || httpCode_ == 429 || httpCode_ == 503;
+    }
+
+private:
+    Kind kind_;
+    long httpCode_;
+};
+
+class HTMLDownloader : public PageFetcher
+{
+private:
+    // Нормализатор для обнаруженных ссылок
+    UrlNormalizer normalizer_;
+
+    // Максимальный размер тела ответа (байт)
+    size_t maxBodySize_;
+
+    // Допустимые типы содержимого (в нижнем регистре, без параметров)
+    std::vector<std::string> allowedContentTypes_;
+
+    // Заголовок Accept-Encoding (пусто - без сжатия)
+    std::string acceptEncoding_;
+    bool compression_;
+
+    // Допустимое отношение распакованного размера к переданному
+    // (защита от "zip-бомб")
+    double maxCompressionRatio_;
+
+    // Трафик: передано по сети (сжатое тело) и после распаковки
+    std::atomic<long long> totalWireBytes_;
+    std::atomic<long long> totalDecodedBytes_;
+
+    // Архив, в который записываются полученные ответы (может быть nullptr)
+    WarcWriter* recorder_;
+
+    // Источник адаптивных таймаутов по хостам (может быть nullptr)
+    const HostHealth* hostHealth_;
+
+    // Запись ответа в архив, если он ведётся
+    void recordResponse(const std::string& url, const std::string& rawHeaders, const std::string& body);
+
+    // Учёт трафика одного ответа
+    void recordTransfer(long long wireBytes, long long decodedBytes);
+
+public:
+    HTMLDownloader(const Config& config);
     ~HTMLDownloader();
 
     // Скачивание HTML-страницы
-    std::string download(const std::string& url);
+    std::string download(const std::string& url) override;
+
+    // Условное скачивание с If-None-Match / If-Modified-Since
+    bool downloadIfModified(const std::string& url, const Validators& known,
+        std::string& html, Validators& current) override;
+
+    // Загрузка вспомогательного ресурса (robots.txt) любого типа
+    // целиком, не больше maxSize байт
+    std::string downloadResource(const std::string& url, size_t maxSize);
+
+    // Потоковая загрузка: тело по кускам передаётся в sink и не
+    // накапливается в памяти (большие sitemap.xml). sink возвращает
+    // false, чтобы прервать загрузку
+    void downloadStream(const std::string& url, const std::function<bool(const char*, size_t)>& sink, size_t maxSize);
+
+    // Запись каждого ответа на запрос страницы в WARC-архив
+    // (nullptr - не записывать)
+    void setRecorder(WarcWriter* recorder);
+
+    // Таймауты загрузки страниц по наблюдаемой задержке хоста
+    // (nullptr - фиксированный таймаут)
+    void setHostHealth(const HostHealth* hostHealth);
+
+    // Нормализатор URL с правилами из конфигурации
+    const UrlNormalizer& getUrlNormalizer() const;
 
-    // Извлечение ссылок из HTML
-    std::vector<std::string> extractLinks(const std::string& html, const std::string& baseUrl);
+    // Суммарный трафик
+    long long getTotalWireBytes() const;
+    long long getTotalDecodedBytes() const;
 };
 
 #endif // HTMLDOWNLOADER_H
\ No newline at end of file
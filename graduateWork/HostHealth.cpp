@@ -0,0 +1,213 @@
+#include "HostHealth.h"
+#include <algorithm>
+#include <cmath>
+
+HostHealth::HostHealth(const Settings& settings)
+    : settings_(settings)
+    , openHosts_(0)
+    , trips_(0)
+{
+}
+
+void HostHealth::open(Host& host, Clock::time_point now)
+{
+    if (host.state == State::Closed)
+    {
+        openHosts_++;
+    }
+
+    // Каждое повторное отключение подряд вдвое длиннее предыдущего
+    auto duration = settings_.openDuration * (1LL << std::min(host.trips, 16));
+    host.openUntil = now + std::min<std::chrono::milliseconds>(duration, settings_.maxOpenDuration);
+    host.state = State::Open;
+    host.probeInFlight = false;
+    host.trips++;
+    trips_++;
+}
+
+HostHealth::Host& HostHealth::entry(const std::string& host)
+{
+    auto it = hosts_.find(host);
+    if (it != hosts_.end())
+    {
+        return it->second;
+    }
+
+    // Как в RobotsCache: при переполнении забываем половину. Сначала
+    // здоровые хосты без Crawl-delay - о них помнить нечего, кроме
+    // задержки ответа. Отключённые не трогаем никогда
+    if (hosts_.size() >= settings_.maxHosts)
+    {
+        size_t target = settings_.maxHosts / 2;
+        for (int pass = 0; pass < 2 && hosts_.size() > target; pass++)
+        {
+            for (auto victim = hosts_.begin(); victim != hosts_.end() && hosts_.size() > target;)
+            {
+                const Host& candidate = victim->second;
+                bool idle = candidate.consecutiveFailures == 0 && candidate.crawlDelay.count() == 0;
+                if (candidate.state == State::Closed && (idle || pass == 1))
+                {
+                    victim = hosts_.erase(victim);
+                }
+                else
+                {
+                    ++victim;
+                }
+            }
+        }
+    }
+
+    return hosts_[host];
+}
+
+bool HostHealth::tryAcquire(const std::string& host, Clock::time_point& retryAt)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hosts_.find(host);
+    if (it == hosts_.end())
+    {
+        return true;
+    }
+
+    Host& entry = it->second;
+    auto now = Clock::now();
+
+    if (entry.state == State::Open && now >= entry.openUntil)
+    {
+        entry.state = State::HalfOpen;
+    }
+
+    // Отключённый хост ждёт окончания отключения. Полуоткрытый
+    // пропускает ровно один пробный запрос, остальные ждут его результата:
+    // проба не длится дольше максимального таймаута
+    if (entry.state == State::Open)
+    {
+        retryAt = entry.openUntil;
+        return false;
+    }
+    if (entry.state == State::HalfOpen && entry.probeInFlight)
+    {
+        retryAt = now + std::chrono::milliseconds(settings_.maxTimeoutMs);
+        return false;
+    }
+
+    // Crawl-delay: следующий запрос не раньше назначенного времени
+    if (now < entry.nextRequest)
+    {
+        retryAt = entry.nextRequest;
+        return false;
+    }
+
+    if (entry.state == State::HalfOpen)
+    {
+        entry.probeInFlight = true;
+    }
+    entry.nextRequest = now + entry.crawlDelay;
+    return true;
+}
+
+bool HostHealth::recordSuccess(const std::string& host, double latencyMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Host& entry = this->entry(host);
+
+    bool reclosed = entry.state != State::Closed;
+    if (reclosed)
+    {
+        openHosts_--;
+    }
+    entry.state = State::Closed;
+    entry.consecutiveFailures = 0;
+    entry.trips = 0;
+    entry.probeInFlight = false;
+    entry.timeoutBackoff = 0;
+
+    // RFC 6298: alpha = 1/8, beta = 1/4
+    if (entry.smoothedMs <= 0.0)
+    {
+        entry.smoothedMs = latencyMs;
+        entry.deviationMs = latencyMs / 2;
+    }
+    else
+    {
+        entry.deviationMs += (std::abs(entry.smoothedMs - latencyMs) - entry.deviationMs) / 4;
+        entry.smoothedMs += (latencyMs - entry.smoothedMs) / 8;
+    }
+    return reclosed;
+}
+
+void HostHealth::recordFailure(const std::string& host, bool timeout)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Host& entry = this->entry(host);
+    auto now = Clock::now();
+
+    if (timeout)
+    {
+        entry.timeoutBackoff = std::min(entry.timeoutBackoff + 1, 8);
+    }
+
+    // Неудачная проба - снова отключаем
+    if (entry.state == State::HalfOpen)
+    {
+        open(entry, now);
+        return;
+    }
+
+    entry.consecutiveFailures++;
+    if (entry.state == State::Closed && entry.consecutiveFailures >= settings_.failureThreshold)
+    {
+        open(entry, now);
+    }
+}
+
+void HostHealth::setCrawlDelay(const std::string& host, double seconds)
+{
+    // Ограничение до перевода в миллисекунды: приведение слишком
+    // большого double к целому - неопределённое поведение
+    double maxSeconds = settings_.maxCrawlDelay.count() / 1000.0;
+    if (!std::isfinite(seconds) || seconds < 0.0)
+    {
+        seconds = 0.0;
+    }
+    auto delay = std::chrono::milliseconds(static_cast<long long>(std::min(seconds, maxSeconds) * 1000));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (delay.count() == 0 && hosts_.find(host) == hosts_.end())
+    {
+        return;
+    }
+    entry(host).crawlDelay = delay;
+}
+
+std::chrono::milliseconds HostHealth::getCrawlDelay(const std::string& host) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hosts_.find(host);
+    return it == hosts_.end() ? std::chrono::milliseconds(0) : it->second.crawlDelay;
+}
+
+long HostHealth::timeoutMillis(const std::string& host) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hosts_.find(host);
+    if (it == hosts_.end() || it->second.smoothedMs <= 0.0)
+    {
+        return settings_.maxTimeoutMs;
+    }
+
+    const Host& entry = it->second;
+    double timeout = (entry.smoothedMs + 4 * entry.deviationMs) * (1 << entry.timeoutBackoff);
+    return std::clamp(static_cast<long>(timeout), settings_.minTimeoutMs, settings_.maxTimeoutMs);
+}
+
+int HostHealth::getOpenHosts() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return openHosts_;
+}
+
+long long HostHealth::getTrips() const
+{
+    return trips_;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef HOSTHEALTH_H
+#define HOSTHEALTH_H
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+
+// Состояние хостов для пути загрузки: автомат отключения (circuit breaker)
+// и адаптивный таймаут.
+//  - После failureThreshold сбоев подряд хост "размыкается": запросы к нему
+//    не выполняются openDuration (с удвоением при повторных отключениях).
+//    Затем пропускается один пробный запрос: успех замыкает цепь, сбой
+//    снова размыкает её.
+//  - Таймаут считается как в TCP (RFC 6298): сглаженная задержка плюс
+//    четыре её отклонения, в пределах [minTimeout, maxTimeout]. После
+//    таймаута он удваивается до следующего успешного ответа.
+//  - Crawl-delay из robots.txt: запросы к хосту идут не чаще одного
+//    за указанную задержку (не больше maxCrawlDelay).
+// Помнит не больше maxHosts хостов: при переполнении забываются
+// здоровые хосты без Crawl-delay, отключённые остаются.
+class HostHealth
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings
+    {
+        int failureThreshold = 5;
+        std::chrono::milliseconds openDuration{ 30000 };
+        std::chrono::milliseconds maxOpenDuration{ 600000 };
+        long minTimeoutMs = 2000;
+        long maxTimeoutMs = 30000;
+        std::chrono::milliseconds maxCrawlDelay{ 60000 };
+        size_t maxHosts = 100000;
+    };
+
+    explicit HostHealth(const Settings& settings);
+
+    // Можно ли обращаться к хосту сейчас. Если нет - в retryAt время,
+    // когда стоит попробовать снова. Получивший true обязан сообщить
+    // результат через recordSuccess/recordFailure
+    bool tryAcquire(const std::string& host, Clock::time_point& retryAt);
+
+    // Хост ответил (в том числе кодом 4xx) за latencyMs.
+    // Возвращает true, если это замкнуло разомкнутую цепь
+    bool recordSuccess(const std::string& host, double latencyMs);
+
+    // Сбой хоста: ошибка сети, таймаут, 5xx, 429
+    void recordFailure(const std::string& host, bool timeout);
+
+    // Задержка между запросами к хосту (Crawl-delay, секунды; 0 - без неё)
+    void setCrawlDelay(const std::string& host, double seconds);
+    std::chrono::milliseconds getCrawlDelay(const std::string& host) const;
+
+    // Таймаут загрузки для хоста
+    long timeoutMillis(const std::string& host) const;
+
+    // Хостов с разомкнутой цепью и общее число отключений
+    int getOpenHosts() const;
+    long long getTrips() const;
+
+private:
+    enum class State
+    {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    struct Host
+    {
+        State state = State::Closed;
+        int consecutiveFailures = 0;
+        int trips = 0;                  // отключений подряд (для удвоения)
+        Clock::time_point openUntil;
+        bool probeInFlight = false;
+
+        double smoothedMs = 0.0;        // сглаженная задержка
+        double deviationMs = 0.0;       // её среднее отклонение
+        int timeoutBackoff = 0;         // удвоений таймаута после таймаутов
+
+        std::chrono::milliseconds crawlDelay{ 0 };
+        Clock::time_point nextRequest;  // раньше этого времени запросов нет
+    };
+
+    const Settings settings_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Host> hosts_;
+    int openHosts_;
+    std::atomic<long long> trips_;
+
+    void open(Host& host, Clock::time_point now);
+
+    // Запись хоста; при переполнении сначала вытесняет часть записей
+    Host& entry(const std::string& host);
+};
+
+#endif // HOSTHEALTH_H
\ No newline at end of file
@@ -0,0 +1,809 @@
+#include "HtmlTokenizer.h"
+#include "TextScan.h"
+#include "WordTokenizer.h"
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace
+{
+    // Имена длиннее нас не интересуют (script, style, title, блочные теги)
+    constexpr size_t kMaxTagName = 8;
+
+    // Длиннее сущностей не бывает (самая длинная числовая - &#x10FFFF;)
+    constexpr size_t kMaxEntityLength = 32;
+
+    // Заголовок <h1> длиннее этого обрезается (байт UTF-8)
+    constexpr size_t kMaxHeading = 1024;
+
+    // Блочные теги: на них заканчивается незакрытый <h1>
+    constexpr std::string_view kBlockTags[] = {
+        "address", "article", "aside", "body", "dd", "div", "dl", "dt", "footer", "form",
+        "h1", "h2", "h3", "h4", "h5", "h6", "header", "hr", "li", "main", "nav", "ol",
+        "p", "pre", "section", "table", "td", "th", "tr", "ul" };
+
+    bool isBlockTag(std::string_view name)
+    {
+        return std::find(std::begin(kBlockTags), std::end(kBlockTags), name) != std::end(kBlockTags);
+    }
+
+    // Именованные сущности, которые встречаются в текстах на практике.
+    // Отсортированы для двоичного поиска (проверяется при компиляции)
+    constexpr std::array<std::pair<std::string_view, uint32_t>, 62> kEntities{ {
+        { "Aacute", 0xC1 }, { "Agrave", 0xC0 }, { "Auml", 0xC4 }, { "Ccedil", 0xC7 },
+        { "Eacute", 0xC9 }, { "Egrave", 0xC8 }, { "Ouml", 0xD6 }, { "Uuml", 0xDC },
+        { "aacute", 0xE1 }, { "acirc", 0xE2 }, { "agrave", 0xE0 }, { "amp", 0x26 },
+        { "apos", 0x27 }, { "auml", 0xE4 }, { "bdquo", 0x201E }, { "bull", 0x2022 },
+        { "ccedil", 0xE7 }, { "cent", 0xA2 }, { "copy", 0xA9 }, { "deg", 0xB0 },
+        { "divide", 0xF7 }, { "eacute", 0xE9 }, { "ecirc", 0xEA }, { "egrave", 0xE8 },
+        { "euml", 0xEB }, { "euro", 0x20AC }, { "gt", 0x3E }, { "hellip", 0x2026 },
+        { "iacute", 0xED }, { "laquo", 0xAB }, { "ldquo", 0x201C }, { "lsaquo", 0x2039 },
+        { "lsquo", 0x2018 }, { "lt", 0x3C }, { "mdash", 0x2014 }, { "middot", 0xB7 },
+        { "nbsp", 0xA0 }, { "ndash", 0x2013 }, { "ntilde", 0xF1 }, { "oacute", 0xF3 },
+        { "ouml", 0xF6 }, { "para", 0xB6 }, { "plusmn", 0xB1 }, { "pound", 0xA3 },
+        { "quot", 0x22 }, { "raquo", 0xBB }, { "rdquo", 0x201D }, { "reg", 0xAE },
+        { "rsaquo", 0x203A }, { "rsquo", 0x2019 }, { "sbquo", 0x201A }, { "sect", 0xA7 },
+        { "shy", 0xAD }, { "szlig", 0xDF }, { "thinsp", 0x2009 }, { "times", 0xD7 },
+        { "trade", 0x2122 }, { "uacute", 0xFA }, { "uuml", 0xFC }, { "yen", 0xA5 },
+        { "zwj", 0x200D }, { "zwnj", 0x200C }
+    } };
+
+    static_assert(std::is_sorted(kEntities.begin(), kEntities.end()), "kEntities должен быть отсортирован");
+
+    constexpr bool isAsciiAlpha(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    constexpr bool isAsciiAlnum(char c)
+    {
+        return isAsciiAlpha(c) || (c >= '0' && c <= '9');
+    }
+
+    constexpr char toLowerAscii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    constexpr bool isTagSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    // Символы, которые не разделяют слова и не попадают в текст:
+    // мягкий перенос, символы нулевой ширины, BOM
+    constexpr bool isIgnorable(uint32_t codepoint)
+    {
+        return codepoint == 0xAD || (codepoint >= 0x200B && codepoint <= 0x200D) || codepoint == 0xFEFF;
+    }
+
+    // Пробельные символы (для схлопывания пробелов в заголовке)
+    constexpr bool isSpace(uint32_t codepoint)
+    {
+        return codepoint == ' ' || (codepoint >= '\t' && codepoint <= '\r') || codepoint == 0xA0 ||
+            (codepoint >= 0x2000 && codepoint <= 0x200A) || codepoint == 0x3000;
+    }
+
+    // Сравнение с lower (в нижнем регистре) без учёта регистра ASCII
+    bool equalsIgnoreCase(std::string_view value, std::string_view lower)
+    {
+        if (value.size() != lower.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            if (toLowerAscii(value[i]) != lower[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Есть ли token среди слов value, разделённых пробелами или запятыми
+    // (rel="noopener nofollow", content="noindex, follow")
+    bool containsToken(std::string_view value, std::string_view token)
+    {
+        size_t pos = 0;
+        while (pos < value.size())
+        {
+            while (pos < value.size() && (isTagSpace(value[pos]) || value[pos] == ','))
+            {
+                pos++;
+            }
+            size_t start = pos;
+            while (pos < value.size() && !isTagSpace(value[pos]) && value[pos] != ',')
+            {
+                pos++;
+            }
+            if (pos > start && equalsIgnoreCase(value.substr(start, pos - start), token))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Пары (имя, значение) атрибутов тега - текст между именем тега и '>'.
+    // Атрибуты без значения пропускаются
+    template <typename Handler>
+    void forEachAttribute(std::string_view attributes, Handler&& handler)
+    {
+        const size_t size = attributes.size();
+        size_t pos = 0;
+        while (pos < size)
+        {
+            while (pos < size && (isTagSpace(attributes[pos]) || attributes[pos] == '/'))
+            {
+                pos++;
+            }
+
+            size_t nameStart = pos;
+            while (pos < size && !isTagSpace(attributes[pos]) && attributes[pos] != '=' && attributes[pos] != '/')
+            {
+                pos++;
+            }
+            std::string_view name = attributes.substr(nameStart, pos - nameStart);
+
+            while (pos < size && isTagSpace(attributes[pos]))
+            {
+                pos++;
+            }
+            if (pos >= size || attributes[pos] != '=')
+            {
+                continue;
+            }
+            pos++;
+            while (pos < size && isTagSpace(attributes[pos]))
+            {
+                pos++;
+            }
+            if (pos >= size)
+            {
+                break;
+            }
+
+            // Значение в кавычках может содержать '>' и пробелы
+            std::string_view value;
+            char quote = attributes[pos];
+            if (quote == '"' || quote == '\'')
+            {
+                size_t end = std::min(attributes.find(quote, pos + 1), size);
+                value = attributes.substr(pos + 1, end - pos - 1);
+                pos = end + 1;
+            }
+            else
+            {
+                size_t valueStart = pos;
+                while (pos < size && !isTagSpace(attributes[pos]))
+                {
+                    pos++;
+                }
+                value = attributes.substr(valueStart, pos - valueStart);
+            }
+
+            handler(name, value);
+        }
+    }
+
+    // Конец содержимого тега name (позиция "</name"), без учёта регистра
+    size_t findClosingTag(std::string_view html, size_t pos, std::string_view name)
+    {
+        while ((pos = TextScan::findByte(html, pos, '<')) != std::string_view::npos)
+        {
+            if (pos + 1 >= html.size() || html[pos + 1] != '/')
+            {
+                pos++;
+                continue;
+            }
+
+            size_t nameStart = pos + 2;
+            size_t nameEnd = nameStart + name.size();
+            if (nameEnd <= html.size())
+            {
+                bool match = true;
+                for (size_t i = 0; i < name.size(); ++i)
+                {
+                    if (toLowerAscii(html[nameStart + i]) != name[i])
+                    {
+                        match = false;
+                        break;
+                    }
+                }
+                if (match && (nameEnd == html.size() || !isAsciiAlnum(html[nameEnd])))
+                {
+                    return pos;
+                }
+            }
+            pos += 2;
+        }
+        return html.size();
+    }
+}
+
+uint32_t HtmlTokenizer::lookupEntity(std::string_view name)
+{
+    auto find = [](std::string_view key) -> uint32_t {
+        auto it = std::lower_bound(kEntities.begin(), kEntities.end(), key,
+            [](const auto& entry, std::string_view value) { return entry.first < value; });
+        return (it != kEntities.end() && it->first == key) ? it->second : 0;
+    };
+
+    uint32_t codepoint = find(name);
+    if (codepoint != 0 || name.size() > kMaxEntityLength)
+    {
+        return codepoint;
+    }
+
+    // &NBSP; и подобные: браузеры их не понимают, но на страницах они встречаются
+    char lower[kMaxEntityLength];
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        lower[i] = toLowerAscii(name[i]);
+    }
+    return find(std::string_view(lower, name.size()));
+}
+
+size_t HtmlTokenizer::encodeUtf8(uint32_t codepoint, char* out)
+{
+    if (codepoint < 0x80)
+    {
+        out[0] = static_cast<char>(codepoint);
+        return 1;
+    }
+    if (codepoint < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    if (codepoint < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+    out[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+void HtmlTokenizer::parse(std::string_view html)
+{
+    text_.clear();
+    title_.clear();
+    heading_.clear();
+    links_.clear();
+    baseHref_ = {};
+    noIndex_ = false;
+    noFollow_ = false;
+    textSpace_ = false;
+    captureSpace_ = false;
+    capture_ = nullptr;
+
+    // Текст обычно короче разметки
+    text_.reserve(html.size() / 2);
+
+    size_t pos = 0;
+    while (pos < html.size())
+    {
+        // Вне заголовков текст разбирается блоками: классы байт блока
+        // находятся векторными сравнениями, серии слов и разделителей
+        // копируются или пропускаются целиком. Разметка и прочие символы
+        // вне ASCII разбираются ниже по одному
+        if (!capture_ && html.size() - pos >= TextScan::kBlockSize)
+        {
+            size_t consumed = scanBlock(html.data() + pos);
+            pos += consumed;
+            if (consumed == TextScan::kBlockSize)
+            {
+                continue;
+            }
+        }
+
+        char c = html[pos];
+        if (c == '<')
+        {
+            pos = parseMarkup(html, pos);
+        }
+        else if (c == '&')
+        {
+            pos = emitEntity(html, pos);
+        }
+        else
+        {
+            pos = emitChar(html, pos);
+        }
+    }
+}
+
+const std::string& HtmlTokenizer::getText() const
+{
+    return text_;
+}
+
+const std::string& HtmlTokenizer::getTitle() const
+{
+    return title_;
+}
+
+const std::string& HtmlTokenizer::getHeading() const
+{
+    return heading_;
+}
+
+const std::vector<std::string_view>& HtmlTokenizer::getLinks() const
+{
+    return links_;
+}
+
+std::string_view HtmlTokenizer::getBaseHref() const
+{
+    return baseHref_;
+}
+
+bool HtmlTokenizer::isNoIndex() const
+{
+    return noIndex_;
+}
+
+bool HtmlTokenizer::isNoFollow() const
+{
+    return noFollow_;
+}
+
+size_t HtmlTokenizer::scanBlock(const char* data)
+{
+    TextScan::Block block = TextScan::classify(data);
+    size_t i = 0;
+    while (i < TextScan::kBlockSize)
+    {
+        uint64_t bit = uint64_t{ 1 } << i;
+        if (block.special & bit)
+        {
+            return i;
+        }
+
+        // Биты с позиции i и дальше. Нет нужного бита - серия до конца блока
+        uint64_t ahead = ~uint64_t{ 0 } << i;
+        if (block.word & bit)
+        {
+            size_t end = static_cast<size_t>(std::countr_zero(~block.word & ahead));
+            if (textSpace_ && !text_.empty())
+            {
+                text_.push_back(' ');
+            }
+            textSpace_ = false;
+            text_.append(data + i, end - i);
+            i = end;
+        }
+        else
+        {
+            textSpace_ = true;
+            i = static_cast<size_t>(std::countr_zero((block.word | block.special) & ahead));
+        }
+    }
+    return i;
+}
+
+void HtmlTokenizer::emit(const char* bytes, size_t len, uint32_t codepoint)
+{
+    if (isIgnorable(codepoint))
+    {
+        return;
+    }
+
+    if (capture_)
+    {
+        if (isSpace(codepoint))
+        {
+            captureSpace_ = true;
+        }
+        else
+        {
+            if (captureSpace_ && !capture_->empty())
+            {
+                capture_->push_back(' ');
+            }
+            captureSpace_ = false;
+            capture_->append(bytes, len);
+
+            if (capture_ == &heading_ && heading_.size() >= kMaxHeading)
+            {
+                capture_ = nullptr;
+            }
+        }
+    }
+
+    if (WordTokenizer::isWordCodepoint(codepoint))
+    {
+        if (textSpace_ && !text_.empty())
+        {
+            text_.push_back(' ');
+        }
+        textSpace_ = false;
+        text_.append(bytes, len);
+    }
+    else
+    {
+        textSpace_ = true;
+    }
+}
+
+void HtmlTokenizer::separate()
+{
+    textSpace_ = true;
+    captureSpace_ = true;
+}
+
+void HtmlTokenizer::emitRange(std::string_view html, size_t pos, size_t end)
+{
+    std::string_view range = html.substr(0, end);
+    while (pos < range.size())
+    {
+        pos = range[pos] == '&' ? emitEntity(range, pos) : emitChar(range, pos);
+    }
+}
+
+size_t HtmlTokenizer::emitEntity(std::string_view html, size_t pos)
+{
+    uint32_t codepoint;
+    size_t length = decodeEntity(html, pos, codepoint);
+
+    // Не сущность: '&' остаётся обычным символом
+    if (length == 0)
+    {
+        emit("&", 1, '&');
+        return pos + 1;
+    }
+
+    char bytes[4];
+    emit(bytes, encodeUtf8(codepoint, bytes), codepoint);
+    return pos + length;
+}
+
+size_t HtmlTokenizer::decodeEntity(std::string_view text, size_t pos, uint32_t& codepoint)
+{
+    // Ищем ';' в пределах максимальной длины сущности
+    size_t limit = std::min(text.size(), pos + kMaxEntityLength);
+    size_t semicolon = pos + 1;
+    while (semicolon < limit && (isAsciiAlnum(text[semicolon]) || text[semicolon] == '#'))
+    {
+        semicolon++;
+    }
+
+    if (semicolon >= limit || text[semicolon] != ';' || semicolon == pos + 1)
+    {
+        return 0;
+    }
+
+    std::string_view name = text.substr(pos + 1, semicolon - pos - 1);
+    codepoint = 0;
+    if (name[0] == '#')
+    {
+        bool hex = name.size() > 1 && (name[1] == 'x' || name[1] == 'X');
+        size_t i = hex ? 2 : 1;
+        if (i >= name.size())
+        {
+            return 0;
+        }
+
+        for (; i < name.size(); ++i)
+        {
+            char c = name[i];
+            uint32_t digit;
+            if (c >= '0' && c <= '9')
+            {
+                digit = static_cast<uint32_t>(c - '0');
+            }
+            else if (hex && toLowerAscii(c) >= 'a' && toLowerAscii(c) <= 'f')
+            {
+                digit = static_cast<uint32_t>(toLowerAscii(c) - 'a' + 10);
+            }
+            else
+            {
+                return 0;
+            }
+
+            // Переполнение не важно: всё больше 0x10FFFF заменяется ниже
+            codepoint = std::min<uint32_t>(codepoint * (hex ? 16 : 10) + digit, 0x110000);
+        }
+
+        if (codepoint == 0 || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF))
+        {
+            codepoint = 0xFFFD;
+        }
+    }
+    else
+    {
+        codepoint = lookupEntity(name);
+        if (codepoint == 0)
+        {
+            return 0;
+        }
+    }
+
+    return semicolon + 1 - pos;
+}
+
+size_t HtmlTokenizer::emitChar(std::string_view html, size_t pos)
+{
+    unsigned char lead = static_cast<unsigned char>(html[pos]);
+    if (lead < 0x80)
+    {
+        emit(&html[pos], 1, lead);
+        return pos + 1;
+    }
+
+    // Длина последовательности UTF-8 по первому байту
+    size_t len;
+    uint32_t codepoint;
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        len = 2;
+        codepoint = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        len = 3;
+        codepoint = lead & 0x0F;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        len = 4;
+        codepoint = lead & 0x07;
+    }
+    else
+    {
+        // Некорректный байт разделяет слова
+        separate();
+        return pos + 1;
+    }
+
+    if (pos + len > html.size())
+    {
+        separate();
+        return html.size();
+    }
+
+    for (size_t i = 1; i < len; ++i)
+    {
+        unsigned char next = static_cast<unsigned char>(html[pos + i]);
+        if ((next & 0xC0) != 0x80)
+        {
+            separate();
+            return pos + 1;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+
+    // Избыточная запись и суррогаты - тоже ошибка кодировки
+    if ((len == 3 && (codepoint < 0x800 || (codepoint >= 0xD800 && codepoint <= 0xDFFF))) ||
+        (len == 4 && (codepoint < 0x10000 || codepoint > 0x10FFFF)))
+    {
+        separate();
+        return pos + len;
+    }
+
+    emit(&html[pos], len, codepoint);
+    return pos + len;
+}
+
+size_t HtmlTokenizer::parseMarkup(std::string_view html, size_t pos)
+{
+    const size_t size = html.size();
+    size_t p = pos + 1;
+    if (p >= size)
+    {
+        separate();
+        return size;
+    }
+
+    // Комментарий, <!DOCTYPE ...>, <![CDATA[...]]>, <?xml ...?>
+    if (html[p] == '!' || html[p] == '?')
+    {
+        separate();
+        if (html.compare(p, 3, "!--") == 0)
+        {
+            // Конец комментария - "-->": ищем '>' и проверяем два байта перед ним
+            size_t end = p + 3;
+            while ((end = TextScan::findByte(html, end, '>')) != std::string_view::npos)
+            {
+                if (end >= p + 5 && html[end - 1] == '-' && html[end - 2] == '-')
+                {
+                    return end + 1;
+                }
+                end++;
+            }
+            return size;
+        }
+        size_t end = TextScan::findByte(html, p, '>');
+        return end == std::string_view::npos ? size : end + 1;
+    }
+
+    bool closing = html[p] == '/';
+    if (closing)
+    {
+        p++;
+    }
+
+    // После '<' нет имени тега - это обычный символ ("a < b")
+    if (p >= size || !isAsciiAlpha(html[p]))
+    {
+        emit(&html[pos], 1, '<');
+        return pos + 1;
+    }
+
+    // Имя тега в нижнем регистре. Нас интересуют только короткие имена
+    char nameBuffer[kMaxTagName];
+    size_t nameLength = 0;
+    while (p < size && isAsciiAlnum(html[p]))
+    {
+        if (nameLength < kMaxTagName)
+        {
+            nameBuffer[nameLength] = toLowerAscii(html[p]);
+        }
+        nameLength++;
+        p++;
+    }
+    std::string_view name = nameLength <= kMaxTagName ? std::string_view(nameBuffer, nameLength) : std::string_view();
+    size_t nameEnd = p;
+
+    // Конец тега - '>' вне кавычек. Кавычка открывает значение
+    // атрибута, только если перед ней (не считая пробелов) стоит '='
+    while (p < size)
+    {
+        p += TextScan::findAny(html.data() + p, size - p, '>', '"', '\'');
+        if (p >= size || html[p] == '>')
+        {
+            break;
+        }
+
+        size_t before = p;
+        while (isTagSpace(html[before - 1]))
+        {
+            before--;
+        }
+        if (html[before - 1] != '=')
+        {
+            p++;
+            continue;
+        }
+
+        size_t closingQuote = TextScan::findByte(html, p + 1, html[p]);
+        p = closingQuote == std::string_view::npos ? size : closingQuote + 1;
+    }
+
+    // Незакрытый тег в конце документа
+    if (p >= size)
+    {
+        separate();
+        return size;
+    }
+
+    size_t tagEnd = p + 1;
+    separate();
+
+    // Заголовок кончается на </h1> или на любом блочном теге: незакрытый
+    // <h1> не должен захватить остаток документа
+    if (capture_ == &heading_ && isBlockTag(name))
+    {
+        capture_ = nullptr;
+    }
+
+    if (closing)
+    {
+        return tagEnd;
+    }
+
+    // Ссылки и указания роботам - из атрибутов уже найденного тега
+    if (name == "a" || name == "area" || name == "base" || name == "meta")
+    {
+        parseAttributes(name, html.substr(nameEnd, p - nameEnd));
+    }
+
+    // Код и стили пропускаем целиком, до закрывающего тега
+    if (name == "script" || name == "style")
+    {
+        return findClosingTag(html, tagEnd, name);
+    }
+
+    // Содержимое <title> - текст без тегов (RCDATA): разбираем его
+    // отдельно, попутно сохраняя заголовок
+    if (name == "title")
+    {
+        size_t end = findClosingTag(html, tagEnd, name);
+        std::string* saved = capture_;
+        if (title_.empty())
+        {
+            capture_ = &title_;
+            captureSpace_ = false;
+        }
+        emitRange(html, tagEnd, end);
+        capture_ = saved;
+        separate();
+        return end;
+    }
+
+    if (name == "h1" && heading_.empty() && !capture_)
+    {
+        capture_ = &heading_;
+        captureSpace_ = false;
+    }
+
+    return tagEnd;
+}
+
+void HtmlTokenizer::parseAttributes(std::string_view name, std::string_view attributes)
+{
+    // Повторный атрибут браузер игнорирует - и мы тоже
+    std::string_view href;
+    std::string_view rel;
+    std::string_view metaName;
+    std::string_view content;
+    bool hasHref = false;
+    bool hasRel = false;
+    bool hasMetaName = false;
+    bool hasContent = false;
+    auto keepFirst = [](std::string_view& slot, bool& seen, std::string_view value) {
+        if (!seen)
+        {
+            slot = value;
+            seen = true;
+        }
+    };
+
+    forEachAttribute(attributes, [&](std::string_view attribute, std::string_view value) {
+        if (equalsIgnoreCase(attribute, "href"))
+        {
+            keepFirst(href, hasHref, value);
+        }
+        else if (equalsIgnoreCase(attribute, "rel"))
+        {
+            keepFirst(rel, hasRel, value);
+        }
+        else if (equalsIgnoreCase(attribute, "name"))
+        {
+            keepFirst(metaName, hasMetaName, value);
+        }
+        else if (equalsIgnoreCase(attribute, "content"))
+        {
+            keepFirst(content, hasContent, value);
+        }
+    });
+
+    if (name == "meta")
+    {
+        if (equalsIgnoreCase(metaName, "robots"))
+        {
+            bool none = containsToken(content, "none");
+            noIndex_ = noIndex_ || none || containsToken(content, "noindex");
+            noFollow_ = noFollow_ || none || containsToken(content, "nofollow");
+        }
+        return;
+    }
+
+    if (href.empty())
+    {
+        return;
+    }
+
+    if (name == "base")
+    {
+        if (baseHref_.empty())
+        {
+            baseHref_ = href;
+        }
+        return;
+    }
+
+    if (!containsToken(rel, "nofollow"))
+    {
+        links_.push_back(href);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef HTMLTOKENIZER_H
+#define HTMLTOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Разбор HTML в текст за один проход (конечный автомат).
+// За линейное время и без регулярных выражений (текст между тегами
+// просматривается блоками векторных сравнений, см. TextScan):
+//  - пропускает содержимое script и style, комментарии, <!DOCTYPE> и <?...?>;
+//  - заменяет теги пробелами;
+//  - декодирует сущности (именованные и числовые &#...; / &#x...;);
+//  - оставляет в тексте только слова (буквы, цифры, '_') через один пробел;
+//  - попутно собирает текст <title> и первого <h1>;
+//  - собирает ссылки <a>/<area> (кроме rel="nofollow"), <base href> и
+//    указания <meta name="robots"> - отдельный проход за ссылками не нужен.
+//
+// Буферы результата переиспользуются между вызовами parse(), поэтому
+// один объект на поток почти не выделяет память на каждой странице.
+// Объект не потокобезопасен.
+class HtmlTokenizer
+{
+public:
+    HtmlTokenizer() = default;
+
+    // Разбор страницы. Результат действителен до следующего вызова
+    void parse(std::string_view html);
+
+    // Слова страницы через один пробел
+    const std::string& getText() const;
+
+    // Текст <title> и первого <h1> (пробелы схлопнуты, знаки препинания сохранены)
+    const std::string& getTitle() const;
+    const std::string& getHeading() const;
+
+    // Значения href ссылок как есть, в порядке появления, без повторного
+    // href в одном теге (без разрешения и декодирования сущностей).
+    // Строки указывают в html - действительны, пока жив html
+    const std::vector<std::string_view>& getLinks() const;
+
+    // href первого <base> (пусто - нет)
+    std::string_view getBaseHref() const;
+
+    // <meta name="robots" content="noindex/nofollow/none">
+    bool isNoIndex() const;
+    bool isNoFollow() const;
+
+    // Кодовая точка именованной сущности (name - без '&' и ';'), 0 - неизвестна
+    static uint32_t lookupEntity(std::string_view name);
+
+    // Сущность (&amp;, &#38;, &#x26;) с '&' в позиции pos: кодовая точка
+    // в codepoint, возвращает длину записи вместе с ';' (0 - не сущность)
+    static size_t decodeEntity(std::string_view text, size_t pos, uint32_t& codepoint);
+
+    // Запись кодовой точки в UTF-8, возвращает число байт (1..4)
+    static size_t encodeUtf8(uint32_t codepoint, char* out);
+
+private:
+    std::string text_;
+    std::string title_;
+    std::string heading_;
+    std::vector<std::string_view> links_;
+    std::string_view baseHref_;
+    bool noIndex_ = false;
+    bool noFollow_ = false;
+
+    // Между словами текста / собираемого заголовка нужен пробел
+    bool textSpace_ = false;
+    bool captureSpace_ = false;
+
+    // Куда собирается заголовок (nullptr - никуда)
+    std::string* capture_ = nullptr;
+
+    // Блок TextScan::kBlockSize байт с data вне заголовка: слова и
+    // разделители ASCII. Возвращает число разобранных байт - до первого
+    // байта, который нужно разобрать по одному, или весь блок
+    size_t scanBlock(const char* data);
+
+    // Один символ текста: len байт UTF-8 с кодовой точкой codepoint
+    void emit(const char* bytes, size_t len, uint32_t codepoint);
+
+    // Граница слова (тег, пробел, знак препинания)
+    void separate();
+
+    // Текст от pos до end без разбора тегов (содержимое <title>)
+    void emitRange(std::string_view html, size_t pos, size_t end);
+
+    // Сущность, начинающаяся с '&' в позиции pos. Возвращает позицию за ней
+    size_t emitEntity(std::string_view html, size_t pos);
+
+    // Символ UTF-8 или байт ASCII в позиции pos. Возвращает позицию за ним
+    size_t emitChar(std::string_view html, size_t pos);
+
+    // Атрибуты открывающего тега name, нужные для ссылок и <meta robots>
+    void parseAttributes(std::string_view name, std::string_view attributes);
+
+    // Тег, комментарий или объявление в позиции pos ('<').
+    // Возвращает позицию, с которой продолжать разбор
+    size_t parseMarkup(std::string_view html, size_t pos);
+};
+
+#endif // HTMLTOKENIZER_H
\ No newline at end of file
@@ -1,262 +1,233 @@
 #include "Indexer.h"
-#include <regex>
+#include "HtmlTokenizer.h"
+#include "TextScan.h"
+#include "WordTokenizer.h"
+#include "BumpArena.h"
+#include "TermCounter.h"
+#include "SnippetBuilder.h"
 #include <algorithm>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <exception>
 #include <iostream>
-#include <locale>
-#include <cctype>
-#include <unordered_map>
-#include <sstream>
+#include <bit>
+#include <cstring>
 
-std::string Indexer::cleanHtml(const std::string& html)
+namespace
 {
-    std::string result = html;
-
-    try
-    {
-        // Удаляем содержимое script и style тегов
-        // Без dotall флага, используем более простое регулярное выражение
-        std::regex scriptRegex(R"(<script\b[^>]*>.*?</script>)", std::regex::icase);
-        result = std::regex_replace(result, scriptRegex, " ");
-
-        std::regex styleRegex(R"(<style\b[^>]*>.*?</style>)", std::regex::icase);
-        result = std::regex_replace(result, styleRegex, " ");
-
-        // Заменяем HTML-сущности
-        std::regex nbspRegex("&nbsp;", std::regex::icase);
-        result = std::regex_replace(result, nbspRegex, " ");
-
-        std::regex ampRegex("&amp;", std::regex::icase);
-        result = std::regex_replace(result, ampRegex, "&");
-
-        std::regex ltRegex("&lt;", std::regex::icase);
-        result = std::regex_replace(result, ltRegex, "<");
-
-        std::regex gtRegex("&gt;", std::regex::icase);
-        result = std::regex_replace(result, gtRegex, ">");
-
-        std::regex quotRegex("&quot;", std::regex::icase);
-        result = std::regex_replace(result, quotRegex, "\"");
-
-        // Удаляем HTML теги
-        std::regex tagRegex("<[^>]*>");
-        result = std::regex_replace(result, tagRegex, " ");
-
-        // Заменяем спецсимволы на пробелы
-        std::regex specialRegex("[\\t\\n\\r]+");
-        result = std::regex_replace(result, specialRegex, " ");
-
-        // Удаляем лишние знаки препинания (оставляем только буквы, цифры и пробелы)
-        std::regex punctRegex("[^\\w\\sа-яА-ЯёЁ]");
-        result = std::regex_replace(result, punctRegex, " ");
-
-        // Удаляем множественные пробелы
-        std::regex spaceRegex("\\s+");
-        result = std::regex_replace(result, spaceRegex, " ");
-
-        // Обрезаем пробелы в начале и конце
-        result.erase(0, result.find_first_not_of(" \t\n\r"));
-        result.erase(result.find_last_not_of(" \t\n\r") + 1);
-
-        return result;
-    }
-    catch (const std::exception& e)
+    constexpr bool isAsciiSpace(char c)
     {
-        std::cerr << "Ошибка при очистке HTML: " << e.what() << std::endl;
-        return result;
+        return c == ' ' || (c >= '\t' && c <= '\r');
     }
-}
 
-std::string Indexer::extractTitle(const std::string& html)
-{
-    try
+    // Вызывает handler(begin, length) для каждой последовательности байт
+    // без пробельных символов. Пробелы ищутся блоками по маске TextScan.
+    // Слова передаются изменяемыми - обработчик может сократить слово на месте
+    template <typename Handler>
+    void forEachToken(char* data, size_t size, Handler&& handler)
     {
-        // Ищем тег <title> - без dotall
-        size_t titleStart = html.find("<title");
-        if (titleStart != std::string::npos)
+        size_t tokenStart = 0;
+        bool inToken = false;
+
+        size_t pos = 0;
+        while (pos < size)
         {
-            titleStart = html.find('>', titleStart);
-            if (titleStart != std::string::npos)
+            size_t width = std::min(size - pos, TextScan::kBlockSize);
+            uint64_t spaces = 0;
+            if (width == TextScan::kBlockSize)
+            {
+                spaces = TextScan::classify(data + pos).space;
+            }
+            else
             {
-                size_t titleEnd = html.find("</title>", titleStart);
-                if (titleEnd != std::string::npos)
+                for (size_t i = 0; i < width; ++i)
                 {
-                    std::string title = html.substr(titleStart + 1, titleEnd - titleStart - 1);
-
-                    // Очищаем заголовок от HTML тегов
-                    std::regex tagRegex("<[^>]*>");
-                    title = std::regex_replace(title, tagRegex, " ");
-
-                    // Удаляем лишние пробелы
-                    std::regex spaceRegex("\\s+");
-                    title = std::regex_replace(title, spaceRegex, " ");
-
-                    // Обрезаем пробелы
-                    title.erase(0, title.find_first_not_of(" \t\n\r"));
-                    title.erase(title.find_last_not_of(" \t\n\r") + 1);
+                    spaces |= isAsciiSpace(data[pos + i]) ? uint64_t{ 1 } << i : 0;
+                }
+            }
 
-                    if (!title.empty())
+            // Переходы между словами и пробелами внутри блока
+            size_t i = 0;
+            while (i < width)
+            {
+                uint64_t ahead = ~uint64_t{ 0 } << i;
+                uint64_t stops = inToken ? spaces : ~spaces;
+                i = std::min(width, static_cast<size_t>(std::countr_zero(stops & ahead)));
+                if (i < width)
+                {
+                    if (inToken)
+                    {
+                        handler(data + tokenStart, pos + i - tokenStart);
+                    }
+                    else
                     {
-                        return title;
+                        tokenStart = pos + i;
                     }
+                    inToken = !inToken;
                 }
             }
+            pos += width;
         }
 
-        // Если title не найден, ищем h1
-        size_t h1Start = html.find("<h1");
-        if (h1Start != std::string::npos)
+        if (inToken)
         {
-            h1Start = html.find('>', h1Start);
-            if (h1Start != std::string::npos)
-            {
-                size_t h1End = html.find("</h1>", h1Start);
-                if (h1End != std::string::npos)
-                {
-                    std::string h1 = html.substr(h1Start + 1, h1End - h1Start - 1);
+            handler(data + tokenStart, size - tokenStart);
+        }
+    }
+}
 
-                    std::regex tagRegex("<[^>]*>");
-                    h1 = std::regex_replace(h1, tagRegex, " ");
+Indexer::Indexer(const Stemmer& stemmer, const StopWords& stopWords)
+    : stemmer_(stemmer)
+    , stopWords_(stopWords)
+{
+}
 
-                    std::regex spaceRegex("\\s+");
-                    h1 = std::regex_replace(h1, spaceRegex, " ");
+TermList Indexer::countWords(std::string_view text)
+{
+    TermList result;
 
-                    h1.erase(0, h1.find_first_not_of(" \t\n\r"));
-                    h1.erase(h1.find_last_not_of(" \t\n\r") + 1);
+    if (text.empty())
+    {
+        return result;
+    }
 
-                    if (!h1.empty())
-                    {
-                        return h1;
-                    }
-                }
+    try
+    {
+        // Рабочая память потока: индексация идёт в нескольких потоках,
+        // а арена и таблица переиспользуются от страницы к странице
+        thread_local BumpArena arena;
+        thread_local TermCounter counter;
+        arena.reset();
+        counter.clear();
+
+        // Свёрнутая копия текста живёт в арене, слова - её срезы без копирования
+        char* folded = arena.allocate(text.size());
+        std::memcpy(folded, text.data(), text.size());
+        size_t foldedSize = WordTokenizer::foldCase(folded, text.size());
+
+        // Разбиваем текст на слова, фильтруем короткие/длинные, без букв
+        // и стоп-слова. Основа слова записывается на место самого слова в арене.
+        // Позиция - номер слова среди всех слов текста, включая отброшенные:
+        // так расстояния между словами совпадают с расстояниями в запросе
+        uint32_t position = 0;
+        forEachToken(folded, foldedSize, [&](char* begin, size_t length) {
+            std::string_view word(begin, length);
+            if (WordTokenizer::isIndexable(word) && !stopWords_.contains(word))
+            {
+                counter.add(std::string_view(begin, stemmer_.stem(begin, length)), position);
             }
-        }
+            position++;
+        });
 
-        return "Без заголовка";
+        // Порядок слов никому не нужен - без сортировки. Позиции слова
+        // уже по возрастанию
+        counter.extract(result);
+        return result;
     }
     catch (const std::exception& e)
     {
-        std::cerr << "Ошибка при извлечении заголовка: " << e.what() << std::endl;
-        return "Без заголовка";
+        std::cerr << "Ошибка при подсчёте слов: " << e.what() << std::endl;
+        return result;
     }
 }
 
-std::string Indexer::normalizeWord(const std::string& word)
+std::vector<std::string> Indexer::resolveLinks(const HtmlTokenizer& tokenizer, std::string_view url,
+    const UrlNormalizer& normalizer)
 {
-    if (word.empty())
+    std::vector<std::string> links;
+    const auto& targets = tokenizer.getLinks();
+    if (targets.empty())
     {
-        return "";
+        return links;
     }
 
-    std::string normalized;
-    normalized.reserve(word.size());
-
-    // Приводим к нижнему регистру
-    for (char c : word)
+    // Относительные ссылки разрешаются от <base href>, если он есть
+    std::string baseUrl(url);
+    if (!tokenizer.getBaseHref().empty())
     {
-        // Для русских букв
-        if (c >= 'А' && c <= 'Я')
-        {
-            normalized.push_back(c + 32); // 'а' - 'А' = 32
-        }
-        else if (c == 'Ё')
+        std::string resolvedBase = normalizer.resolve(url, tokenizer.getBaseHref());
+        if (!resolvedBase.empty())
         {
-            normalized.push_back('ё');
-        }
-        // Для английских букв
-        else if (c >= 'A' && c <= 'Z')
-        {
-            normalized.push_back(c + 32); // 'a' - 'A' = 32
-        }
-        else
-        {
-            normalized.push_back(std::tolower(static_cast<unsigned char>(c)));
+            baseUrl = std::move(resolvedBase);
         }
     }
 
-    return normalized;
-}
-
-std::vector<std::pair<std::string, int>> Indexer::countWords(const std::string& text)
-{
-    std::vector<std::pair<std::string, int>> result;
+    // Повторы отсеиваются по хешу. Строки в links не перемещаются
+    // (место зарезервировано), поэтому множество хранит срезы на них
+    thread_local std::unordered_set<std::string_view> seen;
+    seen.clear();
+    links.reserve(targets.size());
 
-    if (text.empty())
+    std::string link;
+    for (std::string_view target : targets)
     {
-        return result;
-    }
-
-    try
-    {
-        // Временный map для подсчета
-        std::unordered_map<std::string, int> wordCount;
-
-        // Разбиваем текст на слова
-        std::istringstream stream(text);
-        std::string word;
-
-        while (stream >> word)
+        // Сущности в атрибуте декодируются, как в тексте: '&' обычно
+        // записан как &amp;, но встречаются и &#38;, &#x2F; и т. п.
+        size_t ampPos = target.find('&');
+        link.assign(target.substr(0, ampPos));
+        for (size_t pos = link.size(); pos < target.size();)
         {
-            // Нормализуем слово
-            std::string normalized = normalizeWord(word);
-
-            // Фильтруем короткие/длинные слова и слова только из цифр
-            if (normalized.length() >= 3 && normalized.length() <= 32)
+            uint32_t codepoint;
+            size_t length = target[pos] == '&' ? HtmlTokenizer::decodeEntity(target, pos, codepoint) : 0;
+            if (length == 0)
             {
-                // Проверяем, что слово содержит хотя бы одну букву
-                bool hasLetter = false;
-                for (char c : normalized)
-                {
-                    if (std::isalpha(static_cast<unsigned char>(c)))
-                    {
-                        hasLetter = true;
-                        break;
-                    }
-                }
-
-                if (hasLetter)
-                {
-                    wordCount[normalized]++;
-                }
+                link.push_back(target[pos++]);
+                continue;
             }
+
+            char bytes[4];
+            link.append(bytes, HtmlTokenizer::encodeUtf8(codepoint, bytes));
+            pos += length;
         }
 
-        // Преобразуем map в vector
-        result.reserve(wordCount.size());
-        for (const auto& [word, count] : wordCount)
+        // Разрешаем относительную ссылку и приводим к канонической форме.
+        // Якоря, javascript:, mailto: и tel: отбрасываются здесь же
+        std::string normalized = normalizer.resolve(baseUrl, link);
+        if (normalized.empty() || seen.count(normalized))
         {
-            result.emplace_back(word, count);
+            continue;
         }
 
-        // Сортируем по частоте (по убыванию)
-        std::sort(result.begin(), result.end(),
-            [](const auto& a, const auto& b) {
-                return a.second > b.second;
-            });
-
-        return result;
-    }
-    catch (const std::exception& e)
-    {
-        std::cerr << "Ошибка при подсчёте слов: " << e.what() << std::endl;
-        return result;
+        links.push_back(std::move(normalized));
+        seen.insert(links.back());
     }
+
+    seen.clear();
+    return links;
 }
 
-Indexer::IndexingResult Indexer::indexPage(const std::string& html, const std::string& url)
+Indexer::IndexingResult Indexer::indexPage(const std::string& html, const std::string& url,
+    const UrlNormalizer* normalizer)
+{
+    return indexDocument(html, url, normalizer, true);
+}
+
+Indexer::IndexingResult Indexer::indexDocument(std::string_view html, std::string_view url,
+    const UrlNormalizer* normalizer, bool verbose)
 {
     IndexingResult result;
 
     try
     {
-        std::cout << "⌛ Индексация страницы: " << url << std::endl;
+        if (verbose)
+        {
+            std::cout << "⌛ Индексация страницы: " << url << std::endl;
+        }
+
+        // Разбираем HTML за один проход. Буферы разборщика живут в потоке
+        // и переиспользуются: индексация идёт в нескольких потоках
+        thread_local HtmlTokenizer tokenizer;
+        tokenizer.parse(html);
 
-        // Извлекаем заголовок
-        result.title = extractTitle(html);
-        if (result.title == "Без заголовка")
+        // Заголовок: <title>, иначе первый <h1>, иначе часть URL
+        result.title = !tokenizer.getTitle().empty() ? tokenizer.getTitle() : tokenizer.getHeading();
+        if (result.title.empty())
         {
             // Используем часть URL как заголовок
             size_t lastSlash = url.find_last_of('/');
-            if (lastSlash != std::string::npos && lastSlash < url.length() - 1)
+            if (lastSlash != std::string_view::npos && lastSlash < url.length() - 1)
             {
                 result.title = url.substr(lastSlash + 1);
 
@@ -273,22 +244,119 @@ Indexer::IndexingResult Indexer::indexPage(const std::string& html, const std::s
             }
         }
 
-        // Очищаем HTML
-        result.cleanContent = cleanHtml(html);
+        // Ссылки найдены тем же проходом разборщика
+        result.noIndex = tokenizer.isNoIndex();
+        if (normalizer && !tokenizer.isNoFollow())
+        {
+            result.links = resolveLinks(tokenizer, url, *normalizer);
+        }
+
+        // Текст страницы без разметки
+        result.cleanContent = tokenizer.getText();
 
         // Подсчитываем слова
         result.wordsFrequency = countWords(result.cleanContent);
+        result.wordOffsets = SnippetBuilder::encodeWordOffsets(result.cleanContent);
 
-        std::cout << "✔ Страница проиндексирована: " << url << std::endl;
-        std::cout << "  Заголовок: " << result.title << std::endl;
-        std::cout << "  Найдено уникальных слов: " << result.wordsFrequency.size() << std::endl;
+        // Отпечаток для поиска дубликатов
+        result.fingerprint = DuplicateDetector::computeFingerprint(result.cleanContent, result.wordsFrequency);
+        result.indexed = true;
+
+        if (verbose)
+        {
+            std::cout << "✔ Страница проиндексирована: " << url << std::endl;
+            std::cout << "  Заголовок: " << result.title << std::endl;
+            std::cout << "  Найдено уникальных слов: " << result.wordsFrequency.size() << std::endl;
+            if (normalizer)
+            {
+                std::cout << "  Найдено ссылок: " << result.links.size() << std::endl;
+            }
+        }
 
         return result;
     }
     catch (const std::exception& e)
     {
         std::cerr << "❌ Ошибка при индексации страницы " << url << ": " << e.what() << std::endl;
+        result = IndexingResult();
         result.title = "Ошибка индексации";
         return result;
     }
+}
+
+void Indexer::indexBatch(std::span<const PageInput> pages, const ResultSink& sink, int threads,
+    const UrlNormalizer* normalizer)
+{
+    if (pages.empty())
+    {
+        return;
+    }
+
+    if (threads <= 0)
+    {
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    size_t chunks = (pages.size() + kBatchChunk - 1) / kBatchChunk;
+    threads = static_cast<int>(std::min<size_t>(threads, chunks));
+
+    // Потоки берут следующую порцию страниц, пока они не кончатся:
+    // тяжёлые страницы не задерживают остальные
+    std::atomic<size_t> nextChunk{ 0 };
+    std::atomic<bool> failed{ false };
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        size_t chunk;
+        while (!failed && (chunk = nextChunk++) < chunks)
+        {
+            size_t end = std::min(pages.size(), (chunk + 1) * kBatchChunk);
+            for (size_t i = chunk * kBatchChunk; i < end && !failed; ++i)
+            {
+                IndexingResult result = indexDocument(pages[i].html, pages[i].url, normalizer, false);
+                try
+                {
+                    sink(i, result);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    failed = true;
+                }
+            }
+        }
+    };
+
+    // Вызывающий поток работает наравне с остальными
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int i = 1; i < threads; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+std::vector<Indexer::IndexingResult> Indexer::indexBatch(std::span<const PageInput> pages, int threads,
+    const UrlNormalizer* normalizer)
+{
+    // Каждый поток пишет только в свои ячейки - синхронизация не нужна
+    std::vector<IndexingResult> results(pages.size());
+    indexBatch(pages, [&results](size_t index, IndexingResult& result) {
+        results[index] = std::move(result);
+    }, threads, normalizer);
+    return results;
 }
\ No newline at end of file
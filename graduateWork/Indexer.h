@@ -2,31 +2,97 @@
 #define INDEXER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <span>
+#include <functional>
 #include <utility>
+#include "DuplicateDetector.h"
+#include "TermList.h"
+#include "Stemmer.h"
+#include "StopWords.h"
+#include "UrlNormalizer.h"
+
+class HtmlTokenizer;
 
 class Indexer
 {
 public:
     Indexer() = default;
+    Indexer(const Stemmer& stemmer, const StopWords& stopWords);
 
     // Структура для результатов индексации
     struct IndexingResult
     {
+        // false - страницу не удалось разобрать, остальные поля пусты
+        bool indexed = false;
+
         std::string title;
         std::string cleanContent;
-        std::vector<std::pair<std::string, int>> wordsFrequency;
+        TermList wordsFrequency;  // в порядке первого появления, с позициями
+
+        // Смещения слов cleanContent для сниппетов (SnippetBuilder)
+        std::string wordOffsets;
+
+        // Абсолютные нормализованные ссылки страницы без повторов
+        std::vector<std::string> links;
+
+        // <meta name="robots" content="noindex">: страницу не индексировать
+        bool noIndex = false;
+
+        // Отпечаток содержимого для поиска дубликатов
+        DuplicateDetector::Fingerprint fingerprint;
+    };
+
+    // Основная функция индексации. Текст, слова и ссылки получаются за
+    // один проход по HTML. normalizer разрешает ссылки страницы
+    // (nullptr - ссылки не нужны, например на последнем уровне обхода)
+    IndexingResult indexPage(const std::string& html, const std::string& url,
+        const UrlNormalizer* normalizer = nullptr);
+
+    // Страница пакета: строки должны жить до конца indexBatch
+    struct PageInput
+    {
+        std::string_view url;
+        std::string_view html;
     };
 
-    // Основная функция индексации
-    IndexingResult indexPage(const std::string& html, const std::string& url);
+    // Получатель результатов пакета: номер страницы во входном диапазоне
+    // и её результат (можно забрать через std::move)
+    using ResultSink = std::function<void(size_t index, IndexingResult& result)>;
+
+    // Пакетная индексация без вывода в консоль: страницы делятся между
+    // threads потоками (0 - по числу ядер) порциями по kBatchChunk.
+    // Разборщик, арена и таблица подсчёта у каждого потока свои и
+    // переиспользуются от страницы к странице. sink вызывается из рабочих
+    // потоков одновременно - он должен быть потокобезопасным. Исключение
+    // из sink останавливает пакет и пробрасывается вызывающему
+    void indexBatch(std::span<const PageInput> pages, const ResultSink& sink, int threads = 0,
+        const UrlNormalizer* normalizer = nullptr);
+
+    // То же в заранее выделенный вектор: результат i - для страницы i
+    std::vector<IndexingResult> indexBatch(std::span<const PageInput> pages, int threads = 0,
+        const UrlNormalizer* normalizer = nullptr);
+
+    static constexpr size_t kBatchChunk = 16;
 
 private:
     // Вспомогательные методы
-    std::string cleanHtml(const std::string& html);
-    std::string extractTitle(const std::string& html);
-    std::string normalizeWord(const std::string& word);
-    std::vector<std::pair<std::string, int>> countWords(const std::string& text);
+    // Частоты слов в порядке первого появления (без сортировки)
+    TermList countWords(std::string_view text);
+
+    // Абсолютные ссылки из найденных разборщиком значений href
+    std::vector<std::string> resolveLinks(const HtmlTokenizer& tokenizer, std::string_view url,
+        const UrlNormalizer& normalizer);
+
+    // Индексация одной страницы; verbose - печатать ход работы
+    IndexingResult indexDocument(std::string_view html, std::string_view url,
+        const UrlNormalizer* normalizer, bool verbose);
+
+    // Приведение слов к основе и стоп-слова; поисковик так же
+    // обрабатывает запрос
+    Stemmer stemmer_;
+    StopWords stopWords_;
 };
 
 #endif // INDEXER_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "LatencyHistogram.h"
+#include <bit>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : count_(0)
+{
+    for (auto& bucket : buckets_)
+    {
+        bucket = 0;
+    }
+}
+
+int LatencyHistogram::bucketIndex(uint64_t micros)
+{
+    // Малые значения попадают в корзины "как есть"
+    if (micros < kSubBuckets)
+    {
+        return static_cast<int>(micros);
+    }
+
+    // Старший бит задаёт степень двойки, следующие kSubBits бит - корзину внутри неё
+    int exponent = std::bit_width(micros) - 1;
+    int shift = exponent - kSubBits;
+    int sub = static_cast<int>((micros >> shift) & (kSubBuckets - 1));
+    return (shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < kSubBuckets)
+    {
+        return static_cast<uint64_t>(index);
+    }
+
+    int shift = index / kSubBuckets - 1;
+    uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(long long micros)
+{
+    uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::percentileMillis(double percentile) const
+{
+    long long total = count_.load(std::memory_order_relaxed);
+    if (total == 0)
+    {
+        return 0.0;
+    }
+
+    long long target = static_cast<long long>(std::ceil(total * percentile / 100.0));
+    if (target < 1)
+    {
+        target = 1;
+    }
+
+    long long seen = 0;
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+        {
+            return bucketUpperBound(i) / 1000.0;
+        }
+    }
+
+    return bucketUpperBound(kBuckets - 1) / 1000.0;
+}
+
+long long LatencyHistogram::getCount() const
+{
+    return count_;
+}
\ No newline at end of file
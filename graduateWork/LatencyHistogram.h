@@ -0,0 +1,37 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Гистограмма задержек для расчёта перцентилей без хранения всех замеров.
+// Корзины логарифмические: на каждую степень двойки приходится 16 корзин,
+// поэтому относительная погрешность перцентиля не превышает ~6%.
+// Запись - одна атомарная операция, блокировок нет
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    // Добавление замера в микросекундах
+    void record(long long micros);
+
+    // Значение перцентиля (0 < percentile <= 100) в миллисекундах
+    double percentileMillis(double percentile) const;
+
+    long long getCount() const;
+
+private:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr int kBuckets = 64 * kSubBuckets;
+
+    std::array<std::atomic<long long>, kBuckets> buckets_;
+    std::atomic<long long> count_;
+
+    static int bucketIndex(uint64_t micros);
+    static uint64_t bucketUpperBound(int index);
+};
+
+#endif // LATENCYHISTOGRAM_H
\ No newline at end of file
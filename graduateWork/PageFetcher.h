@@ -0,0 +1,36 @@
+#ifndef PAGEFETCHER_H
+#define PAGEFETCHER_H
+
+#include <string>
+
+// Источник страниц для паука: сеть (HTMLDownloader) или архив WARC
+// (WarcReplayFetcher). Ошибки сообщаются исключением DownloadError
+class PageFetcher
+{
+public:
+    // Валидаторы версии страницы для условного запроса
+    struct Validators
+    {
+        std::string etag;          // ETag (для If-None-Match)
+        std::string lastModified;  // Last-Modified (для If-Modified-Since)
+    };
+
+    virtual ~PageFetcher() = default;
+
+    // Получение HTML страницы по URL
+    virtual std::string download(const std::string& url) = 0;
+
+    // Условная загрузка: если страница не изменилась с версии known,
+    // возвращается false (ответ 304), иначе HTML записывается в html,
+    // а валидаторы новой версии - в current. Источник без поддержки
+    // условных запросов всегда загружает страницу целиком
+    virtual bool downloadIfModified(const std::string& url, const Validators& /*known*/,
+        std::string& html, Validators& current)
+    {
+        html = download(url);
+        current = Validators();
+        return true;
+    }
+};
+
+#endif // PAGEFETCHER_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "PositionList.h"
+
+void PositionList::encode(std::span<const uint32_t> positions, std::string& out)
+{
+    uint32_t previous = 0;
+    for (uint32_t position : positions)
+    {
+        uint32_t delta = position - previous;
+        previous = position;
+        while (delta >= 0x80)
+        {
+            out.push_back(static_cast<char>((delta & 0x7F) | 0x80));
+            delta >>= 7;
+        }
+        out.push_back(static_cast<char>(delta));
+    }
+}
+
+void PositionList::decode(std::string_view encoded, std::vector<uint32_t>& out)
+{
+    out.clear();
+    out.reserve(count(encoded));
+
+    uint32_t position = 0;
+    uint32_t delta = 0;
+    int shift = 0;
+    for (char c : encoded)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (byte & 0x80)
+        {
+            shift += 7;
+            if (shift > 28)
+            {
+                // Больше пяти байт на число - список повреждён
+                return;
+            }
+            continue;
+        }
+        position += delta;
+        out.push_back(position);
+        delta = 0;
+        shift = 0;
+    }
+}
+
+size_t PositionList::count(std::string_view encoded)
+{
+    // Каждое число заканчивается байтом без старшего бита
+    size_t numbers = 0;
+    for (char c : encoded)
+    {
+        numbers += (static_cast<unsigned char>(c) & 0x80) == 0;
+    }
+    return numbers;
+}
\ No newline at end of file
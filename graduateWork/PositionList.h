@@ -0,0 +1,31 @@
+#ifndef POSITIONLIST_H
+#define POSITIONLIST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+// Сжатый список позиций слова в документе (номера слов текста по порядку).
+// Позиции идут по возрастанию: первая записывается как есть, остальные -
+// разностью с предыдущей. Каждое число - varint: 7 бит на байт, старший
+// бит означает продолжение. Вхождения частого слова обычно близко друг к
+// другу, поэтому большинство позиций занимает один байт.
+// Хранится в document_words.positions (BYTEA) рядом с частотой.
+class PositionList
+{
+public:
+    // Дописывает закодированные позиции (по возрастанию) в конец out
+    static void encode(std::span<const uint32_t> positions, std::string& out);
+
+    // Позиции из закодированного списка (out заменяется). Обрезанный
+    // хвост отбрасывается
+    static void decode(std::string_view encoded, std::vector<uint32_t>& out);
+
+    // Число позиций без раскодирования
+    static size_t count(std::string_view encoded);
+};
+
+#endif // POSITIONLIST_H
\ No newline at end of file
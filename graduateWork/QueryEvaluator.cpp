@@ -0,0 +1,193 @@
+#include "QueryEvaluator.h"
+#include "PositionList.h"
+#include "SnippetBuilder.h"
+#include <algorithm>
+
+std::vector<Database::SearchResult> QueryEvaluator::evaluate(const Query& query,
+    const std::vector<Database::Candidate>& candidates, size_t limit)
+{
+    struct Ranked
+    {
+        uint32_t window;
+        const Database::Candidate* candidate;
+    };
+
+    std::vector<Ranked> ranked;
+    ranked.reserve(candidates.size());
+
+    std::vector<std::vector<uint32_t>> lists(query.terms.size());
+    auto decodePositions = [&lists](const Database::Candidate& candidate) {
+        for (size_t i = 0; i < lists.size(); ++i)
+        {
+            if (i < candidate.positions.size())
+            {
+                PositionList::decode(candidate.positions[i], lists[i]);
+            }
+            else
+            {
+                lists[i].clear();
+            }
+        }
+    };
+
+    for (const auto& candidate : candidates)
+    {
+        decodePositions(candidate);
+
+        // Документы без позиций (проиндексированы раньше) фразу не подтверждают
+        bool matches = std::all_of(query.phrases.begin(), query.phrases.end(),
+            [&](const Phrase& phrase) { return matchesPhrase(lists, phrase); });
+        if (matches)
+        {
+            ranked.push_back({ minimalWindow(lists), &candidate });
+        }
+    }
+
+    // Кандидаты уже по убыванию частот - устойчивая сортировка сохраняет
+    // этот порядок при равном окне
+    std::stable_sort(ranked.begin(), ranked.end(), [](const Ranked& a, const Ranked& b) {
+        return a.window < b.window;
+    });
+
+    std::vector<Database::SearchResult> results;
+    for (size_t i = 0; i < ranked.size() && i < limit; ++i)
+    {
+        const Database::Candidate& candidate = *ranked[i].candidate;
+
+        Database::SearchResult result;
+        result.url = candidate.url;
+        result.title = candidate.title;
+        result.relevance = candidate.relevance;
+        result.window = ranked[i].window == kNoWindow ? 0 : static_cast<int>(ranked[i].window);
+        result.documentId = candidate.documentId;
+
+        // Окно сниппета - только для попавших в выдачу
+        decodePositions(candidate);
+        result.snippet.start = SnippetBuilder::chooseWindow(lists, result.snippet.highlights);
+
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+void QueryEvaluator::keepMatches(const Query& query, std::vector<Database::Candidate>& candidates)
+{
+    if (query.phrases.empty())
+    {
+        return;
+    }
+
+    std::vector<std::vector<uint32_t>> lists(query.terms.size());
+    auto rejected = [&](const Database::Candidate& candidate) {
+        for (size_t i = 0; i < lists.size(); ++i)
+        {
+            if (i < candidate.positions.size())
+            {
+                PositionList::decode(candidate.positions[i], lists[i]);
+            }
+            else
+            {
+                lists[i].clear();
+            }
+        }
+        return !std::all_of(query.phrases.begin(), query.phrases.end(),
+            [&](const Phrase& phrase) { return matchesPhrase(lists, phrase); });
+    };
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), rejected), candidates.end());
+}
+
+bool QueryEvaluator::matchesPhrase(const std::vector<std::vector<uint32_t>>& lists, const Phrase& phrase)
+{
+    if (phrase.terms.empty())
+    {
+        return true;
+    }
+
+    // Перебираем позиции самого редкого слова фразы, остальные проверяем
+    // курсорами: начало фразы только растёт, и курсоры не возвращаются назад
+    size_t anchor = 0;
+    for (size_t k = 1; k < phrase.terms.size(); ++k)
+    {
+        if (lists[phrase.terms[k]].size() < lists[phrase.terms[anchor]].size())
+        {
+            anchor = k;
+        }
+    }
+
+    std::vector<size_t> cursors(phrase.terms.size(), 0);
+    for (uint32_t position : lists[phrase.terms[anchor]])
+    {
+        if (position < phrase.offsets[anchor])
+        {
+            continue;
+        }
+        uint32_t start = position - phrase.offsets[anchor];
+
+        bool found = true;
+        for (size_t k = 0; k < phrase.terms.size() && found; ++k)
+        {
+            if (k == anchor)
+            {
+                continue;
+            }
+            const auto& list = lists[phrase.terms[k]];
+            uint32_t expected = start + phrase.offsets[k];
+            while (cursors[k] < list.size() && list[cursors[k]] < expected)
+            {
+                cursors[k]++;
+            }
+            if (cursors[k] == list.size())
+            {
+                // Слово кончилось - дальше фразы тоже нет
+                return false;
+            }
+            found = list[cursors[k]] == expected;
+        }
+
+        if (found)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t QueryEvaluator::minimalWindow(const std::vector<std::vector<uint32_t>>& lists)
+{
+    if (lists.empty())
+    {
+        return kNoWindow;
+    }
+    for (const auto& list : lists)
+    {
+        if (list.empty())
+        {
+            return kNoWindow;
+        }
+    }
+
+    // Слияние k списков: окно от наименьшей из текущих позиций до
+    // наибольшей, затем сдвигаем наименьшую - пока один из списков не кончится
+    std::vector<size_t> cursors(lists.size(), 0);
+    uint32_t best = kNoWindow;
+    while (true)
+    {
+        size_t lowest = 0;
+        uint32_t high = 0;
+        for (size_t i = 0; i < lists.size(); ++i)
+        {
+            uint32_t position = lists[i][cursors[i]];
+            if (position < lists[lowest][cursors[lowest]])
+            {
+                lowest = i;
+            }
+            high = std::max(high, position);
+        }
+
+        best = std::min(best, high - lists[lowest][cursors[lowest]] + 1);
+        if (best == lists.size() || ++cursors[lowest] == lists[lowest].size())
+        {
+            return best;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef QUERYEVALUATOR_H
+#define QUERYEVALUATOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Database.h"
+
+// Проверка фраз и ранжирование по близости слов на позициях из индекса.
+// Кандидаты - документы, содержащие все слова запроса (Database::searchCandidates),
+// поэтому фраза стоит столько же, сколько обычный запрос "все слова":
+// текст документов не читается, сравниваются только списки позиций.
+class QueryEvaluator
+{
+public:
+    // Фраза в кавычках: номера слов в Query::terms и их смещения от начала
+    // фразы (служебные слова между ними дают пропуски)
+    struct Phrase
+    {
+        std::vector<size_t> terms;
+        std::vector<uint32_t> offsets;
+    };
+
+    struct Query
+    {
+        std::vector<std::string> terms;   // различные основы слов запроса
+        std::vector<Phrase> phrases;
+    };
+
+    static constexpr uint32_t kNoWindow = UINT32_MAX;
+
+    // Кандидаты со всеми фразами запроса, по возрастанию окна близости,
+    // при равном окне - по убыванию суммы частот. Не больше limit результатов,
+    // у каждого выбрано окно сниппета (текст загружает Database::loadSnippets)
+    static std::vector<Database::SearchResult> evaluate(const Query& query,
+        const std::vector<Database::Candidate>& candidates, size_t limit);
+
+    // Оставляет кандидатов со всеми фразами запроса (порядок сохраняется)
+    static void keepMatches(const Query& query, std::vector<Database::Candidate>& candidates);
+
+    // Есть ли в документе фраза. lists - позиции каждого слова запроса
+    // по возрастанию
+    static bool matchesPhrase(const std::vector<std::vector<uint32_t>>& lists, const Phrase& phrase);
+
+    // Длина наименьшего отрезка текста (в словах), где встречаются все
+    // слова запроса. kNoWindow - позиции какого-то слова неизвестны
+    static uint32_t minimalWindow(const std::vector<std::vector<uint32_t>>& lists);
+};
+
+#endif // QUERYEVALUATOR_H
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "RecrawlScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <stdexcept>
+#include <functional>
+
+RecrawlScheduler::RecrawlScheduler(const Settings& settings)
+    : settings_(settings)
+    , tokens_(static_cast<double>(std::max(1, settings.budgetPerMinute)))
+    , lastRefill_(now())
+    , revisits_(0)
+    , changed_(0)
+    , unchanged_(0)
+{
+}
+
+long long RecrawlScheduler::now()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(Clock::now().time_since_epoch()).count();
+}
+
+bool RecrawlScheduler::isTracked(const std::string& url) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pages_.count(url) > 0;
+}
+
+void RecrawlScheduler::track(const std::string& url, int depth)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = pages_.try_emplace(url);
+    if (!inserted)
+    {
+        return;
+    }
+
+    // Страницы прошлых обходов обнаруживаются пачками - разносим их
+    // первые визиты по интервалу, чтобы они не пришли разом
+    Page& page = it->second;
+    page.depth = depth;
+    page.interval = static_cast<double>(settings_.initialInterval.count());
+    double spread = static_cast<double>(std::hash<std::string>{}(url) % 1024) / 1024.0;
+    schedule(url, page, now() - static_cast<long long>(page.interval * spread));
+}
+
+PageFetcher::Validators RecrawlScheduler::getValidators(const std::string& url) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(url);
+    if (it == pages_.end())
+    {
+        return {};
+    }
+    return { it->second.etag, it->second.lastModified };
+}
+
+bool RecrawlScheduler::recordFetch(const std::string& url, int depth, uint64_t contentHash,
+    const PageFetcher::Validators& validators)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    long long time = now();
+
+    auto [it, inserted] = pages_.try_emplace(url);
+    Page& page = it->second;
+    page.etag = validators.etag;
+    page.lastModified = validators.lastModified;
+
+    // Первое знакомство с содержимым: сравнивать не с чем
+    if (inserted || page.contentHash == 0)
+    {
+        page.depth = depth;
+        page.contentHash = contentHash;
+        page.lastVisit = time;
+        page.interval = static_cast<double>(settings_.initialInterval.count());
+        schedule(url, page, time);
+        return true;
+    }
+
+    bool changed = page.contentHash != contentHash;
+    page.contentHash = contentHash;
+    observe(page, changed, time);
+    schedule(url, page, time);
+    return changed;
+}
+
+void RecrawlScheduler::recordNotModified(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(url);
+    if (it == pages_.end())
+    {
+        return;
+    }
+
+    long long time = now();
+    observe(it->second, false, time);
+    schedule(url, it->second, time);
+}
+
+void RecrawlScheduler::recordLastModified(const std::string& url, long long lastModified)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pages_.find(url);
+    if (it == pages_.end() || it->second.contentHash == 0)
+    {
+        return;
+    }
+
+    // Страница изменилась после нашего визита - проверяем её первой
+    Page& page = it->second;
+    long long time = now();
+    if (lastModified > page.lastVisit && page.nextVisit > time)
+    {
+        page.nextVisit = time;
+        queue_.emplace(page.nextVisit, url);
+    }
+}
+
+void RecrawlScheduler::forget(const std::string& url)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pages_.erase(url);
+}
+
+void RecrawlScheduler::observe(Page& page, bool changed, long long time)
+{
+    revisits_++;
+    if (changed)
+    {
+        changed_++;
+    }
+    else
+    {
+        unchanged_++;
+    }
+
+    long long elapsed = time - page.lastVisit;
+    page.lastVisit = time;
+    if (elapsed <= 0)
+    {
+        return;
+    }
+
+    page.visits += 1.0;
+    page.observed += static_cast<double>(elapsed);
+    if (changed)
+    {
+        page.changes += 1.0;
+    }
+
+    if (page.visits > kMaxObservations)
+    {
+        double scale = kMaxObservations / page.visits;
+        page.visits *= scale;
+        page.changes *= scale;
+        page.observed *= scale;
+    }
+
+    page.interval = estimateInterval(page);
+}
+
+double RecrawlScheduler::estimateInterval(const Page& page) const
+{
+    double minInterval = static_cast<double>(settings_.minInterval.count());
+    double maxInterval = static_cast<double>(std::max(settings_.minInterval, settings_.maxInterval).count());
+
+    double interval = maxInterval;
+    if (page.visits > 0.0 && page.changes > 0.0)
+    {
+        double meanInterval = page.observed / page.visits;
+        double rate = -std::log((page.visits - page.changes + 0.5) / (page.visits + 0.5)) / meanInterval;
+        if (rate > 0.0)
+        {
+            interval = 1.0 / rate;
+        }
+    }
+
+    // Без изменений интервал растёт постепенно: несколько тихих
+    // визитов подряд ещё не значат, что страница не меняется вовсе
+    interval = std::min(interval, std::max(page.interval, minInterval) * 2.0);
+    return std::clamp(interval, minInterval, maxInterval);
+}
+
+void RecrawlScheduler::schedule(const std::string& url, Page& page, long long visitTime)
+{
+    page.nextVisit = visitTime + static_cast<long long>(page.interval);
+    queue_.emplace(page.nextVisit, url);
+}
+
+std::vector<RecrawlScheduler::Visit> RecrawlScheduler::takeDue(size_t maxCount)
+{
+    std::vector<Visit> due;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    long long time = now();
+
+    // Пополняем бюджет за прошедшее время, не больше чем на минуту вперёд
+    double budget = static_cast<double>(std::max(1, settings_.budgetPerMinute));
+    if (time > lastRefill_)
+    {
+        tokens_ = std::min(budget, tokens_ + static_cast<double>(time - lastRefill_) * budget / 60.0);
+        lastRefill_ = time;
+    }
+
+    while (!queue_.empty() && queue_.top().first <= time && due.size() < maxCount && tokens_ >= 1.0)
+    {
+        auto [visitTime, url] = queue_.top();
+        queue_.pop();
+
+        auto it = pages_.find(url);
+        if (it == pages_.end() || it->second.nextVisit != visitTime)
+        {
+            continue;
+        }
+
+        due.push_back({ url, it->second.depth });
+        tokens_ -= 1.0;
+        schedule(url, it->second, time);
+    }
+
+    return due;
+}
+
+void RecrawlScheduler::save(const std::string& path) const
+{
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [url, page] : pages_)
+        {
+            // Валидаторы с переводами строк или табуляцией сломали бы формат
+            bool plainValidators = page.etag.find_first_of("\t\r\n") == std::string::npos &&
+                page.lastModified.find_first_of("\t\r\n") == std::string::npos;
+
+            out << url << '\t' << page.depth << '\t' << page.contentHash << '\t'
+                << page.lastVisit << '\t' << page.nextVisit << '\t' << page.interval << '\t'
+                << page.visits << '\t' << page.changes << '\t' << page.observed << '\t'
+                << (plainValidators ? page.etag : "") << '\t'
+                << (plainValidators ? page.lastModified : "") << '\n';
+        }
+
+        out.flush();
+        if (!out)
+        {
+            throw std::runtime_error("Ошибка записи " + tmpPath);
+        }
+    }
+    std::filesystem::rename(tmpPath, path);
+}
+
+bool RecrawlScheduler::load(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        std::string url;
+        Page page;
+        if (!std::getline(fields, url, '\t') || url.empty())
+        {
+            continue;
+        }
+
+        fields >> page.depth >> page.contentHash >> page.lastVisit >> page.nextVisit
+            >> page.interval >> page.visits >> page.changes >> page.observed;
+        if (!fields)
+        {
+            continue;
+        }
+
+        // Валидаторы могут быть пустыми: читаем их как поля до табуляции
+        fields.ignore(1);
+        std::getline(fields, page.etag, '\t');
+        std::getline(fields, page.lastModified);
+
+        queue_.emplace(page.nextVisit, url);
+        pages_[url] = std::move(page);
+    }
+
+    return true;
+}
+
+size_t RecrawlScheduler::getTracked() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pages_.size();
+}
+
+long long RecrawlScheduler::getRevisits() const
+{
+    return revisits_;
+}
+
+long long RecrawlScheduler::getChanged() const
+{
+    return changed_;
+}
+
+long long RecrawlScheduler::getUnchanged() const
+{
+    return unchanged_;
+}
\ No newline at end of file
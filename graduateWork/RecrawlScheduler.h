@@ -0,0 +1,134 @@
+#ifndef RECRAWLSCHEDULER_H
+#define RECRAWLSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "PageFetcher.h"
+
+// Расписание повторных визитов для непрерывного обхода.
+// Для каждой загруженной страницы копится история визитов: сколько раз
+// её проверяли, сколько раз она оказалась изменённой (другой хеш текста)
+// и сколько времени прошло между визитами. Частота изменений оценивается
+// по модели Пуассона с поправкой на пропущенные изменения (Cho,
+// Garcia-Molina): rate = -ln((n - X + 0.5) / (n + 0.5)) / (T / n).
+// Следующий визит назначается через 1 / rate в пределах
+// [minInterval, maxInterval], но интервал растёт не больше чем вдвое за
+// визит. Ответ 304 - визит без изменений, <lastmod> из карты сайта новее
+// последнего визита - повод проверить страницу сразу.
+//
+// Визиты выдаются в порядке времени и не чаще глобального бюджета
+// (страниц в минуту), поэтому загрузки достаются часто меняющимся
+// страницам, а не полному повторному обходу.
+class RecrawlScheduler
+{
+public:
+    using Clock = std::chrono::system_clock;
+
+    struct Settings
+    {
+        std::chrono::seconds minInterval{ 3600 };
+        std::chrono::seconds maxInterval{ 30 * 24 * 3600 };
+        std::chrono::seconds initialInterval{ 24 * 3600 };
+        int budgetPerMinute = 120;
+    };
+
+    // Визит, который пора выполнить
+    struct Visit
+    {
+        std::string url;
+        int depth;
+    };
+
+    explicit RecrawlScheduler(const Settings& settings);
+
+    // Есть ли страница в расписании
+    bool isTracked(const std::string& url) const;
+
+    // Страница загружена в прошлых обходах, но её история неизвестна:
+    // первый визит назначается в пределах начального интервала
+    void track(const std::string& url, int depth);
+
+    // Валидаторы последней загруженной версии (для условного запроса)
+    PageFetcher::Validators getValidators(const std::string& url) const;
+
+    // Страница загружена и проиндексирована. Возвращает true, если
+    // содержимое новое или изменилось с прошлого визита
+    bool recordFetch(const std::string& url, int depth, uint64_t contentHash,
+        const PageFetcher::Validators& validators);
+
+    // Сервер ответил 304: страница не изменилась
+    void recordNotModified(const std::string& url);
+
+    // Время изменения из карты сайта (Unix-время)
+    void recordLastModified(const std::string& url, long long lastModified);
+
+    // Страница исчезла (404, 410) - убираем из расписания
+    void forget(const std::string& url);
+
+    // Наступившие визиты в пределах бюджета, не больше maxCount.
+    // Выданный визит сразу переносится на следующий интервал: если
+    // загрузка не удастся, страница будет проверена позже
+    std::vector<Visit> takeDue(size_t maxCount);
+
+    // Сохранение и загрузка расписания
+    void save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    size_t getTracked() const;
+    long long getRevisits() const;
+    long long getChanged() const;
+    long long getUnchanged() const;
+
+private:
+    // История страницы. Время - в секундах Unix
+    struct Page
+    {
+        int depth = 0;
+        uint64_t contentHash = 0;  // 0 - содержимое ещё не видели
+        std::string etag;
+        std::string lastModified;
+        long long lastVisit = 0;
+        long long nextVisit = 0;
+        double interval = 0.0;     // текущий интервал между визитами (с)
+        double visits = 0.0;       // наблюдений (n)
+        double changes = 0.0;      // из них с изменениями (X)
+        double observed = 0.0;     // суммарное время наблюдений (T, с)
+    };
+
+    // Старые наблюдения забываются: страница может начать меняться
+    // чаще или реже
+    static constexpr double kMaxObservations = 20.0;
+
+    const Settings settings_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Page> pages_;
+
+    // Очередь визитов по времени. Запись устаревает, если время визита
+    // страницы с тех пор изменилось - такие записи пропускаются
+    using QueueEntry = std::pair<long long, std::string>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue_;
+
+    // Бюджет визитов (token bucket)
+    double tokens_;
+    long long lastRefill_;
+
+    std::atomic<long long> revisits_;
+    std::atomic<long long> changed_;
+    std::atomic<long long> unchanged_;
+
+    static long long now();
+
+    // Учёт одного визита и назначение следующего
+    void observe(Page& page, bool changed, long long time);
+    double estimateInterval(const Page& page) const;
+    void schedule(const std::string& url, Page& page, long long visitTime);
+};
+
+#endif // RECRAWLSCHEDULER_H
\ No newline at end of file
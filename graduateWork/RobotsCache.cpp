@@ -0,0 +1,164 @@
+#include "RobotsCache.h"
+#include "HTMLDownloader.h"
+#include "UrlNormalizer.h"
+#include <iostream>
+
+RobotsCache::RobotsCache(Fetcher fetcher, std::string userAgent, std::chrono::seconds ttl, size_t maxHosts)
+    : fetcher_(std::move(fetcher))
+    , userAgent_(std::move(userAgent))
+    , ttl_(ttl)
+    , maxHosts_(std::max<size_t>(maxHosts, 1))
+    , fetches_(0)
+    , blocked_(0)
+{
+}
+
+void RobotsCache::setFetchedHandler(FetchedHandler handler)
+{
+    fetchedHandler_ = std::move(handler);
+}
+
+RobotsCache::RulesPtr RobotsCache::load(const std::string& origin, std::chrono::seconds& ttl)
+{
+    fetches_++;
+    ttl = ttl_;
+
+    try
+    {
+        std::string text = fetcher_(origin + "/robots.txt");
+        auto rules = std::make_shared<const RobotsRules>(RobotsRules::parse(text, userAgent_));
+        if (fetchedHandler_)
+        {
+            fetchedHandler_(origin, *rules);
+        }
+        return rules;
+    }
+    catch (const DownloadError& e)
+    {
+        // 4xx (кроме 429) - robots.txt нет, ограничений нет
+        long code = e.getHttpCode();
+        if (e.getKind() == DownloadError::Kind::Http && code >= 400 && code < 500 && code != 429)
+        {
+            RobotsRules rules;
+            if (fetchedHandler_)
+            {
+                fetchedHandler_(origin, rules);
+            }
+            return std::make_shared<const RobotsRules>(rules);
+        }
+
+        std::cerr << "⚠️  robots.txt недоступен (" << e.what() << ")" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "⚠️  Ошибка загрузки robots.txt для " << origin << ": " << e.what() << std::endl;
+    }
+
+    // Сбой сервера или сети. RFC 9309 предписывает в этом случае считать
+    // всё запрещённым: задачи хоста откладываются, а robots.txt
+    // запрашивается снова через минуту
+    ttl = std::min(ttl_, kErrorTtl);
+    return std::make_shared<const RobotsRules>(RobotsRules::unavailable());
+}
+
+void RobotsCache::evict(std::chrono::steady_clock::time_point now)
+{
+    for (auto it = hosts_.begin(); it != hosts_.end();)
+    {
+        if (it->second.expires <= now)
+        {
+            it = hosts_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Все записи свежие - освобождаем половину
+    for (auto it = hosts_.begin(); it != hosts_.end() && hosts_.size() > maxHosts_ / 2;)
+    {
+        it = hosts_.erase(it);
+    }
+}
+
+std::shared_ptr<const RobotsRules> RobotsCache::getRules(const std::string& url)
+{
+    auto components = UrlNormalizer::parse(url);
+    std::string origin = std::string(components.scheme) + "://" + std::string(components.authority);
+
+    std::promise<RulesPtr> promise;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto now = std::chrono::steady_clock::now();
+
+    auto it = hosts_.find(origin);
+    if (it != hosts_.end() && it->second.expires > now)
+    {
+        // Ожидание результата (если его ещё загружают) - вне блокировки кеша
+        std::shared_future<RulesPtr> rules = it->second.rules;
+        lock.unlock();
+        return rules.get();
+    }
+
+    if (hosts_.size() >= maxHosts_)
+    {
+        evict(now);
+    }
+
+    // Этот поток загружает правила, остальные ждут его результата.
+    // Срок жизни до загрузки - с запасом, потом уточняется
+    Entry& entry = hosts_[origin];
+    entry.rules = promise.get_future().share();
+    entry.expires = now + ttl_;
+    lock.unlock();
+
+    std::chrono::seconds ttl;
+    RulesPtr rules = load(origin, ttl);
+    promise.set_value(rules);
+
+    lock.lock();
+    it = hosts_.find(origin);
+    if (it != hosts_.end())
+    {
+        it->second.expires = std::chrono::steady_clock::now() + ttl;
+    }
+
+    return rules;
+}
+
+RobotsCache::Access RobotsCache::check(const std::string& url, std::chrono::steady_clock::time_point& retryAt)
+{
+    auto components = UrlNormalizer::parse(url);
+    std::string pathAndQuery = components.path.empty() ? "/" : std::string(components.path);
+    if (components.hasQuery)
+    {
+        pathAndQuery += '?';
+        pathAndQuery += components.query;
+    }
+
+    auto rules = getRules(url);
+    if (rules->isUnavailable())
+    {
+        retryAt = std::chrono::steady_clock::now() + std::min(ttl_, kErrorTtl);
+        return Access::Unavailable;
+    }
+
+    if (rules->isAllowed(pathAndQuery))
+    {
+        return Access::Allowed;
+    }
+
+    blocked_++;
+    return Access::Disallowed;
+}
+
+long long RobotsCache::getFetches() const
+{
+    return fetches_;
+}
+
+long long RobotsCache::getBlocked() const
+{
+    return blocked_;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef ROBOTSCACHE_H
+#define ROBOTSCACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include "RobotsRules.h"
+
+// Кеш правил robots.txt по хостам со сроком жизни.
+// robots.txt каждого хоста загружается один раз: если несколько потоков
+// одновременно обращаются к новому хосту, загружает первый, остальные
+// ждут его результата. По истечении срока правила загружаются заново
+class RobotsCache
+{
+public:
+    // Загрузка текста robots.txt по URL (бросает DownloadError)
+    using Fetcher = std::function<std::string(const std::string& robotsUrl)>;
+
+    // Вызывается после каждой загрузки robots.txt: origin ("http://host:port") и правила
+    using FetchedHandler = std::function<void(const std::string& origin, const RobotsRules& rules)>;
+
+    RobotsCache(Fetcher fetcher, std::string userAgent, std::chrono::seconds ttl, size_t maxHosts);
+
+    void setFetchedHandler(FetchedHandler handler);
+
+    // Можно ли загружать URL
+    enum class Access
+    {
+        Allowed,
+        Disallowed,   // запрещено правилами robots.txt
+        Unavailable   // robots.txt временно недоступен - повторить позже
+    };
+
+    // Проверка URL. Для Unavailable в retryAt - когда robots.txt
+    // будет запрошен снова
+    Access check(const std::string& url, std::chrono::steady_clock::time_point& retryAt);
+
+    // Правила хоста URL (загружаются при необходимости)
+    std::shared_ptr<const RobotsRules> getRules(const std::string& url);
+
+    long long getFetches() const;
+    long long getBlocked() const;
+
+private:
+    using RulesPtr = std::shared_ptr<const RobotsRules>;
+
+    struct Entry
+    {
+        std::shared_future<RulesPtr> rules;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    // Срок жизни правил, если robots.txt не удалось получить из-за сбоя
+    static constexpr std::chrono::seconds kErrorTtl{ 60 };
+
+    Fetcher fetcher_;
+    FetchedHandler fetchedHandler_;
+    const std::string userAgent_;
+    const std::chrono::seconds ttl_;
+    const size_t maxHosts_;
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> hosts_;
+
+    std::atomic<long long> fetches_;
+    std::atomic<long long> blocked_;
+
+    // Загрузка и разбор; срок жизни результата возвращается в ttl
+    RulesPtr load(const std::string& origin, std::chrono::seconds& ttl);
+
+    // Удаление устаревших записей при переполнении (под mutex_)
+    void evict(std::chrono::steady_clock::time_point now);
+};
+
+#endif // ROBOTSCACHE_H
\ No newline at end of file
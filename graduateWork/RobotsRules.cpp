@@ -0,0 +1,283 @@
+#include "RobotsRules.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cmath>
+
+namespace
+{
+    std::string_view trimView(std::string_view value)
+    {
+        size_t start = value.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos)
+        {
+            return {};
+        }
+        size_t end = value.find_last_not_of(" \t\r");
+        return value.substr(start, end - start + 1);
+    }
+
+    std::string toLower(std::string_view value)
+    {
+        std::string result(value);
+        for (auto& c : result)
+        {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return result;
+    }
+
+    // Токен продукта: "SearchEngineBot/1.0" -> "searchenginebot".
+    // RFC 9309 допускает в нём только буквы, '_' и '-'
+    std::string productToken(std::string_view value)
+    {
+        size_t end = 0;
+        while (end < value.size() &&
+            (std::isalpha(static_cast<unsigned char>(value[end])) || value[end] == '_' || value[end] == '-'))
+        {
+            ++end;
+        }
+        return toLower(value.substr(0, end));
+    }
+}
+
+RobotsRules::Rule RobotsRules::compile(std::string_view pattern, bool allow)
+{
+    Rule rule;
+    rule.allow = allow;
+    rule.length = pattern.size();
+
+    if (!pattern.empty() && pattern.back() == '$')
+    {
+        rule.anchoredEnd = true;
+        pattern.remove_suffix(1);
+    }
+
+    // "/a*b*c" -> {"/a", "b", "c"}; пустые части сохраняются, чтобы
+    // первая часть всегда была префиксом, а последняя - концом пути
+    size_t start = 0;
+    while (true)
+    {
+        size_t star = pattern.find('*', start);
+        if (star == std::string_view::npos)
+        {
+            rule.parts.emplace_back(pattern.substr(start));
+            break;
+        }
+        rule.parts.emplace_back(pattern.substr(start, star - start));
+        start = star + 1;
+    }
+
+    return rule;
+}
+
+bool RobotsRules::matches(const Rule& rule, std::string_view path)
+{
+    // Первая часть - префикс пути
+    const std::string& first = rule.parts.front();
+    if (path.compare(0, first.size(), first) != 0)
+    {
+        return false;
+    }
+
+    if (rule.parts.size() == 1)
+    {
+        return !rule.anchoredEnd || path.size() == first.size();
+    }
+
+    // Средние части ищем жадно слева направо
+    size_t pos = first.size();
+    for (size_t i = 1; i + 1 < rule.parts.size(); ++i)
+    {
+        pos = path.find(rule.parts[i], pos);
+        if (pos == std::string_view::npos)
+        {
+            return false;
+        }
+        pos += rule.parts[i].size();
+    }
+
+    // Последняя часть: с '$' должна стоять в конце пути, иначе - где угодно дальше
+    const std::string& last = rule.parts.back();
+    if (rule.anchoredEnd)
+    {
+        return path.size() >= pos + last.size() &&
+            path.compare(path.size() - last.size(), last.size(), last) == 0;
+    }
+    return path.find(last, pos) != std::string_view::npos;
+}
+
+RobotsRules RobotsRules::parse(std::string_view text, std::string_view userAgent)
+{
+    std::string agent = productToken(userAgent);
+
+    // Правила двух кандидатов: группа нашего робота и группа "*"
+    std::vector<Rule> ownRules;
+    std::vector<Rule> anyRules;
+    double ownDelay = 0.0;
+    double anyDelay = 0.0;
+    bool ownGroupFound = false;
+
+    RobotsRules result;
+
+    // Текущая группа: несколько строк User-agent подряд относятся к одной
+    bool inOwnGroup = false;
+    bool inAnyGroup = false;
+    bool lastWasAgent = false;
+
+    size_t pos = 0;
+    while (pos <= text.size())
+    {
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos)
+        {
+            end = text.size();
+        }
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+
+        // Комментарии
+        size_t hashPos = line.find('#');
+        if (hashPos != std::string_view::npos)
+        {
+            line = line.substr(0, hashPos);
+        }
+
+        size_t colonPos = line.find(':');
+        if (colonPos == std::string_view::npos)
+        {
+            continue;
+        }
+
+        std::string key = toLower(trimView(line.substr(0, colonPos)));
+        std::string_view value = trimView(line.substr(colonPos + 1));
+
+        if (key == "user-agent")
+        {
+            if (!lastWasAgent)
+            {
+                inOwnGroup = false;
+                inAnyGroup = false;
+            }
+            lastWasAgent = true;
+
+            // Группа наша, только если её имя совпадает с токеном продукта
+            // целиком: группа "bot" не относится к "SearchEngineBot"
+            if (value == "*")
+            {
+                inAnyGroup = true;
+            }
+            else if (!agent.empty() && productToken(value) == agent)
+            {
+                inOwnGroup = true;
+                ownGroupFound = true;
+            }
+            continue;
+        }
+        lastWasAgent = false;
+
+        if (key == "sitemap")
+        {
+            // Sitemap не относится к группам
+            if (!value.empty())
+            {
+                result.sitemaps_.emplace_back(value);
+            }
+            continue;
+        }
+
+        if (!inOwnGroup && !inAnyGroup)
+        {
+            continue;
+        }
+
+        if (key == "allow" || key == "disallow")
+        {
+            // Пустой Disallow ничего не запрещает
+            if (value.empty())
+            {
+                continue;
+            }
+            Rule rule = compile(value, key == "allow");
+            if (inOwnGroup)
+            {
+                ownRules.push_back(rule);
+            }
+            if (inAnyGroup)
+            {
+                anyRules.push_back(std::move(rule));
+            }
+        }
+        else if (key == "crawl-delay")
+        {
+            // inf, nan и отрицательные значения игнорируются
+            double delay = std::strtod(std::string(value).c_str(), nullptr);
+            if (!std::isfinite(delay) || delay < 0.0)
+            {
+                continue;
+            }
+            if (inOwnGroup)
+            {
+                ownDelay = delay;
+            }
+            if (inAnyGroup)
+            {
+                anyDelay = delay;
+            }
+        }
+    }
+
+    // Группа с нашим именем полностью заменяет группу "*"
+    result.rules_ = ownGroupFound ? std::move(ownRules) : std::move(anyRules);
+    result.crawlDelay_ = ownGroupFound ? ownDelay : anyDelay;
+
+    std::stable_sort(result.rules_.begin(), result.rules_.end(), [](const Rule& a, const Rule& b) {
+        if (a.length != b.length)
+        {
+            return a.length > b.length;
+        }
+        return a.allow && !b.allow;
+        });
+
+    return result;
+}
+
+RobotsRules RobotsRules::unavailable()
+{
+    RobotsRules result;
+    result.rules_.push_back(compile("/", false));
+    result.unavailable_ = true;
+    return result;
+}
+
+bool RobotsRules::isUnavailable() const
+{
+    return unavailable_;
+}
+
+bool RobotsRules::isAllowed(std::string_view pathAndQuery) const
+{
+    if (pathAndQuery.empty())
+    {
+        pathAndQuery = "/";
+    }
+
+    for (const auto& rule : rules_)
+    {
+        if (matches(rule, pathAndQuery))
+        {
+            return rule.allow;
+        }
+    }
+    return true;
+}
+
+double RobotsRules::getCrawlDelay() const
+{
+    return crawlDelay_;
+}
+
+const std::vector<std::string>& RobotsRules::getSitemaps() const
+{
+    return sitemaps_;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef ROBOTSRULES_H
+#define ROBOTSRULES_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Правила robots.txt для одного хоста (RFC 9309).
+// При разборе выбирается группа нашего робота (или группа "*"), а её
+// шаблоны Allow/Disallow компилируются: каждый шаблон разбивается по '*'
+// на литеральные части и сортируется по убыванию длины. Проверка пути
+// идёт до первого совпавшего шаблона - это и есть самое длинное совпадение,
+// как требует стандарт; при равной длине Allow проверяется первым.
+class RobotsRules
+{
+public:
+    // Разрешено всё (robots.txt отсутствует)
+    RobotsRules() = default;
+
+    // Разбор текста robots.txt для робота userAgent
+    static RobotsRules parse(std::string_view text, std::string_view userAgent);
+
+    // robots.txt временно недоступен (5xx, сбой сети): по RFC 9309
+    // до следующей попытки запрещено всё
+    static RobotsRules unavailable();
+
+    bool isUnavailable() const;
+
+    // Проверка пути с запросом ("/path?query")
+    bool isAllowed(std::string_view pathAndQuery) const;
+
+    // Задержка между запросами из Crawl-delay (секунды, 0 - не указана)
+    double getCrawlDelay() const;
+
+    // Карты сайта из директив Sitemap
+    const std::vector<std::string>& getSitemaps() const;
+
+private:
+    struct Rule
+    {
+        std::vector<std::string> parts;  // литеральные части между '*'
+        bool anchoredEnd = false;        // шаблон заканчивается на '$'
+        bool allow = false;
+        size_t length = 0;               // длина исходного шаблона (приоритет)
+    };
+
+    std::vector<Rule> rules_;
+    double crawlDelay_ = 0.0;
+    std::vector<std::string> sitemaps_;
+    bool unavailable_ = false;
+
+    static Rule compile(std::string_view pattern, bool allow);
+    static bool matches(const Rule& rule, std::string_view path);
+};
+
+#endif // ROBOTSRULES_H
\ No newline at end of file
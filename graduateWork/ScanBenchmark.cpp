@@ -0,0 +1,266 @@
+#include "ScanBenchmark.h"
+#include "HtmlTokenizer.h"
+#include "Indexer.h"
+#include "WarcReplayFetcher.h"
+#include "SyntheticSite.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <bit>
+#include <cctype>
+
+namespace
+{
+    // Минимальное время замера одного случая на одном уровне
+    constexpr std::chrono::milliseconds kMinMeasureTime{ 300 };
+    constexpr int kMinPasses = 3;
+
+    // Индексатор печатает ход работы в консоль - на время замера вывод отключается
+    class SilentOutput
+    {
+    public:
+        SilentOutput()
+            : saved_(std::cout.rdbuf(nullptr))
+        {
+        }
+
+        ~SilentOutput()
+        {
+            std::cout.rdbuf(saved_);
+            std::cout.clear();
+        }
+
+    private:
+        std::streambuf* saved_;
+    };
+
+    std::string readFile(const std::filesystem::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream buffer;
+        buffer << in.rdbuf();
+        return buffer.str();
+    }
+}
+
+ScanBenchmark::ScanBenchmark(const Config& config)
+    : config_(config)
+{
+}
+
+std::string ScanBenchmark::loadCorpus(const std::string& corpusPath)
+{
+    namespace fs = std::filesystem;
+    pages_.clear();
+
+    std::string path = corpusPath.empty() ? config_.getSpiderWarcReplayPath() : corpusPath;
+    if (!path.empty() && fs::is_directory(path))
+    {
+        for (const auto& entry : fs::recursive_directory_iterator(path))
+        {
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (entry.is_regular_file() && (extension == ".html" || extension == ".htm"))
+            {
+                pages_.push_back(readFile(entry.path()));
+            }
+        }
+        return "каталог " + path;
+    }
+
+    if (!path.empty() && fs::exists(path))
+    {
+        UrlNormalizer normalizer(UrlNormalizer::Rules{ config_.getSpiderStripQueryParams(), config_.shouldSortQueryParams() });
+        WarcReplayFetcher archive(path, normalizer);
+        for (const std::string& url : archive.getUrls())
+        {
+            pages_.push_back(archive.download(url));
+        }
+        return "WARC-архив " + path;
+    }
+
+    if (!path.empty())
+    {
+        std::cerr << "⚠️  Корпус не найден: " << path << std::endl;
+    }
+
+    // Без записанного обхода - страницы синтетического сайта
+    SyntheticSite::Options options;
+    options.pages = std::clamp(config_.getBenchPages(), 1, 200);
+    options.fanout = config_.getBenchFanout();
+    options.pageSize = config_.getBenchPageSize();
+    SyntheticSite site(options);
+    for (int i = 0; i < options.pages; ++i)
+    {
+        pages_.push_back(site.buildPage(i));
+    }
+    return "синтетические страницы";
+}
+
+ScanBenchmark::Report ScanBenchmark::run(const std::string& corpusPath)
+{
+    Report report;
+    report.source = loadCorpus(corpusPath);
+    report.pages = pages_.size();
+    for (const std::string& page : pages_)
+    {
+        report.bytes += page.size();
+    }
+    report.bestLevel = TextScan::getBestLevel();
+
+    if (pages_.empty())
+    {
+        return report;
+    }
+
+    HtmlTokenizer tokenizer;
+    Indexer indexer(Stemmer::fromNames(config_.getIndexStemmers()),
+        StopWords(Stemmer::parseLanguages(config_.getIndexStopWords()), config_.getIndexStopWordsFile()));
+
+    // Каждый случай - один проход по всем страницам. Контрольная сумма
+    // сравнивается между уровнями
+    struct Case
+    {
+        const char* name;
+        std::function<uint64_t()> pass;
+    };
+
+    std::vector<Case> cases;
+    cases.push_back({ "classify", [&]() {
+        uint64_t sum = 0;
+        for (const std::string& page : pages_)
+        {
+            for (size_t pos = 0; pos + TextScan::kBlockSize <= page.size(); pos += TextScan::kBlockSize)
+            {
+                TextScan::Block block = TextScan::classify(page.data() + pos);
+                sum += static_cast<uint64_t>(std::popcount(block.word) + std::popcount(block.special));
+            }
+        }
+        return sum;
+    } });
+    cases.push_back({ "tokenizer", [&]() {
+        uint64_t sum = 0;
+        for (const std::string& page : pages_)
+        {
+            tokenizer.parse(page);
+            sum += tokenizer.getText().size() + tokenizer.getTitle().size();
+
+            // Ссылки собираются тем же проходом
+            for (std::string_view link : tokenizer.getLinks())
+            {
+                sum += link.size() + 1;
+            }
+        }
+        return sum;
+    } });
+    cases.push_back({ "indexer", [&]() {
+        SilentOutput silent;
+        uint64_t sum = 0;
+        for (const std::string& page : pages_)
+        {
+            sum += indexer.indexPage(page, "bench").wordsFrequency.size();
+        }
+        return sum;
+    } });
+
+    // Те же страницы пакетом во всех ядрах
+    std::vector<Indexer::PageInput> inputs;
+    for (const std::string& page : pages_)
+    {
+        inputs.push_back({ "bench", page });
+    }
+    cases.push_back({ "batch", [&]() {
+        uint64_t sum = 0;
+        for (const auto& result : indexer.indexBatch(inputs))
+        {
+            sum += result.wordsFrequency.size();
+        }
+        return sum;
+    } });
+
+    TextScan::Level savedLevel = TextScan::getLevel();
+    for (const Case& benchCase : cases)
+    {
+        uint64_t expected = 0;
+        double scalarMillis = 0.0;
+        for (int level = 0; level <= static_cast<int>(report.bestLevel); ++level)
+        {
+            Measurement measurement;
+            measurement.name = benchCase.name;
+            measurement.level = TextScan::setLevel(static_cast<TextScan::Level>(level));
+
+            // Прогревочный проход заодно даёт контрольную сумму
+            uint64_t checksum = benchCase.pass();
+            if (level == 0)
+            {
+                expected = checksum;
+            }
+            else if (checksum != expected)
+            {
+                report.consistent = false;
+            }
+
+            int passes = 0;
+            auto start = std::chrono::steady_clock::now();
+            auto elapsed = std::chrono::steady_clock::duration::zero();
+            while (passes < kMinPasses || elapsed < kMinMeasureTime)
+            {
+                benchCase.pass();
+                passes++;
+                elapsed = std::chrono::steady_clock::now() - start;
+            }
+
+            measurement.millisPerPass = std::chrono::duration<double, std::milli>(elapsed).count() / passes;
+            measurement.megabytesPerSecond = measurement.millisPerPass > 0.0 ?
+                static_cast<double>(report.bytes) / (1024.0 * 1024.0) / (measurement.millisPerPass / 1000.0) : 0.0;
+            if (level == 0)
+            {
+                scalarMillis = measurement.millisPerPass;
+            }
+            measurement.speedup = measurement.millisPerPass > 0.0 ? scalarMillis / measurement.millisPerPass : 1.0;
+            report.measurements.push_back(measurement);
+        }
+    }
+    TextScan::setLevel(savedLevel);
+
+    return report;
+}
+
+void ScanBenchmark::printReport(const Report& report)
+{
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "⏱️  Замер просмотра страниц" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "   Источник: " << report.source << std::endl;
+    std::cout << "   Страниц: " << report.pages << ", " << report.bytes / 1024 << " КБ" << std::endl;
+    std::cout << "   Лучший набор инструкций: " << TextScan::getLevelName(report.bestLevel) << std::endl;
+
+    if (report.pages == 0)
+    {
+        std::cout << "   Нет страниц для замера" << std::endl;
+        std::cout << "========================================" << std::endl;
+        return;
+    }
+
+    std::cout << "   Результаты уровней " << (report.consistent ? "совпадают" : "НЕ СОВПАДАЮТ") << std::endl;
+
+    // Заголовок выровнен вручную: setw считает байты, а не символы UTF-8
+    std::cout << "\n   случай     уровень    мс/проход      МБ/с   ускорение" << std::endl;
+    std::cout << std::fixed;
+    for (const Measurement& measurement : report.measurements)
+    {
+        std::cout << "   " << std::left << std::setw(11) << measurement.name
+            << std::setw(8) << TextScan::getLevelName(measurement.level) << std::right
+            << std::setprecision(3) << std::setw(12) << measurement.millisPerPass
+            << std::setprecision(1) << std::setw(10) << measurement.megabytesPerSecond
+            << std::setprecision(2) << std::setw(11) << measurement.speedup << "x" << std::endl;
+    }
+    std::cout << std::defaultfloat;
+    std::cout << "========================================" << std::endl;
+}
\ No newline at end of file
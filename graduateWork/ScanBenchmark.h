@@ -0,0 +1,54 @@
+#ifndef SCANBENCHMARK_H
+#define SCANBENCHMARK_H
+
+#include <string>
+#include <vector>
+#include "Config.h"
+#include "TextScan.h"
+
+// Микрозамер разбора страниц: HtmlTokenizer (текст и ссылки), подсчёт
+// слов индексатором (по странице и пакетом во всех ядрах) и сама
+// классификация TextScan на каждом доступном наборе инструкций
+// (скалярный, SSE2, AVX2). Страницы берутся из WARC-архива
+// записанного обхода или каталога с файлами .html, без них - страницы
+// SyntheticSite. Результаты на разных уровнях обязаны совпадать -
+// замер заодно проверяет это
+class ScanBenchmark
+{
+public:
+    struct Measurement
+    {
+        std::string name;
+        TextScan::Level level = TextScan::Level::Scalar;
+        double millisPerPass = 0.0;     // один проход по всем страницам
+        double megabytesPerSecond = 0.0;
+        double speedup = 1.0;           // относительно скалярного уровня
+    };
+
+    struct Report
+    {
+        std::string source;
+        size_t pages = 0;
+        size_t bytes = 0;
+        TextScan::Level bestLevel = TextScan::Level::Scalar;
+        bool consistent = true;         // результаты всех уровней совпали
+        std::vector<Measurement> measurements;
+    };
+
+    explicit ScanBenchmark(const Config& config);
+
+    // corpusPath - WARC-файл или каталог; пустой - архив из
+    // spider.warcReplay, иначе синтетические страницы
+    Report run(const std::string& corpusPath);
+
+    static void printReport(const Report& report);
+
+private:
+    const Config& config_;
+    std::vector<std::string> pages_;
+
+    // Загрузка страниц, возвращает описание источника
+    std::string loadCorpus(const std::string& corpusPath);
+};
+
+#endif // SCANBENCHMARK_H
\ No newline at end of file
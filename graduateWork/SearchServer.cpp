@@ -1,12 +1,18 @@
 #include "SearchServer.h"
+#include "WordTokenizer.h"
+#include "SnippetBuilder.h"
 #include <regex>
 #include <sstream>
+#include <algorithm>
+#include <iterator>
 #include <iostream>
 
 SearchServer::SearchServer(Config& config, Database& db)
     : config_(config)
     , database_(db)
     , stopRequested_(false)
+    , stemmer_(Stemmer::fromNames(config.getIndexStemmers()))
+    , stopWords_(Stemmer::parseLanguages(config.getIndexStopWords()), config.getIndexStopWordsFile())
 {
 }
 
@@ -157,15 +163,15 @@ std::string SearchServer::handleRequest(const std::string& request)
                 return formatHttpResponse(400, "Bad Request", "text/html", html);
             }
 
-            // Парсим слова
-            std::vector<std::string> words = parseQuery(query);
+            // Парсим слова и фразы
+            QueryEvaluator::Query parsed = parseQuery(query);
 
-            if (words.empty()) {
-                std::string html = generateErrorPage("Нет допустимых слов в запросе");
+            if (parsed.terms.empty()) {
+                std::string html = generateErrorPage("Нет допустимых слов в запросе (служебные слова не ищутся)");
                 return formatHttpResponse(400, "Bad Request", "text/html", html);
             }
 
-            if (words.size() > 4) {
+            if (parsed.terms.size() > 4) {
                 std::string html = generateErrorPage("Слишком много слов в запросе (максимум 4)");
                 return formatHttpResponse(400, "Bad Request", "text/html", html);
             }
@@ -173,7 +179,19 @@ std::string SearchServer::handleRequest(const std::string& request)
             // Выполняем поиск
             std::vector<Database::SearchResult> results;
             try {
-                results = database_.searchDocuments(words, 10);
+                // Фразы и близость слов проверяются по позициям у документов,
+                // содержащих все слова запроса. Без фраз хватает первой страницы
+                // пересечения, с фразами страницы читаются, пока не наберётся
+                // выдача: редкая фраза может стоять только в документах с малой
+                // частотой слов
+                std::vector<Database::Candidate> candidates;
+                database_.searchCandidates(parsed.terms, config_.getSearcherCandidateLimit(),
+                    [&](std::vector<Database::Candidate>& page) {
+                        QueryEvaluator::keepMatches(parsed, page);
+                        std::move(page.begin(), page.end(), std::back_inserter(candidates));
+                        return !parsed.phrases.empty() && candidates.size() < 10;
+                    });
+                results = QueryEvaluator::evaluate(parsed, candidates, 10);
             }
             catch (const std::exception& e) {
                 std::cerr << "Ошибка поиска в БД: " << e.what() << std::endl;
@@ -181,6 +199,15 @@ std::string SearchServer::handleRequest(const std::string& request)
                 return formatHttpResponse(500, "Internal Server Error", "text/html", html);
             }
 
+            // Сниппеты: из текста читаются только окна вокруг слов запроса.
+            // Без них выдача всё равно показывается
+            try {
+                database_.loadSnippets(results);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Ошибка загрузки сниппетов: " << e.what() << std::endl;
+            }
+
             // Генерируем страницу с результатами
             std::string html = generateResultsPage(results, query);
             return formatHttpResponse(200, "OK", "text/html", html);
@@ -263,47 +290,77 @@ std::string SearchServer::urlDecode(const std::string& encoded)
     return result;
 }
 
-std::vector<std::string> SearchServer::parseQuery(const std::string& query)
+std::string SearchServer::escapeHtml(const std::string& text)
 {
-    std::vector<std::string> words;
-    std::istringstream stream(query);
-    std::string word;
+    std::string result;
+    result.reserve(text.size());
+
+    for (char c : text) {
+        switch (c) {
+        case '&': result += "&amp;"; break;
+        case '<': result += "&lt;"; break;
+        case '>': result += "&gt;"; break;
+        case '"': result += "&quot;"; break;
+        default: result += c; break;
+        }
+    }
+
+    return result;
+}
 
-    while (stream >> word)
+QueryEvaluator::Query SearchServer::parseQuery(const std::string& query)
+{
+    QueryEvaluator::Query parsed;
+
+    // Текст между кавычками - фраза (незакрытая кавычка - до конца запроса)
+    size_t start = 0;
+    bool inPhrase = false;
+    while (start <= query.size())
     {
-        // Очищаем слово от знаков препинания
-        word.erase(std::remove_if(word.begin(), word.end(),
-            [](char c) {
-                return std::ispunct(static_cast<unsigned char>(c)) && c != '-';
-            }),
-            word.end());
-
-        // Приводим к нижнему регистру
-        std::transform(word.begin(), word.end(), word.begin(),
-            [](unsigned char c) { return std::tolower(c); });
-
-        // Фильтруем короткие слова
-        if (word.length() >= 3 && word.length() <= 32)
-        {
-            // Проверяем, что слово содержит хотя бы одну букву
-            bool hasLetter = false;
-            for (char c : word)
+        size_t end = std::min(query.find('"', start), query.size());
+        std::string_view segment(query.data() + start, end - start);
+
+        QueryEvaluator::Phrase phrase;
+        uint32_t position = 0;
+
+        // Слова запроса нормализуются так же, как слова страниц при индексации.
+        // Позиция считается по всем словам фразы, как у индексатора
+        WordTokenizer::forEachWord(segment, [&](std::string_view word) {
+            if (WordTokenizer::isIndexable(word) && !stopWords_.contains(word))
             {
-                if (std::isalpha(static_cast<unsigned char>(c)))
+                std::string term(word);
+                term.resize(stemmer_.stem(term.data(), term.size()));
+
+                // Формы одного слова дают одну основу, а документ должен
+                // содержать все различные слова запроса - повторы не нужны
+                auto found = std::find(parsed.terms.begin(), parsed.terms.end(), term);
+                phrase.terms.push_back(found - parsed.terms.begin());
+                phrase.offsets.push_back(position);
+                if (found == parsed.terms.end())
                 {
-                    hasLetter = true;
-                    break;
+                    parsed.terms.push_back(std::move(term));
                 }
             }
+            position++;
+        });
 
-            if (hasLetter)
+        // Фраза из одного слова - просто слово
+        if (inPhrase && phrase.terms.size() > 1)
+        {
+            // Смещения отсчитываются от первого значимого слова фразы
+            uint32_t first = phrase.offsets.front();
+            for (uint32_t& offset : phrase.offsets)
             {
-                words.push_back(word);
+                offset -= first;
             }
+            parsed.phrases.push_back(std::move(phrase));
         }
+
+        inPhrase = !inPhrase;
+        start = end + 1;
     }
 
-    return words;
+    return parsed;
 }
 
 std::string SearchServer::generateSearchPage()
@@ -321,6 +378,7 @@ std::string SearchServer::generateSearchPage()
         <div class="stats">
             <p>Примеры запросов: программирование, web разработка, база данных</p>
             <p>Максимум 4 слова в запросе</p>
+            <p>Фраза целиком - в кавычках: "база данных"</p>
             <p>Минимальная длина слова: 3 символа</p>
         </div>
     )";
@@ -339,7 +397,7 @@ std::string SearchServer::generateResultsPage(
     html << R"(
         <h1>🔍 Результаты поиска</h1>
         <form method="POST" action="/search" class="search-form">
-            <input type="text" name="query" value=")" << query << R"(" 
+            <input type="text" name="query" value=")" << escapeHtml(query) << R"(" 
                    class="search-input">
             <button type="submit" class="search-button">Найти</button>
         </form>
@@ -351,7 +409,7 @@ std::string SearchServer::generateResultsPage(
         html << R"(
             <div class="no-results">
                 <h2>😕 Ничего не найдено</h2>
-                <p>По запросу ")" << query << R"(" ничего не найдено.</p>
+                <p>По запросу ")" << escapeHtml(query) << R"(" ничего не найдено.</p>
                 <p>Попробуйте:</p>
                 <ul>
                     <li>Проверить правильность написания</li>
@@ -372,12 +430,23 @@ std::string SearchServer::generateResultsPage(
             html << R"(
                 <div class="result">
                     <div class="result-title">
-                        <a href=")" << result.url << R"(" target="_blank">)"
-                << result.title << R"(</a>
+                        <a href=")" << escapeHtml(result.url) << R"(" target="_blank">)"
+                << escapeHtml(result.title) << R"(</a>
                     </div>
-                    <div class="result-url">)" << result.url << R"(</div>
+                    <div class="result-url">)" << escapeHtml(result.url) << R"(</div>)";
+            if (!result.snippet.text.empty())
+            {
+                html << R"(
+                    <div class="result-snippet">)" << renderSnippet(result.snippet) << R"(</div>)";
+            }
+            html << R"(
                     <div class="result-relevance">
-                        Релевантность: )" << result.relevance << R"( | 
+                        Релевантность: )" << result.relevance << R"( | )";
+            if (result.window > 0)
+            {
+                html << R"(Близость слов: )" << result.window << R"( | )";
+            }
+            html << R"(
                         Результат #)" << (i + 1) << R"(
                     </div>
                 </div>
@@ -389,6 +458,50 @@ std::string SearchServer::generateResultsPage(
     return html.str();
 }
 
+std::string SearchServer::renderSnippet(const Database::Snippet& snippet)
+{
+    std::string html;
+    if (snippet.start > 0)
+    {
+        html += "… ";
+    }
+
+    // Слова text по одному, начиная с номера firstWord
+    const std::string& text = snippet.text;
+    uint32_t end = snippet.start + SnippetBuilder::kWindowWords;
+    uint32_t word = snippet.firstWord;
+    size_t pos = 0;
+    bool first = true;
+    while (pos < text.size() && word < end)
+    {
+        size_t next = std::min(text.find(' ', pos), text.size());
+        if (next > pos)
+        {
+            if (word >= snippet.start)
+            {
+                if (!first)
+                {
+                    html += ' ';
+                }
+                first = false;
+
+                std::string escaped = escapeHtml(text.substr(pos, next - pos));
+                bool highlighted = std::binary_search(snippet.highlights.begin(), snippet.highlights.end(), word);
+                html += highlighted ? "<b>" + escaped + "</b>" : escaped;
+            }
+            word++;
+        }
+        pos = next + 1;
+    }
+
+    // Дальше в документе есть ещё слова
+    if (snippet.truncated || text.find_first_not_of(' ', pos) != std::string::npos)
+    {
+        html += " …";
+    }
+    return html;
+}
+
 std::string SearchServer::generateErrorPage(const std::string& error)
 {
     std::stringstream html;
@@ -9,6 +9,9 @@
 #include <boost/asio.hpp>
 #include "Config.h"
 #include "Database.h"
+#include "Stemmer.h"
+#include "StopWords.h"
+#include "QueryEvaluator.h"
 
 using boost::asio::ip::tcp;
 
@@ -20,6 +23,10 @@ private:
     std::atomic<bool> stopRequested_;
     std::thread serverThread_;
 
+    // Те же стеммер и стоп-слова, что у индексатора паука
+    Stemmer stemmer_;
+    StopWords stopWords_;
+
     // Основная функция сервера
     void runServer();
 
@@ -36,11 +43,14 @@ private:
     std::string generateResultsPage(const std::vector<Database::SearchResult>& results,
         const std::string& query);
 
+    // Сниппет результата: слова окна, слова запроса выделены
+    std::string renderSnippet(const Database::Snippet& snippet);
+
     // Генерация HTML страницы с ошибкой
     std::string generateErrorPage(const std::string& error);
 
-    // Парсинг поискового запроса
-    std::vector<std::string> parseQuery(const std::string& query);
+    // Парсинг поискового запроса: слова и фразы в кавычках
+    QueryEvaluator::Query parseQuery(const std::string& query);
 
     // HTML шаблоны
     const std::string htmlHeader = R"(
@@ -63,6 +73,7 @@ private:
         .result-title a { color: #1a0dab; text-decoration: none; }
         .result-title a:hover { text-decoration: underline; }
         .result-url { color: #006621; font-size: 14px; margin-bottom: 5px; }
+        .result-snippet { color: #4d5156; font-size: 14px; line-height: 1.5; margin-bottom: 5px; }
         .result-relevance { color: #70757a; font-size: 12px; }
         .no-results { text-align: center; color: #70757a; padding: 40px; }
         .error { color: #d93025; padding: 20px; background: #fce8e6; border-radius: 5px; }
@@ -87,6 +98,7 @@ private:
         const std::string& content);
     std::string parsePostBody(const std::string& body);
     std::string urlDecode(const std::string& encoded);
+    std::string escapeHtml(const std::string& text);
 
 public:
     SearchServer(Config& config, Database& db);
@@ -0,0 +1,644 @@
+#include "ShardRouter.h"
+#include "UrlNormalizer.h"
+#include <iostream>
+#include <stdexcept>
+#include <charconv>
+#include <algorithm>
+
+namespace
+{
+    uint64_t fnv1a(std::string_view data)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (unsigned char c : data)
+        {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // count неотрицательных чисел через табуляцию, без лишних символов
+    bool parseNumbers(std::string_view text, long long* values, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t end = std::min(text.find('\t'), text.size());
+            auto [ptr, ec] = std::from_chars(text.data(), text.data() + end, values[i]);
+            if (ec != std::errc() || ptr != text.data() + end || values[i] < 0)
+            {
+                return false;
+            }
+
+            bool last = i + 1 == count;
+            if (last != (end == text.size()))
+            {
+                return false;
+            }
+            if (!last)
+            {
+                text.remove_prefix(end + 1);
+            }
+        }
+        return true;
+    }
+}
+
+// Входящее соединение от другого шарда
+struct ShardRouter::Connection
+{
+    explicit Connection(boost::asio::io_context& ioContext)
+        : socket(ioContext)
+    {
+    }
+
+    tcp::socket socket;
+    boost::asio::streambuf buffer;
+};
+
+ShardRouter::ShardRouter(int shardIndex, const std::vector<std::string>& peers, size_t batchSize, int flushMillis)
+    : shardIndex_(shardIndex)
+    , batchSize_(std::max<size_t>(batchSize, 1))
+    , flushInterval_(std::max(flushMillis, 1))
+    , recent_(std::make_unique<std::atomic<uint64_t>[]>(kRecentSize))
+    , stopping_(false)
+    , sent_(0)
+    , done_(false)
+    , forwarded_(0)
+    , received_(0)
+    , dropped_(0)
+{
+    if (shardIndex_ < 0 || shardIndex_ >= static_cast<int>(peers.size()))
+    {
+        throw std::runtime_error("Номер шарда " + std::to_string(shardIndex_) + " вне списка из " +
+            std::to_string(peers.size()) + " адресов");
+    }
+
+    for (const auto& address : peers)
+    {
+        size_t colonPos = address.rfind(':');
+        if (colonPos == std::string::npos)
+        {
+            throw std::runtime_error("Адрес шарда без порта: " + address);
+        }
+
+        Peer peer;
+        peer.host = address.substr(0, colonPos);
+        peer.port = address.substr(colonPos + 1);
+        peers_.push_back(std::move(peer));
+    }
+
+    for (size_t i = 0; i < kRecentSize; ++i)
+    {
+        recent_[i] = 0;
+    }
+}
+
+ShardRouter::~ShardRouter()
+{
+    stop();
+}
+
+int ShardRouter::ownerOf(std::string_view url) const
+{
+    std::string_view host = UrlNormalizer::parse(url).authority;
+
+    // Старшие 32 бита хеша делят на равные диапазоны по числу шардов
+    uint64_t hash = mix(fnv1a(host)) >> 32;
+    return static_cast<int>((hash * peers_.size()) >> 32);
+}
+
+bool ShardRouter::isLocal(std::string_view url) const
+{
+    return ownerOf(url) == shardIndex_;
+}
+
+void ShardRouter::forward(const std::string& url, int depth)
+{
+    uint64_t urlHash = mix(fnv1a(url)) | 1;
+    if (recent_[urlHash & (kRecentSize - 1)].load(std::memory_order_relaxed) == urlHash)
+    {
+        return;
+    }
+
+    Peer& peer = peers_[ownerOf(url)];
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    if (peer.queuedHashes.count(urlHash) != 0)
+    {
+        return;
+    }
+    if (peer.pendingLinks >= kMaxPendingLinks)
+    {
+        dropped_++;
+        return;
+    }
+
+    peer.pending += std::to_string(depth);
+    peer.pending += '\t';
+    peer.pending += url;
+    peer.pending += '\n';
+    peer.pendingLinks++;
+    peer.pendingHashes.push_back(urlHash);
+    peer.queuedHashes.insert(urlHash);
+
+    if (peer.pendingLinks >= batchSize_)
+    {
+        sendCV_.notify_one();
+    }
+}
+
+std::string ShardRouter::snapshotOutbox() const
+{
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    std::string outbox = "=\t" + std::to_string(sent_) + '\t' + std::to_string(received_.load()) + '\n';
+    for (const auto& peer : peers_)
+    {
+        outbox += peer.sending;
+        outbox += peer.pending;
+    }
+    return outbox;
+}
+
+bool ShardRouter::parseLink(std::string_view line, std::string& url, int& depth)
+{
+    size_t tabPos = line.find('\t');
+    if (tabPos == std::string_view::npos || tabPos + 1 >= line.size())
+    {
+        return false;
+    }
+
+    // Глубина - неотрицательное число без лишних символов
+    const char* end = line.data() + tabPos;
+    auto [ptr, ec] = std::from_chars(line.data(), end, depth);
+    if (ec != std::errc() || ptr != end || depth < 0)
+    {
+        return false;
+    }
+
+    url.assign(line.substr(tabPos + 1));
+    return true;
+}
+
+bool ShardRouter::restoreCounters(std::string_view line)
+{
+    long long values[2];
+    if (line.size() < 2 || line[0] != '=' || line[1] != '\t' || !parseNumbers(line.substr(2), values, 2))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    sent_ = values[0];
+    received_ = values[1];
+    return true;
+}
+
+void ShardRouter::start(LinkHandler handler, IdleProbe isIdle, DoneHandler onDone)
+{
+    handler_ = std::move(handler);
+    isIdle_ = std::move(isIdle);
+    onDone_ = std::move(onDone);
+    done_ = false;
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        stopping_ = false;
+        wave_ = Wave();
+        lastWave_ = Wave();
+    }
+
+    // Приём: слушаем свой адрес из общего списка
+    receiveContext_.restart();
+    const Peer& self = peers_[shardIndex_];
+    tcp::resolver resolver(receiveContext_);
+    auto endpoints = resolver.resolve(self.host, self.port);
+    acceptor_ = std::make_unique<tcp::acceptor>(receiveContext_, endpoints.begin()->endpoint());
+    doAccept();
+    receiveThread_ = std::thread([this]() {
+        receiveContext_.run();
+        });
+
+    sendThread_ = std::thread(&ShardRouter::sendLoop, this);
+
+    std::cout << "🔀 Шард " << shardIndex_ << " из " << peers_.size() << ", приём на "
+        << self.host << ":" << self.port << std::endl;
+}
+
+void ShardRouter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        stopping_ = true;
+        sendCV_.notify_all();
+    }
+
+    if (sendThread_.joinable())
+    {
+        sendThread_.join();
+    }
+
+    receiveContext_.stop();
+    if (receiveThread_.joinable())
+    {
+        receiveThread_.join();
+    }
+
+    if (acceptor_)
+    {
+        boost::system::error_code ec;
+        acceptor_->close(ec);
+        acceptor_.reset();
+    }
+}
+
+void ShardRouter::sendLoop()
+{
+    std::unique_lock<std::mutex> lock(sendMutex_);
+    while (true)
+    {
+        sendCV_.wait_for(lock, flushInterval_);
+        bool stopping = stopping_;
+
+        // Шард 0 начинает следующую волну, когда ответили все шарды
+        // или текущая волна потерялась
+        uint64_t wave = 0;
+        if (shardIndex_ == 0 && !stopping && !done_ &&
+            (wave_.id == 0 || wave_.replies == peers_.size() ||
+                std::chrono::steady_clock::now() - wave_.started >= kWaveTimeout))
+        {
+            startWave();
+            wave = wave_.id;
+        }
+
+        // Забираем накопленные пачки и отправляем без блокировки
+        for (auto& peer : peers_)
+        {
+            peer.sending.swap(peer.pending);
+            peer.sendingLinks = peer.pendingLinks;
+            peer.sendingHashes.swap(peer.pendingHashes);
+            peer.pendingLinks = 0;
+            peer.sendingControl.swap(peer.control);
+        }
+
+        lock.unlock();
+        for (auto& peer : peers_)
+        {
+            if (peer.sendingLinks > 0)
+            {
+                flushPeer(peer);
+            }
+            if (!peer.sendingControl.empty())
+            {
+                flushControl(peer);
+            }
+        }
+
+        // Свой ответ шард 0 даёт после отправки пачек: они уже учтены
+        if (wave != 0)
+        {
+            report(wave);
+        }
+        lock.lock();
+
+        if (stopping)
+        {
+            break;
+        }
+    }
+
+    // Закрываем исходящие соединения
+    for (auto& peer : peers_)
+    {
+        if (peer.socket)
+        {
+            boost::system::error_code ec;
+            peer.socket->close(ec);
+            peer.socket.reset();
+        }
+    }
+}
+
+bool ShardRouter::connectPeer(Peer& peer)
+{
+    if (!peer.socket)
+    {
+        boost::system::error_code ec;
+        tcp::resolver resolver(sendContext_);
+        auto endpoints = resolver.resolve(peer.host, peer.port, ec);
+        if (!ec)
+        {
+            auto socket = std::make_unique<tcp::socket>(sendContext_);
+            boost::asio::connect(*socket, endpoints, ec);
+            if (!ec)
+            {
+                socket->set_option(tcp::no_delay(true), ec);
+                peer.socket = std::move(socket);
+            }
+        }
+    }
+    return peer.socket != nullptr;
+}
+
+void ShardRouter::flushPeer(Peer& peer)
+{
+    boost::system::error_code ec;
+
+    bool delivered = false;
+    size_t written = 0;
+    if (connectPeer(peer))
+    {
+        written = boost::asio::write(*peer.socket, boost::asio::buffer(peer.sending), ec);
+        delivered = !ec;
+        if (!delivered)
+        {
+            boost::system::error_code ignored;
+            peer.socket->close(ignored);
+            peer.socket.reset();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sendMutex_);
+
+    // Строки, целиком ушедшие до сбоя, получатель мог принять. Повтор
+    // доставит их ещё раз и ещё раз учтёт, так что счётчики сойдутся
+    sent_ += static_cast<long long>(std::count(peer.sending.begin(), peer.sending.begin() + written, '\n'));
+
+    if (delivered)
+    {
+        // Только доставленные ссылки больше не пересылаются
+        for (uint64_t urlHash : peer.sendingHashes)
+        {
+            recent_[urlHash & (kRecentSize - 1)].store(urlHash, std::memory_order_relaxed);
+            peer.queuedHashes.erase(urlHash);
+        }
+        forwarded_ += static_cast<long long>(peer.sendingLinks);
+    }
+    else if (peer.pendingLinks + peer.sendingLinks > kMaxPendingLinks)
+    {
+        for (uint64_t urlHash : peer.sendingHashes)
+        {
+            peer.queuedHashes.erase(urlHash);
+        }
+        dropped_ += static_cast<long long>(peer.sendingLinks);
+    }
+    else
+    {
+        // Шард недоступен: возвращаем пачку в начало очереди до следующей
+        // попытки. Строка могла уйти частично - тогда получатель отбросит
+        // оборванную строку, а повтор доставит её целиком
+        peer.pending.insert(0, peer.sending);
+        peer.pendingLinks += peer.sendingLinks;
+        peer.pendingHashes.insert(peer.pendingHashes.begin(), peer.sendingHashes.begin(), peer.sendingHashes.end());
+    }
+
+    peer.sending.clear();
+    peer.sendingLinks = 0;
+    peer.sendingHashes.clear();
+}
+
+void ShardRouter::flushControl(Peer& peer)
+{
+    if (connectPeer(peer))
+    {
+        boost::system::error_code ec;
+        boost::asio::write(*peer.socket, boost::asio::buffer(peer.sendingControl), ec);
+        if (ec)
+        {
+            boost::system::error_code ignored;
+            peer.socket->close(ignored);
+            peer.socket.reset();
+        }
+    }
+    peer.sendingControl.clear();
+}
+
+void ShardRouter::startWave()
+{
+    // Предыдущая волна нужна для сравнения, только если ответили все
+    uint64_t id = wave_.id + 1;
+    lastWave_ = wave_.replies == peers_.size() ? std::move(wave_) : Wave();
+
+    wave_ = Wave();
+    wave_.id = id;
+    wave_.replied.assign(peers_.size(), false);
+    wave_.started = std::chrono::steady_clock::now();
+
+    std::string probe = "?\t" + std::to_string(id) + '\n';
+    for (size_t i = 0; i < peers_.size(); ++i)
+    {
+        if (static_cast<int>(i) != shardIndex_)
+        {
+            peers_[i].control += probe;
+        }
+    }
+}
+
+void ShardRouter::report(uint64_t wave)
+{
+    // Сначала состояние паука: простаивающий шард не находит новых
+    // ссылок, поэтому пачки и счётчики после этого уже не изменятся
+    bool idle = isIdle_ && isIdle_();
+    long long sent;
+    long long received;
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        for (const auto& peer : peers_)
+        {
+            if (peer.pendingLinks > 0 || peer.sendingLinks > 0)
+            {
+                idle = false;
+            }
+        }
+        sent = sent_;
+        received = received_;
+
+        if (shardIndex_ != 0)
+        {
+            peers_[0].control += "!\t" + std::to_string(wave) + '\t' + std::to_string(shardIndex_) + '\t' +
+                (idle ? "1" : "0") + '\t' + std::to_string(sent) + '\t' + std::to_string(received) + '\n';
+            sendCV_.notify_one();
+            return;
+        }
+    }
+
+    acceptReport(wave, shardIndex_, idle, sent, received);
+}
+
+void ShardRouter::acceptReport(uint64_t wave, int shard, bool idle, long long sent, long long received)
+{
+    {
+        std::lock_guard<std::mutex> lock(sendMutex_);
+        if (done_ || wave != wave_.id || shard < 0 || shard >= static_cast<int>(peers_.size()) ||
+            wave_.replied[shard])
+        {
+            return;
+        }
+
+        wave_.replied[shard] = true;
+        wave_.replies++;
+        wave_.idle = wave_.idle && idle;
+        wave_.sent += sent;
+        wave_.received += received;
+        if (wave_.replies < peers_.size())
+        {
+            return;
+        }
+
+        // Две волны подряд все простаивали и счётчики не сдвинулись:
+        // новых ссылок не появилось, и ни одна не осталась в пути
+        bool terminated = wave_.idle && wave_.sent == wave_.received &&
+            lastWave_.replies == peers_.size() && lastWave_.idle &&
+            lastWave_.sent == wave_.sent && lastWave_.received == wave_.received;
+        if (!terminated)
+        {
+            return;
+        }
+
+        for (size_t i = 0; i < peers_.size(); ++i)
+        {
+            if (static_cast<int>(i) != shardIndex_)
+            {
+                peers_[i].control += "#\n";
+            }
+        }
+        sendCV_.notify_one();
+    }
+
+    std::cout << "🏁 Все шарды простаивают, ссылок в пути нет" << std::endl;
+    finish();
+}
+
+void ShardRouter::handleControl(std::string_view line)
+{
+    long long values[5];
+    std::string_view fields = line.size() > 2 && line[1] == '\t' ? line.substr(2) : std::string_view();
+
+    switch (line[0])
+    {
+    case '?':
+        if (parseNumbers(fields, values, 1))
+        {
+            report(static_cast<uint64_t>(values[0]));
+        }
+        break;
+    case '!':
+        if (shardIndex_ == 0 && parseNumbers(fields, values, 5))
+        {
+            acceptReport(static_cast<uint64_t>(values[0]), static_cast<int>(values[1]), values[2] != 0,
+                values[3], values[4]);
+        }
+        break;
+    case '#':
+        finish();
+        break;
+    default:
+        break;
+    }
+}
+
+void ShardRouter::finish()
+{
+    if (!done_.exchange(true) && onDone_)
+    {
+        onDone_();
+    }
+}
+
+void ShardRouter::doAccept()
+{
+    auto connection = std::make_shared<Connection>(receiveContext_);
+    acceptor_->async_accept(connection->socket, [this, connection](const boost::system::error_code& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+        {
+            return;
+        }
+        if (!ec)
+        {
+            readLines(connection);
+        }
+        doAccept();
+        });
+}
+
+void ShardRouter::readLines(std::shared_ptr<Connection> connection)
+{
+    boost::asio::async_read_until(connection->socket, connection->buffer, '\n',
+        [this, connection](const boost::system::error_code& ec, size_t) {
+            if (ec)
+            {
+                return;
+            }
+
+            // Разбираем все полные строки, пришедшие в буфер
+            std::istream stream(&connection->buffer);
+            std::string line;
+            while (connection->buffer.size() > 0 && std::getline(stream, line))
+            {
+                if (stream.eof())
+                {
+                    // Неполная строка: вернём её при следующем чтении
+                    std::ostream back(&connection->buffer);
+                    back << line;
+                    break;
+                }
+
+                // Служебные строки обнаружения завершения
+                if (!line.empty() && (line[0] == '?' || line[0] == '!' || line[0] == '#'))
+                {
+                    handleControl(line);
+                    continue;
+                }
+
+                std::string url;
+                int depth = 0;
+                if (!parseLink(line, url, depth))
+                {
+                    continue;
+                }
+
+                // Ссылка учитывается, когда она уже в очереди паука
+                if (handler_)
+                {
+                    handler_(url, depth);
+                    received_++;
+                }
+            }
+
+            readLines(connection);
+        });
+}
+
+int ShardRouter::getShardIndex() const
+{
+    return shardIndex_;
+}
+
+int ShardRouter::getShardCount() const
+{
+    return static_cast<int>(peers_.size());
+}
+
+long long ShardRouter::getForwarded() const
+{
+    return forwarded_;
+}
+
+long long ShardRouter::getReceived() const
+{
+    return received_;
+}
+
+long long ShardRouter::getDropped() const
+{
+    return dropped_;
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#ifndef SHARDROUTER_H
+#define SHARDROUTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <chrono>
+#include <boost/asio.hpp>
+
+using boost::asio::ip::tcp;
+
+// Распределение обхода между несколькими процессами (шардами).
+// Пространство хешей хостов делится на shardCount равных диапазонов,
+// шард с номером i обходит хосты из i-го диапазона: у каждого шарда свои
+// очередь и множество посещённых URL. Ссылки на чужие хосты копятся
+// пачками и пересылаются владельцу по TCP строками "глубина\tURL\n".
+// Все шарды читают один список адресов, поэтому одинаково считают владельцев.
+// Неотправленные ссылки входят в контрольную точку паука (snapshotOutbox),
+// поэтому не теряются при остановке или падении процесса.
+//
+// Завершение обхода обнаруживается алгоритмом четырёх счётчиков
+// (Маттерн). Шард 0 рассылает волны опросов "?\tволна", шард отвечает
+// "!\tволна\tшард\tпростаивает\tотправлено\tпринято". Обход завершён,
+// если в двух волнах подряд все шарды простаивали (нет задач и
+// неотправленных ссылок), а суммы отправленных и принятых ссылок совпали
+// и не изменились: ни одна ссылка не осталась в пути. Тогда шард 0
+// рассылает "#". Счётчики входят в контрольную точку; ссылки, принятые
+// после неё упавшим шардом, нарушают равенство, и такой обход придётся
+// остановить вручную
+class ShardRouter
+{
+public:
+    // Обработчик ссылки, пришедшей от другого шарда
+    using LinkHandler = std::function<void(const std::string& url, int depth)>;
+
+    // Нет ли у шарда работы (очередь пуста, в конвейере ничего нет)
+    using IdleProbe = std::function<bool()>;
+
+    // Все шарды закончили работу
+    using DoneHandler = std::function<void()>;
+
+    // peers - адреса "host:port" всех шардов по порядку номеров,
+    // peers[shardIndex] - адрес, который слушает этот процесс
+    ShardRouter(int shardIndex, const std::vector<std::string>& peers, size_t batchSize, int flushMillis);
+    ~ShardRouter();
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    // Номер шарда, владеющего хостом URL
+    int ownerOf(std::string_view url) const;
+    bool isLocal(std::string_view url) const;
+
+    // Постановка ссылки в пачку для шарда-владельца
+    void forward(const std::string& url, int depth);
+
+    // Неотправленные ссылки (в том числе отправляемые прямо сейчас)
+    // строками "глубина\tURL\n" - для контрольной точки. Первая строка -
+    // счётчики для обнаружения завершения "=\tотправлено\tпринято"
+    std::string snapshotOutbox() const;
+
+    // Разбор строки "глубина\tURL". false - строка некорректна
+    static bool parseLink(std::string_view line, std::string& url, int& depth);
+
+    // Восстановление счётчиков из строки контрольной точки (до start).
+    // false - это не строка счётчиков
+    bool restoreCounters(std::string_view line);
+
+    // Запуск приёма и отправки / остановка с попыткой отправить остаток.
+    // onDone вызывается один раз, в потоке обмена с шардами
+    void start(LinkHandler handler, IdleProbe isIdle, DoneHandler onDone);
+    void stop();
+
+    int getShardIndex() const;
+    int getShardCount() const;
+    long long getForwarded() const;
+    long long getReceived() const;
+    long long getDropped() const;
+
+private:
+    struct Peer
+    {
+        std::string host;
+        std::string port;
+        std::unique_ptr<tcp::socket> socket;  // исходящее соединение (поток отправки)
+
+        // Накопленные строки следующей пачки и хеши их URL
+        std::string pending;
+        size_t pendingLinks = 0;
+        std::vector<uint64_t> pendingHashes;
+
+        // Пачка, которую поток отправки пишет в сокет. Меняется только
+        // под sendMutex_, пока идёт запись - только читается
+        std::string sending;
+        size_t sendingLinks = 0;
+        std::vector<uint64_t> sendingHashes;
+
+        // Хеши URL в pending и sending: одна ссылка не ждёт отправки дважды
+        std::unordered_set<uint64_t> queuedHashes;
+
+        // Служебные строки обнаружения завершения. Не повторяются при
+        // сбое: потерянный опрос просто не завершит волну
+        std::string control;
+        std::string sendingControl;
+    };
+
+    // Волна опросов (только шард 0)
+    struct Wave
+    {
+        uint64_t id = 0;
+        std::vector<bool> replied;
+        size_t replies = 0;
+        bool idle = true;
+        long long sent = 0;
+        long long received = 0;
+        std::chrono::steady_clock::time_point started;
+    };
+
+    struct Connection;
+
+    const int shardIndex_;
+    const size_t batchSize_;
+    const std::chrono::milliseconds flushInterval_;
+
+    // Не больше стольких неотправленных ссылок на шард, пока он недоступен
+    static constexpr size_t kMaxPendingLinks = 1000000;
+
+    // Недавно доставленные ссылки (кеш прямого отображения по хешу URL):
+    // частые ссылки вроде меню сайта не пересылаются с каждой страницы.
+    // Ссылка попадает сюда только после успешной записи в сокет
+    static constexpr size_t kRecentSize = 1 << 16;
+    std::unique_ptr<std::atomic<uint64_t>[]> recent_;
+
+    std::vector<Peer> peers_;
+    mutable std::mutex sendMutex_;
+    std::condition_variable sendCV_;
+    bool stopping_;
+    std::thread sendThread_;
+    boost::asio::io_context sendContext_;
+
+    // Обнаружение завершения. Отправленными считаются записанные в сокет
+    // ссылки (под sendMutex_), принятыми - переданные обработчику
+    IdleProbe isIdle_;
+    DoneHandler onDone_;
+    long long sent_;
+    std::atomic<bool> done_;
+
+    // Текущая и предыдущая волны (шард 0, под sendMutex_). Волна без
+    // ответа всех шардов за kWaveTimeout начинается заново
+    static constexpr std::chrono::seconds kWaveTimeout{ 5 };
+    Wave wave_;
+    Wave lastWave_;
+
+    // Приём входящих пачек
+    LinkHandler handler_;
+    boost::asio::io_context receiveContext_;
+    std::unique_ptr<tcp::acceptor> acceptor_;
+    std::thread receiveThread_;
+
+    std::atomic<long long> forwarded_;
+    std::atomic<long long> received_;
+    std::atomic<long long> dropped_;
+
+    void sendLoop();
+    bool connectPeer(Peer& peer);
+    void flushPeer(Peer& peer);
+    void flushControl(Peer& peer);
+
+    // Новая волна опросов (под sendMutex_)
+    void startWave();
+
+    // Ответ на опрос волны: состояние этого шарда
+    void report(uint64_t wave);
+
+    // Ответ шарда на опрос (шард 0)
+    void acceptReport(uint64_t wave, int shard, bool idle, long long sent, long long received);
+
+    // Разбор служебной строки
+    void handleControl(std::string_view line);
+
+    // Все шарды закончили работу
+    void finish();
+    void doAccept();
+    void readLines(std::shared_ptr<Connection> connection);
+};
+
+#endif // SHARDROUTER_H
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "SitemapParser.h"
+#include <cstdlib>
+#include <cctype>
+
+namespace
+{
+    std::string_view trimView(std::string_view value)
+    {
+        size_t start = value.find_first_not_of(" \t\r\n");
+        if (start == std::string_view::npos)
+        {
+            return {};
+        }
+        size_t end = value.find_last_not_of(" \t\r\n");
+        return value.substr(start, end - start + 1);
+    }
+
+    // Имя тега без пространства имён: "<ns:loc>" -> "loc"
+    std::string_view localName(std::string_view tag)
+    {
+        size_t colonPos = tag.find(':');
+        return colonPos == std::string_view::npos ? tag : tag.substr(colonPos + 1);
+    }
+
+    // Раскрытие сущностей XML, которые встречаются в URL
+    std::string decodeEntities(std::string_view text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            if (text[i] == '&')
+            {
+                size_t semicolon = text.find(';', i);
+                if (semicolon != std::string_view::npos)
+                {
+                    std::string_view entity = text.substr(i + 1, semicolon - i - 1);
+                    char replacement = 0;
+                    if (entity == "amp") replacement = '&';
+                    else if (entity == "lt") replacement = '<';
+                    else if (entity == "gt") replacement = '>';
+                    else if (entity == "quot") replacement = '"';
+                    else if (entity == "apos") replacement = '\'';
+
+                    if (replacement)
+                    {
+                        result += replacement;
+                        i = semicolon;
+                        continue;
+                    }
+                }
+            }
+            result += text[i];
+        }
+        return result;
+    }
+
+    // Число дней от 1970-01-01 (алгоритм Хиннанта)
+    long long daysFromCivil(long long year, unsigned month, unsigned day)
+    {
+        year -= month <= 2;
+        long long era = (year >= 0 ? year : year - 399) / 400;
+        unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+        unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + static_cast<long long>(dayOfEra) - 719468;
+    }
+}
+
+SitemapParser::SitemapParser(EntryHandler handler)
+    : handler_(std::move(handler))
+    , inEntry_(false)
+    , entries_(0)
+{
+}
+
+void SitemapParser::feed(const char* data, size_t size)
+{
+    buffer_.append(data, size);
+    parseBuffer();
+}
+
+void SitemapParser::parseBuffer()
+{
+    size_t pos = 0;
+    while (true)
+    {
+        size_t open = buffer_.find('<', pos);
+        if (open == std::string::npos)
+        {
+            // Текст вне интересующих элементов не нужен
+            pos = buffer_.size();
+            break;
+        }
+
+        size_t close = buffer_.find('>', open);
+        if (close == std::string::npos)
+        {
+            pos = open;
+            break;
+        }
+
+        std::string_view tag(buffer_.data() + open + 1, close - open - 1);
+        if (tag.empty() || tag[0] == '?' || tag[0] == '!' || tag[0] == '/')
+        {
+            std::string_view name = tag.empty() || tag[0] != '/' ? std::string_view{} : localName(trimView(tag.substr(1)));
+            if ((name == "url" || name == "sitemap") && inEntry_)
+            {
+                if (!current_.loc.empty())
+                {
+                    entries_++;
+                    handler_(current_);
+                }
+                inEntry_ = false;
+            }
+            pos = close + 1;
+            continue;
+        }
+
+        // Открывающий тег: имя до пробела
+        std::string_view name = localName(tag.substr(0, tag.find_first_of(" \t\r\n/")));
+        if (name == "url" || name == "sitemap")
+        {
+            current_ = Entry();
+            current_.isSitemap = name == "sitemap";
+            inEntry_ = true;
+            pos = close + 1;
+            continue;
+        }
+
+        if (inEntry_ && (name == "loc" || name == "lastmod"))
+        {
+            // Ждём закрывающий тег целиком
+            size_t textEnd = buffer_.find('<', close + 1);
+            if (textEnd == std::string::npos)
+            {
+                pos = open;
+                break;
+            }
+            size_t textClose = buffer_.find('>', textEnd);
+            if (textClose == std::string::npos)
+            {
+                pos = open;
+                break;
+            }
+
+            handleElement(name, std::string_view(buffer_.data() + close + 1, textEnd - close - 1));
+            pos = textClose + 1;
+            continue;
+        }
+
+        pos = close + 1;
+    }
+
+    buffer_.erase(0, pos);
+}
+
+void SitemapParser::handleElement(std::string_view name, std::string_view text)
+{
+    if (name == "loc")
+    {
+        current_.loc = decodeEntities(trimView(text));
+    }
+    else
+    {
+        current_.lastModified = parseW3cDate(trimView(text));
+    }
+}
+
+long long SitemapParser::getEntries() const
+{
+    return entries_;
+}
+
+long long SitemapParser::parseW3cDate(std::string_view value)
+{
+    if (value.size() < 4)
+    {
+        return 0;
+    }
+
+    auto number = [&](size_t offset, size_t length) -> int {
+        if (offset + length > value.size())
+        {
+            return -1;
+        }
+        int result = 0;
+        for (size_t i = offset; i < offset + length; ++i)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(value[i])))
+            {
+                return -1;
+            }
+            result = result * 10 + (value[i] - '0');
+        }
+        return result;
+    };
+
+    int year = number(0, 4);
+    int month = value.size() >= 7 ? number(5, 2) : 1;
+    int day = value.size() >= 10 ? number(8, 2) : 1;
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31)
+    {
+        return 0;
+    }
+
+    long long seconds = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86400;
+
+    // Время и часовой пояс
+    if (value.size() >= 16 && value[10] == 'T')
+    {
+        int hour = number(11, 2);
+        int minute = number(14, 2);
+        int second = value.size() >= 19 && value[16] == ':' ? number(17, 2) : 0;
+        if (hour < 0 || minute < 0 || second < 0)
+        {
+            return seconds;
+        }
+        seconds += hour * 3600 + minute * 60 + second;
+
+        size_t zonePos = value.find_first_of("Z+-", 16);
+        if (zonePos != std::string_view::npos && value[zonePos] != 'Z')
+        {
+            int zoneHour = number(zonePos + 1, 2);
+            int zoneMinute = number(zonePos + 4, 2);
+            if (zoneHour >= 0 && zoneMinute >= 0)
+            {
+                int offset = zoneHour * 3600 + zoneMinute * 60;
+                seconds += value[zonePos] == '+' ? -offset : offset;
+            }
+        }
+    }
+
+    return seconds;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef SITEMAPPARSER_H
+#define SITEMAPPARSER_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+
+// Потоковый разбор sitemap.xml и sitemap-индексов (sitemaps.org).
+// Данные подаются кусками по мере загрузки, поэтому файл на десятки
+// мегабайт не держится в памяти целиком: в буфере остаётся только
+// незаконченный элемент. Полный XML-разбор не нужен - интересны лишь
+// <loc> и <lastmod> внутри <url> или <sitemap>.
+class SitemapParser
+{
+public:
+    struct Entry
+    {
+        std::string loc;
+        long long lastModified = 0;  // Unix-время из <lastmod> (0 - не указано)
+        bool isSitemap = false;      // запись индекса: ссылка на другую карту
+    };
+
+    using EntryHandler = std::function<void(const Entry& entry)>;
+
+    explicit SitemapParser(EntryHandler handler);
+
+    // Очередной кусок документа
+    void feed(const char* data, size_t size);
+
+    // Число найденных записей
+    long long getEntries() const;
+
+    // Разбор даты W3C Datetime ("2024-05-01", "2024-05-01T10:00:00+03:00")
+    static long long parseW3cDate(std::string_view value);
+
+private:
+    EntryHandler handler_;
+    std::string buffer_;
+    Entry current_;
+    bool inEntry_;
+    long long entries_;
+
+    // Разбор всех законченных тегов буфера; хвост с началом тега остаётся
+    void parseBuffer();
+    void handleElement(std::string_view name, std::string_view text);
+};
+
+#endif // SITEMAPPARSER_H
\ No newline at end of file
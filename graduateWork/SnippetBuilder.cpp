@@ -0,0 +1,134 @@
+#include "SnippetBuilder.h"
+#include "PositionList.h"
+#include <algorithm>
+
+namespace
+{
+    // Слов контекста перед первым словом запроса, если окно позволяет
+    constexpr uint32_t kLeadWords = 3;
+}
+
+std::string SnippetBuilder::encodeWordOffsets(std::string_view text)
+{
+    std::vector<uint32_t> offsets;
+    offsets.reserve(text.size() / (kOffsetStep * 6) + 1);
+
+    uint32_t characters = 0;
+    uint32_t word = 0;
+    bool inWord = false;
+    for (char c : text)
+    {
+        if (c == ' ')
+        {
+            inWord = false;
+        }
+        else if (!inWord)
+        {
+            if (word % kOffsetStep == 0)
+            {
+                offsets.push_back(characters);
+            }
+            word++;
+            inWord = true;
+        }
+
+        // Символ UTF-8 - байт, не являющийся продолжением
+        characters += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+    }
+
+    // Последним записывается длина текста - конец диапазона для последних окон
+    offsets.push_back(characters);
+
+    std::string encoded;
+    PositionList::encode(offsets, encoded);
+    return encoded;
+}
+
+uint32_t SnippetBuilder::chooseWindow(const std::vector<std::vector<uint32_t>>& lists,
+    std::vector<uint32_t>& highlights)
+{
+    highlights.clear();
+
+    // Все вхождения слов запроса по порядку
+    std::vector<std::pair<uint32_t, size_t>> hits;
+    for (size_t term = 0; term < lists.size(); ++term)
+    {
+        for (uint32_t position : lists[term])
+        {
+            hits.emplace_back(position, term);
+        }
+    }
+    if (hits.empty())
+    {
+        return 0;
+    }
+    std::sort(hits.begin(), hits.end());
+
+    // Скользящее окно по вхождениям: не шире kWindowWords слов
+    std::vector<uint32_t> counts(lists.size(), 0);
+    size_t distinct = 0;
+    size_t bestLeft = 0;
+    size_t bestRight = 0;
+    size_t bestDistinct = 0;
+    size_t left = 0;
+    for (size_t right = 0; right < hits.size(); ++right)
+    {
+        if (counts[hits[right].second]++ == 0)
+        {
+            distinct++;
+        }
+        while (hits[right].first - hits[left].first >= kWindowWords)
+        {
+            if (--counts[hits[left].second] == 0)
+            {
+                distinct--;
+            }
+            left++;
+        }
+
+        if (distinct > bestDistinct || (distinct == bestDistinct && right - left > bestRight - bestLeft))
+        {
+            bestDistinct = distinct;
+            bestLeft = left;
+            bestRight = right;
+        }
+    }
+
+    // Немного контекста перед первым вхождением, если окно позволяет
+    uint32_t first = hits[bestLeft].first;
+    uint32_t span = hits[bestRight].first - first + 1;
+    uint32_t lead = std::min(kLeadWords, kWindowWords - span);
+    uint32_t start = first > lead ? first - lead : 0;
+
+    for (const auto& [position, term] : hits)
+    {
+        if (position >= start && position < start + kWindowWords)
+        {
+            highlights.push_back(position);
+        }
+    }
+    return start;
+}
+
+bool SnippetBuilder::findRange(std::string_view encodedOffsets, uint32_t start, Range& range)
+{
+    std::vector<uint32_t> offsets;
+    PositionList::decode(encodedOffsets, offsets);
+    // Хотя бы одно слово и длина текста
+    if (offsets.size() < 2)
+    {
+        return false;
+    }
+
+    // Ближайшее сохранённое смещение не позже начала окна и первое после
+    // его конца (или конец текста)
+    size_t end = offsets.size() - 1;
+    size_t first = std::min<size_t>(start / kOffsetStep, end - 1);
+    size_t last = std::min<size_t>((start + kWindowWords + kOffsetStep - 1) / kOffsetStep, end);
+
+    range.firstWord = static_cast<uint32_t>(first) * kOffsetStep;
+    range.from = offsets[first];
+    range.length = offsets[last] - offsets[first];
+    range.truncated = last < end;
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef SNIPPETBUILDER_H
+#define SNIPPETBUILDER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Фрагменты текста для выдачи (сниппеты) без чтения документа целиком.
+// Индексатор сохраняет смещения (в символах) каждого kOffsetStep-го слова
+// текста страницы. При поиске по позициям слов запроса выбирается окно из
+// kWindowWords слов, где слов запроса больше всего, и из БД читаются
+// только символы между ближайшими к окну сохранёнными смещениями.
+// Текст страницы - слова через один пробел (HtmlTokenizer::getText).
+class SnippetBuilder
+{
+public:
+    static constexpr uint32_t kOffsetStep = 16;
+    static constexpr uint32_t kWindowWords = 24;
+
+    // Смещения слов 0, kOffsetStep, 2 * kOffsetStep... и длина текста
+    // в символах (не байтах: substring в PostgreSQL считает символы),
+    // в формате PositionList
+    static std::string encodeWordOffsets(std::string_view text);
+
+    // Первое слово лучшего окна: больше разных слов запроса, затем больше
+    // вхождений. highlights - позиции слов запроса в окне по возрастанию
+    static uint32_t chooseWindow(const std::vector<std::vector<uint32_t>>& lists,
+        std::vector<uint32_t>& highlights);
+
+    // Символы текста, покрывающие окно, начинающееся со слова start
+    struct Range
+    {
+        uint32_t firstWord = 0;   // номер слова, с которого начинается диапазон
+        uint32_t from = 0;        // с нуля, в символах
+        uint32_t length = 0;      // в символах
+        bool truncated = false;   // после диапазона есть ещё текст
+    };
+
+    // false - смещения не записаны или повреждены
+    static bool findRange(std::string_view encodedOffsets, uint32_t start, Range& range);
+};
+
+#endif // SNIPPETBUILDER_H
\ No newline at end of file
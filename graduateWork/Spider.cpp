@@ -1,249 +1,1425 @@
 #include "Spider.h"
 #include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <random>
+
+namespace
+{
+    // Лимиты robots.txt (RFC 9309 требует читать не меньше 500 КиБ) и карт сайта
+    constexpr size_t kMaxRobotsSize = 512 * 1024;
+    constexpr size_t kMaxSitemapSize = 64 * 1024 * 1024;
+    constexpr int kMaxSitemapFiles = 100;
+    constexpr size_t kSitemapQueueCapacity = 4096;
+
+    // Замер времени обработки одного элемента стадией
+    template<typename Counters>
+    class StageTimer
+    {
+    public:
+        explicit StageTimer(Counters& stage)
+            : stage_(stage)
+            , start_(std::chrono::steady_clock::now())
+        {
+            stage_.busy++;
+        }
+
+        ~StageTimer()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            long long micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+            stage_.busyMicros += micros;
+            stage_.latency.record(micros);
+            stage_.busy--;
+        }
+
+    private:
+        Counters& stage_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Размер потоков стадии: 0 в конфигурации означает "по числу ядер"
+    int resolveWorkers(int configured, int fallback)
+    {
+        return configured > 0 ? configured : std::max(1, fallback);
+    }
+
+    double elapsedMillis(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Сбой, за который отвечает хост: сеть, таймаут, 5xx, 429
+    bool isHostFailure(const DownloadError& error)
+    {
+        switch (error.getKind())
+        {
+        case DownloadError::Kind::Transport:
+        case DownloadError::Kind::Timeout:
+            return true;
+        case DownloadError::Kind::Http:
+            return error.getHttpCode() >= 500 || error.getHttpCode() == 429;
+        default:
+            return false;
+        }
+    }
+
+    // Временный сбой, после которого имеет смысл повторить загрузку
+    bool isRetryable(const DownloadError& error)
+    {
+        return isHostFailure(error) ||
+            (error.getKind() == DownloadError::Kind::Http && error.getHttpCode() == 408);
+    }
+
+    // Экспоненциальная задержка со случайным разбросом: от половины
+    // до целой задержки, чтобы повторы разных задач не приходили
+    // на хост одновременно
+    std::chrono::milliseconds retryDelay(int attempt, int baseMs, int maxMs)
+    {
+        thread_local std::mt19937 generator(std::random_device{}());
+        long long delay = std::min<long long>(static_cast<long long>(baseMs) << std::min(attempt - 1, 20), maxMs);
+        std::uniform_int_distribution<long long> jitter(delay / 2, std::max(delay, 1LL));
+        return std::chrono::milliseconds(jitter(generator));
+    }
+
+    RecrawlScheduler::Settings makeRecrawlSettings(const Config& config)
+    {
+        RecrawlScheduler::Settings settings;
+        settings.minInterval = std::chrono::seconds(std::max(1, config.getSpiderRecrawlMinInterval()));
+        settings.maxInterval = std::chrono::seconds(std::max(1, config.getSpiderRecrawlMaxInterval()));
+        settings.initialInterval = std::chrono::seconds(std::max(1, config.getSpiderRecrawlInitialInterval()));
+        settings.budgetPerMinute = std::max(1, config.getSpiderRecrawlBudget());
+        return settings;
+    }
+
+    HostHealth::Settings makeHostHealthSettings(const Config& config)
+    {
+        HostHealth::Settings settings;
+        settings.failureThreshold = std::max(1, config.getSpiderBreakerFailures());
+        settings.openDuration = std::chrono::seconds(std::max(1, config.getSpiderBreakerOpenSeconds()));
+        settings.minTimeoutMs = config.getSpiderMinFetchTimeoutMs();
+        settings.maxTimeoutMs = std::max<long>(config.getSpiderMinFetchTimeoutMs(), config.getSpiderMaxFetchTimeoutMs());
+        return settings;
+    }
+
+    int hardwareThreads()
+    {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        return cores > 0 ? cores : 2; // fallback
+    }
+
+    // Ограничитель загрузок: при выключенной адаптации лимит фиксирован
+    ConcurrencyLimiter makeFetchLimiter(const Config& config)
+    {
+        int initial = resolveWorkers(config.getSpiderFetchWorkers(), hardwareThreads() * 4);
+        if (!config.isAdaptiveConcurrency())
+        {
+            return ConcurrencyLimiter(initial, initial, initial);
+        }
+
+        int maxLimit = resolveWorkers(config.getSpiderMaxFetchConcurrency(), std::min(hardwareThreads() * 32, 512));
+        return ConcurrencyLimiter(initial, config.getSpiderMinFetchConcurrency(), maxLimit);
+    }
+
+    // Каталог состояния: у каждого шарда свой подкаталог
+    std::string resolveStateDir(const Config& config)
+    {
+        if (config.getSpiderStateDir().empty() || config.getSpiderShardPeers().size() < 2)
+        {
+            return config.getSpiderStateDir();
+        }
+
+        std::filesystem::path dir(config.getSpiderStateDir());
+        return (dir / ("shard" + std::to_string(config.getSpiderShardIndex()))).string();
+    }
+}
 
 Spider::Spider(Config& config, Database& db)
     : config_(config)
     , database_(db)
+    , downloader_(config)
+    , indexer_(Stemmer::fromNames(config.getIndexStemmers()),
+        StopWords(Stemmer::parseLanguages(config.getIndexStopWords()), config.getIndexStopWordsFile()))
+    , fetcher_(&downloader_)
+    , frontier_(resolveStateDir(config), static_cast<size_t>(config.getSpiderFrontierMemoryLimit()))
+    , parseQueue_(static_cast<size_t>(config.getSpiderStageQueueCapacity()))
+    , indexQueue_(static_cast<size_t>(config.getSpiderStageQueueCapacity()))
+    , storeQueue_(static_cast<size_t>(config.getSpiderStageQueueCapacity()))
+    , fetchLimiter_(makeFetchLimiter(config))
+    , duplicatePolicy_(DuplicatePolicy::Skip)
+    , duplicates_(static_cast<size_t>(config.getSpiderDuplicateHistory()), config.getSpiderDuplicateMaxDistance())
+    , sitemapQueue_(kSitemapQueueCapacity)
+    , sitemapUrls_(0)
+    , hostHealth_(makeHostHealthSettings(config))
+    , retries_(0)
+    , hostsParked_(0)
     , stopRequested_(false)
     , activeWorkers_(0)
+    , pendingSitemaps_(0)
+    , completed_(false)
+    , completion_(completionPromise_.get_future().share())
+    , statsVersion_(0)
     , pagesDownloaded_(0)
     , pagesIndexed_(0)
 {
-    // Начинаем со стартовой страницы
-    addTask(config_.getSpiderStartUrl(), 0);
+    if (config_.getSpiderDuplicatePolicy() == "off")
+    {
+        duplicatePolicy_ = DuplicatePolicy::Off;
+    }
+    else if (config_.getSpiderDuplicatePolicy() == "collapse")
+    {
+        duplicatePolicy_ = DuplicatePolicy::Collapse;
+    }
+
+    // Воспроизведение архива имеет приоритет: сеть в этом режиме не нужна
+    if (!config_.getSpiderWarcReplayPath().empty())
+    {
+        warcReplay_ = std::make_unique<WarcReplayFetcher>(config_.getSpiderWarcReplayPath(), downloader_.getUrlNormalizer());
+        fetcher_ = warcReplay_.get();
+    }
+    else if (!config_.getSpiderWarcRecordPath().empty())
+    {
+        warcWriter_ = std::make_unique<WarcWriter>(config_.getSpiderWarcRecordPath());
+        downloader_.setRecorder(warcWriter_.get());
+    }
+
+    downloader_.setHostHealth(&hostHealth_);
+
+    // robots.txt и карты сайта нужны только при загрузке из сети
+    if (fetcher_ == &downloader_ && (config_.shouldRespectRobots() || config_.shouldUseSitemaps()))
+    {
+        robots_ = std::make_unique<RobotsCache>(
+            [this](const std::string& robotsUrl) { return downloader_.downloadResource(robotsUrl, kMaxRobotsSize); },
+            "SearchEngineBot", std::chrono::seconds(config_.getSpiderRobotsCacheTtl()),
+            static_cast<size_t>(config_.getSpiderRobotsCacheHosts()));
+
+        robots_->setFetchedHandler([this](const std::string& origin, const RobotsRules& rules) {
+            onRobotsFetched(origin, rules);
+            });
+    }
+
+    // Непрерывный обход: расписание переживает перезапуски вместе с очередью
+    if (config_.isContinuousCrawl())
+    {
+        recrawl_ = std::make_unique<RecrawlScheduler>(makeRecrawlSettings(config_));
+        if (frontier_.isPersistent() && recrawl_->load(frontier_.statePath("recrawl.checkpoint")))
+        {
+            std::cout << "♻️  Расписание повторных визитов: " << recrawl_->getTracked() << " страниц" << std::endl;
+        }
+    }
+
+    // Стартовый URL приводим к той же форме, что и найденные ссылки
+    std::string startUrl = downloader_.getUrlNormalizer().normalize(config_.getSpiderStartUrl());
+    if (startUrl.empty())
+    {
+        startUrl = config_.getSpiderStartUrl();
+    }
+
+    // Шардированный обход: каждый процесс отвечает за свою часть хостов
+    if (config_.getSpiderShardPeers().size() > 1)
+    {
+        shardRouter_ = std::make_unique<ShardRouter>(config_.getSpiderShardIndex(), config_.getSpiderShardPeers(),
+            static_cast<size_t>(config_.getSpiderShardBatchSize()), config_.getSpiderShardFlushMillis());
+    }
+
+    // Продолжаем прерванный обход или начинаем со стартовой страницы.
+    // Стартовую страницу берёт только шард, владеющий её хостом
+    bool ownsStartUrl = !shardRouter_ || shardRouter_->isLocal(startUrl);
+    if (!restoreState() && ownsStartUrl && processedUrls_.insertIfAbsent(startUrl))
+    {
+        addTask(startUrl, 0);
+    }
 }
 
-Spider::~Spider()
-{
-    stop();
+Spider::~Spider()
+{
+    stop();
+}
+
+void Spider::addTask(const std::string& url, int depth)
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+
+    // Проверяем, не превышена ли глубина
+    if (depth > config_.getSpiderMaxDepth())
+    {
+        return;
+    }
+
+    // Добавляем задачу в очередь
+    frontier_.push({ url, depth });
+    queueCV_.notify_one();
+}
+
+bool Spider::restoreState()
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!frontier_.restore())
+        {
+            return false;
+        }
+
+        // Ссылки, которые не успели уйти другим шардам
+        std::vector<std::pair<std::string, int>> outbox;
+        if (shardRouter_)
+        {
+            std::ifstream outboxIn(frontier_.statePath("outbox.checkpoint"), std::ios::binary);
+            std::string line;
+            std::string link;
+            int depth = 0;
+            while (std::getline(outboxIn, line))
+            {
+                if (ShardRouter::parseLink(line, link, depth))
+                {
+                    outbox.emplace_back(std::move(link), depth);
+                }
+                else
+                {
+                    shardRouter_->restoreCounters(line);
+                }
+            }
+        }
+
+        // Восстанавливать нечего: без задач в очереди обход сразу бы
+        // завершился, поэтому начинаем заново со стартовой страницы
+        if (frontier_.empty() && outbox.empty())
+        {
+            std::cout << "♻️  Контрольная точка в " << config_.getSpiderStateDir()
+                << " не содержит задач, обход начнётся заново" << std::endl;
+            return false;
+        }
+
+        std::ifstream in(frontier_.statePath("visited.checkpoint"), std::ios::binary);
+        std::string url;
+        while (std::getline(in, url))
+        {
+            if (!url.empty())
+            {
+                processedUrls_.insertIfAbsent(url);
+            }
+        }
+
+        for (const auto& [link, depth] : outbox)
+        {
+            shardRouter_->forward(link, depth);
+        }
+
+        std::cout << "♻️  Состояние обхода восстановлено из " << config_.getSpiderStateDir() << std::endl;
+        std::cout << "   В очереди: " << frontier_.size() << std::endl;
+        std::cout << "   Посещено URL: " << processedUrls_.size() << std::endl;
+        if (shardRouter_)
+        {
+            std::cout << "   Ссылок для других шардов: " << outbox.size() << std::endl;
+        }
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "⚠️  Не удалось восстановить состояние обхода: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void Spider::saveCheckpoint()
+{
+    if (!frontier_.isPersistent())
+    {
+        return;
+    }
+
+    try
+    {
+        // Контрольную точку пишет один поток за раз: периодический
+        // и финальный вызовы используют одни и те же файлы
+        std::lock_guard<std::mutex> writeLock(checkpointWriteMutex_);
+
+        // Под блокировкой только снимаем состояние в памяти: обнаружение
+        // ссылок стоит, пока копируются URL, но не пока они пишутся на диск
+        std::vector<std::string> visited;
+        std::string outbox;
+        CrawlFrontier::Snapshot frontierSnapshot;
+        {
+            std::unique_lock<std::shared_mutex> checkpointLock(checkpointMutex_);
+            visited = processedUrls_.snapshot();
+
+            // Ссылки для других шардов, ещё не доставленные владельцам
+            if (shardRouter_)
+            {
+                outbox = shardRouter_->snapshotOutbox();
+            }
+
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            std::vector<DownloadTask> inFlight;
+            inFlight.reserve(inFlightTasks_.size());
+            for (const auto& [url, task] : inFlightTasks_)
+            {
+                inFlight.push_back(task);
+            }
+            frontierSnapshot = frontier_.snapshot(inFlight);
+        }
+
+        // Сначала посещённые URL, затем манифест очереди: манифест
+        // служит точкой фиксации всей контрольной точки
+        std::string visitedPath = frontier_.statePath("visited.checkpoint");
+        {
+            std::ofstream out(visitedPath + ".tmp", std::ios::binary | std::ios::trunc);
+            for (const auto& url : visited)
+            {
+                out << url << '\n';
+            }
+
+            out.flush();
+            if (!out)
+            {
+                throw std::runtime_error("Ошибка записи " + visitedPath + ".tmp");
+            }
+        }
+        std::filesystem::rename(visitedPath + ".tmp", visitedPath);
+
+        if (shardRouter_)
+        {
+            std::string outboxPath = frontier_.statePath("outbox.checkpoint");
+            {
+                std::ofstream out(outboxPath + ".tmp", std::ios::binary | std::ios::trunc);
+                out << outbox;
+
+                out.flush();
+                if (!out)
+                {
+                    throw std::runtime_error("Ошибка записи " + outboxPath + ".tmp");
+                }
+            }
+            std::filesystem::rename(outboxPath + ".tmp", outboxPath);
+        }
+
+        frontier_.writeCheckpoint(frontierSnapshot);
+
+        if (recrawl_)
+        {
+            recrawl_->save(frontier_.statePath("recrawl.checkpoint"));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "⚠️  Ошибка сохранения контрольной точки: " << e.what() << std::endl;
+    }
+}
+
+void Spider::checkpointLoop()
+{
+    auto interval = std::chrono::seconds(std::max(1, config_.getSpiderCheckpointInterval()));
+
+    while (!stopRequested_)
+    {
+        {
+            std::unique_lock<std::mutex> lock(checkpointWaitMutex_);
+            checkpointCV_.wait_for(lock, interval, [this]() { return stopRequested_.load(); });
+        }
+
+        if (!stopRequested_)
+        {
+            saveCheckpoint();
+        }
+    }
+}
+
+void Spider::acceptRemoteLink(const std::string& url, int depth)
+{
+    std::shared_lock<std::shared_mutex> checkpointLock(checkpointMutex_);
+    if (processedUrls_.insertIfAbsent(url))
+    {
+        addTask(url, depth);
+    }
+}
+
+void Spider::delayTask(DownloadTask task, std::chrono::steady_clock::time_point readyAt)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    inFlightTasks_[task.url] = task;
+    delayedTasks_.push({ readyAt, std::move(task), {} });
+    delayedCV_.notify_one();
+}
+
+void Spider::parkTask(const std::string& host, DownloadTask task, std::chrono::steady_clock::time_point readyAt)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    ParkedHost& parked = parkedHosts_[host];
+    parked.tasks.push_back(std::move(task));
+    hostsParked_++;
+
+    // Хост уже ждёт - задача просто встаёт в его очередь
+    if (parked.tasks.size() == 1 || readyAt < parked.readyAt)
+    {
+        parked.readyAt = readyAt;
+        delayedTasks_.push({ readyAt, {}, host });
+        delayedCV_.notify_one();
+    }
+}
+
+void Spider::wakeParkedHost(const std::string& host)
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    auto it = parkedHosts_.find(host);
+    if (it == parkedHosts_.end())
+    {
+        return;
+    }
+
+    // Прежняя запись в delayedTasks_ станет устаревшей и будет пропущена
+    it->second.readyAt = std::chrono::steady_clock::now();
+    delayedTasks_.push({ it->second.readyAt, {}, host });
+    delayedCV_.notify_one();
+}
+
+void Spider::releaseParkedHost(const std::string& host, std::chrono::steady_clock::time_point readyAt)
+{
+    auto it = parkedHosts_.find(host);
+    if (it == parkedHosts_.end() || it->second.readyAt != readyAt)
+    {
+        return;
+    }
+
+    // При Crawl-delay задачи возвращаются по одной за задержку: всей
+    // очереди хоста пришлось бы тут же снова встать в ожидание
+    ParkedHost& parked = it->second;
+    auto crawlDelay = hostHealth_.getCrawlDelay(host);
+    size_t count = crawlDelay.count() > 0 ? 1 : parked.tasks.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        DownloadTask task = std::move(parked.tasks.front());
+        parked.tasks.pop_front();
+        inFlightTasks_.erase(task.url);
+        frontier_.push(task);
+    }
+    hostsParked_ -= static_cast<long long>(count);
+
+    if (parked.tasks.empty())
+    {
+        parkedHosts_.erase(it);
+    }
+    else
+    {
+        parked.readyAt = std::chrono::steady_clock::now() + crawlDelay;
+        delayedTasks_.push({ parked.readyAt, {}, host });
+    }
+}
+
+void Spider::delayedLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    while (!stopRequested_)
+    {
+        if (delayedTasks_.empty())
+        {
+            delayedCV_.wait(lock);
+        }
+        else
+        {
+            delayedCV_.wait_until(lock, delayedTasks_.top().readyAt);
+        }
+
+        // Наступившие задачи возвращаются в очередь обхода
+        auto now = std::chrono::steady_clock::now();
+        bool moved = false;
+        while (!delayedTasks_.empty() && delayedTasks_.top().readyAt <= now)
+        {
+            DelayedTask entry = delayedTasks_.top();
+            delayedTasks_.pop();
+            if (!entry.host.empty())
+            {
+                releaseParkedHost(entry.host, entry.readyAt);
+            }
+            else
+            {
+                inFlightTasks_.erase(entry.task.url);
+                frontier_.push(entry.task);
+            }
+            moved = true;
+        }
+
+        if (moved)
+        {
+            queueCV_.notify_all();
+        }
+    }
+}
+
+void Spider::recrawlLoop()
+{
+    // Повторные визиты не должны вытеснять обнаружение новых страниц:
+    // очередь пополняется, только пока в ней есть место в памяти
+    const size_t backlogLimit = static_cast<size_t>(std::max(1, config_.getSpiderFrontierMemoryLimit()));
+
+    while (!stopRequested_)
+    {
+        {
+            std::unique_lock<std::mutex> lock(recrawlWaitMutex_);
+            recrawlCV_.wait_for(lock, std::chrono::seconds(1), [this]() { return stopRequested_.load(); });
+        }
+
+        if (stopRequested_)
+        {
+            break;
+        }
+
+        size_t backlog;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            backlog = frontier_.size();
+        }
+        if (backlog >= backlogLimit)
+        {
+            continue;
+        }
+
+        auto visits = recrawl_->takeDue(backlogLimit - backlog);
+        if (visits.empty())
+        {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        for (const auto& visit : visits)
+        {
+            // Страница ещё в конвейере с прошлого визита
+            if (inFlightTasks_.count(visit.url) == 0)
+            {
+                frontier_.push({ visit.url, visit.depth });
+            }
+        }
+        queueCV_.notify_all();
+    }
+}
+
+void Spider::dropGonePage(const std::string& url)
+{
+    recrawl_->forget(url);
+
+    try
+    {
+        int documentId = database_.getDocumentIdByUrl(url);
+        if (documentId > 0)
+        {
+            database_.deleteDocument(documentId);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[" << std::this_thread::get_id() << "] Ошибка удаления " << url << ": " << e.what() << std::endl;
+    }
+}
+
+void Spider::finishTask(const std::string& url)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        inFlightTasks_.erase(url);
+        statsVersion_++;
+    }
+    statsCV_.notify_all();
+
+    checkCompletion();
+}
+
+bool Spider::isQuiescent() const
+{
+    return frontier_.empty() && inFlightTasks_.empty() && pendingSitemaps_ == 0;
+}
+
+void Spider::checkCompletion()
+{
+    // Непрерывный обход сам не завершается. Простой одного шарда ещё
+    // ничего не значит: работа может прийти от другого, поэтому
+    // шардированный обход завершает ShardRouter, когда простаивают все
+    if (recrawl_ || shardRouter_)
+    {
+        return;
+    }
+
+    completeIfQuiescent();
+}
+
+void Spider::completeIfQuiescent()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (completed_ || stopRequested_ || !isQuiescent())
+        {
+            return;
+        }
+        completed_ = true;
+    }
+
+    completeCrawl();
+}
+
+void Spider::completeCrawl()
+{
+    std::cout << "[" << std::this_thread::get_id() << "] Очередь пуста, обход завершён" << std::endl;
+
+    // Потоки выходят сами: очереди стадий пусты, новых задач не будет
+    stopRequested_ = true;
+    wakeWorkers();
+
+    completionPromise_.set_value();
+
+    std::vector<std::function<void()>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(callbacksMutex_);
+        callbacks.swap(completionCallbacks_);
+    }
+    for (auto& callback : callbacks)
+    {
+        callback();
+    }
+}
+
+void Spider::wakeWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        queueCV_.notify_all();
+        delayedCV_.notify_all();
+        statsCV_.notify_all();
+    }
+    fetchLimiter_.close();
+    parseQueue_.close();
+    indexQueue_.close();
+    storeQueue_.close();
+    sitemapQueue_.close();
+    {
+        std::lock_guard<std::mutex> lock(checkpointWaitMutex_);
+        checkpointCV_.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(recrawlWaitMutex_);
+        recrawlCV_.notify_all();
+    }
+}
+
+void Spider::fetchWorker()
+{
+    activeWorkers_++;
+
+    while (!stopRequested_)
+    {
+        // Сначала получаем слот у ограничителя: лишние потоки загрузки
+        // ждут здесь и не занимают ни сеть, ни задачи из очереди
+        if (!fetchLimiter_.acquire())
+        {
+            break;
+        }
+
+        DownloadTask task;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+
+            // Ждём задачу или команду остановки
+            queueCV_.wait(lock, [this]() {
+                return !frontier_.empty() || stopRequested_;
+                });
+
+            if (stopRequested_)
+            {
+                fetchLimiter_.cancel();
+                break;
+            }
+
+            // Берём задачу из очереди
+            if (!frontier_.pop(task))
+            {
+                fetchLimiter_.cancel();
+                continue;
+            }
+            inFlightTasks_[task.url] = task;
+        }
+
+        PageItem item;
+        bool fetched = false;
+
+        // Время, до которого задачу нужно отложить (повтор или хост, к
+        // которому пока нельзя обращаться)
+        bool delayed = false;
+        bool parked = false;
+        std::chrono::steady_clock::time_point readyAt;
+        std::string host(UrlNormalizer::parse(task.url).authority);
+        {
+            StageTimer<StageCounters> timer(fetchStage_);
+            auto startTime = std::chrono::steady_clock::now();
+            bool attempted = false;
+            bool overload = false;
+            bool reclosed = false;
+
+            // Страница из расписания повторных визитов загружается,
+            // даже если она уже есть в БД
+            item.revisit = recrawl_ && recrawl_->isTracked(task.url);
+
+            try
+            {
+                // Проверяем, существует ли уже документ в БД
+                if (!item.revisit && database_.urlExists(task.url))
+                {
+                    std::cout << "[" << std::this_thread::get_id() << "] Документ уже существует в БД: " << task.url << std::endl;
+
+                    // Документ прошлых обходов: будем проверять его по расписанию
+                    if (recrawl_)
+                    {
+                        recrawl_->track(task.url, task.depth);
+                    }
+                }
+                else if (auto access = robotsAccess(task.url, readyAt); access != RobotsCache::Access::Allowed)
+                {
+                    // Недоступный robots.txt по RFC 9309 запрещает всё, но
+                    // только временно: задача повторяется, как после сбоя
+                    if (access == RobotsCache::Access::Disallowed)
+                    {
+                        std::cout << "[" << std::this_thread::get_id() << "] Запрещено robots.txt: " << task.url << std::endl;
+                    }
+                    else if (task.attempt < config_.getSpiderMaxRetries())
+                    {
+                        task.attempt++;
+                        delayed = true;
+                    }
+                    else
+                    {
+                        std::cout << "[" << std::this_thread::get_id() << "] robots.txt недоступен, пропуск: " << task.url << std::endl;
+                    }
+                }
+                else if (!hostHealth_.tryAcquire(host, readyAt))
+                {
+                    // Хост отключён или не вышел Crawl-delay: задача ждёт
+                    // вместе с остальными задачами хоста
+                    parked = true;
+                }
+                else
+                {
+                    std::cout << "[" << std::this_thread::get_id() << "] Скачивание [" << task.depth << "]: " << task.url << std::endl;
+                    attempted = true;
+
+                    // При непрерывном обходе запрос условный: неизменённая
+                    // страница приходит ответом 304 без тела
+                    bool modified = true;
+                    if (recrawl_)
+                    {
+                        modified = fetcher_->downloadIfModified(task.url, recrawl_->getValidators(task.url),
+                            item.html, item.validators);
+                    }
+                    else
+                    {
+                        item.html = fetcher_->download(task.url);
+                    }
+
+                    reclosed = hostHealth_.recordSuccess(host, elapsedMillis(startTime));
+                    fetchStage_.processed++;
+                    if (modified)
+                    {
+                        pagesDownloaded_++;
+                        fetched = true;
+                    }
+                    else
+                    {
+                        recrawl_->recordNotModified(task.url);
+                    }
+                }
+            }
+            catch (const DownloadError& e)
+            {
+                overload = e.isOverload();
+                fetchStage_.failed++;
+                std::cerr << "[" << std::this_thread::get_id() << "] Ошибка загрузки " << task.url << ": " << e.what() << std::endl;
+
+                // Сбои хоста копятся в автомате отключения, ответы 4xx
+                // и отброшенные ответы говорят о том, что хост жив
+                if (isHostFailure(e))
+                {
+                    hostHealth_.recordFailure(host, e.getKind() == DownloadError::Kind::Timeout);
+                }
+                else
+                {
+                    reclosed = hostHealth_.recordSuccess(host, elapsedMillis(startTime));
+                }
+
+                // Страница удалена с сайта - она не должна оставаться в индексе
+                if (item.revisit && e.getKind() == DownloadError::Kind::Http &&
+                    (e.getHttpCode() == 404 || e.getHttpCode() == 410))
+                {
+                    dropGonePage(task.url);
+                }
+                else if (isRetryable(e) && task.attempt < config_.getSpiderMaxRetries())
+                {
+                    task.attempt++;
+                    readyAt = std::chrono::steady_clock::now() + retryDelay(task.attempt,
+                        config_.getSpiderRetryBaseDelayMs(), config_.getSpiderRetryMaxDelayMs());
+                    delayed = true;
+                    retries_++;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                fetchStage_.failed++;
+                std::cerr << "[" << std::this_thread::get_id() << "] Ошибка загрузки " << task.url << ": " << e.what() << std::endl;
+                if (attempted)
+                {
+                    hostHealth_.recordFailure(host, false);
+                }
+            }
+
+            if (attempted)
+            {
+                // Обратная связь для ограничителя: задержка, перегрузка
+                // и заполненность очереди следующей стадии
+                double latencyMs = elapsedMillis(startTime);
+                bool saturated = parseQueue_.size() * 10 >= parseQueue_.capacity() * 9;
+                fetchLimiter_.release(host, latencyMs, overload, saturated);
+                growFetchWorkers();
+
+                // Пробный запрос удался: задачи хоста не ждут до таймаута
+                if (reclosed)
+                {
+                    wakeParkedHost(host);
+                }
+            }
+            else
+            {
+                fetchLimiter_.cancel();
+            }
+        }
+
+        if (parked)
+        {
+            parkTask(host, std::move(task), readyAt);
+            continue;
+        }
+
+        if (delayed)
+        {
+            delayTask(std::move(task), readyAt);
+            continue;
+        }
+
+        if (!fetched)
+        {
+            finishTask(task.url);
+            continue;
+        }
+
+        // Передаём страницу дальше (ждём, если стадия разбора не успевает)
+        item.task = std::move(task);
+        parseQueue_.push(std::move(item));
+    }
+
+    activeWorkers_--;
 }
 
-void Spider::addTask(const std::string& url, int depth)
+void Spider::parseWorker()
 {
-    std::unique_lock<std::mutex> lock(queueMutex_);
+    activeWorkers_++;
 
-    // Проверяем, не превышена ли глубина
-    if (depth > config_.getSpiderMaxDepth())
+    PageItem item;
+    while (parseQueue_.pop(item))
     {
-        return;
-    }
+        bool indexed = false;
+        {
+            StageTimer<StageCounters> timer(parseStage_);
+            try
+            {
+                // Один проход по HTML: текст, слова и ссылки. Ссылки нужны,
+                // только если не достигли максимальной глубины
+                bool followLinks = item.task.depth < config_.getSpiderMaxDepth();
+                item.result = indexer_.indexPage(item.html, item.task.url,
+                    followLinks ? &downloader_.getUrlNormalizer() : nullptr);
 
-    // Проверяем, не обрабатывали ли уже этот URL
-    {
-        std::lock_guard<std::mutex> processedLock(processedMutex_);
-        if (processedUrls_.find(url) != processedUrls_.end())
+                // Неразобранная страница не должна затереть в БД прошлую версию
+                if (!item.result.indexed)
+                {
+                    throw std::runtime_error("страница не разобрана");
+                }
+                pagesIndexed_++;
+                indexed = true;
+
+                if (followLinks)
+                {
+                    const auto& links = item.result.links;
+
+                    int addedCount = 0;
+                    std::shared_lock<std::shared_mutex> checkpointLock(checkpointMutex_);
+                    for (const auto& link : links)
+                    {
+                        // Хост другого шарда: ссылку отметит и обойдёт владелец
+                        if (shardRouter_ && !shardRouter_->isLocal(link))
+                        {
+                            shardRouter_->forward(link, item.task.depth + 1);
+                            continue;
+                        }
+
+                        // Атомарно отмечаем ссылку: в очередь попадает только
+                        // тот поток, который увидел её первым
+                        if (processedUrls_.insertIfAbsent(link))
+                        {
+                            addTask(link, item.task.depth + 1);
+                            addedCount++;
+                        }
+                    }
+
+                    std::cout << "[" << std::this_thread::get_id() << "] Ссылок: " << links.size()
+                        << ", новых: " << addedCount << " (" << item.task.url << ")" << std::endl;
+
+                    // Ссылки дальше не нужны
+                    std::vector<std::string>().swap(item.result.links);
+                }
+                parseStage_.processed++;
+            }
+            catch (const std::exception& e)
+            {
+                parseStage_.failed++;
+                std::cerr << "[" << std::this_thread::get_id() << "] Ошибка разбора " << item.task.url << ": " << e.what() << std::endl;
+            }
+        }
+
+        if (!indexed)
         {
-            return;
+            finishTask(item.task.url);
+            continue;
         }
+
+        indexQueue_.push(std::move(item));
     }
 
-    // Добавляем задачу в очередь
-    taskQueue_.push({ url, depth });
-    queueCV_.notify_one();
+    activeWorkers_--;
 }
 
-void Spider::workerFunction()
+void Spider::indexWorker()
 {
     activeWorkers_++;
 
-    while (!stopRequested_)
+    PageItem item;
+    while (indexQueue_.pop(item))
     {
-        DownloadTask task;
-
+        // Страница уже разобрана стадией parse: здесь решается, что из
+        // неё попадёт в индекс
+        bool store = true;
         {
-            std::unique_lock<std::mutex> lock(queueMutex_);
+            StageTimer<StageCounters> timer(indexStage_);
 
-            // Ждём задачу или команду остановки
-            queueCV_.wait(lock, [this]() {
-                return !taskQueue_.empty() || stopRequested_;
-                });
+            // Повторный визит без изменений текста: индекс уже актуален
+            if (recrawl_)
+            {
+                bool changed = recrawl_->recordFetch(item.task.url, item.task.depth,
+                    item.result.fingerprint.contentHash, item.validators);
+                if (item.revisit && !changed)
+                {
+                    std::cout << "[" << std::this_thread::get_id() << "] Без изменений: " << item.task.url << std::endl;
+                    store = false;
+                }
+            }
 
-            if (stopRequested_ && taskQueue_.empty())
+            // <meta name="robots" content="noindex">: документ без текста и слов.
+            // Проверяется до дубликатов: отпечаток такой страницы не должен
+            // делать дубликатами индексируемые копии её текста
+            if (store && item.result.noIndex)
             {
-                break;
+                std::cout << "[" << std::this_thread::get_id() << "] noindex: " << item.task.url << std::endl;
+                item.result.cleanContent.clear();
+                item.result.wordsFrequency.clear();
+                item.result.wordOffsets.clear();
             }
 
-            if (taskQueue_.empty())
+            // Дубликаты и почти-дубликаты не должны занимать место в индексе.
+            // Прошлая версия той же страницы дубликатом не считается
+            if (store && !item.result.noIndex && duplicatePolicy_ != DuplicatePolicy::Off)
             {
-                continue;
+                std::string originalUrl;
+                auto verdict = duplicates_.checkAndInsert(item.result.fingerprint, item.task.url, originalUrl);
+                if (verdict != DuplicateDetector::Verdict::Unique && originalUrl != item.task.url)
+                {
+                    std::cout << "[" << std::this_thread::get_id() << "] "
+                        << (verdict == DuplicateDetector::Verdict::ExactDuplicate ? "Дубликат" : "Почти-дубликат")
+                        << " " << originalUrl << ": " << item.task.url << std::endl;
+
+                    if (duplicatePolicy_ == DuplicatePolicy::Skip)
+                    {
+                        store = false;
+                    }
+                    else
+                    {
+                        // Collapse: документ сохраняется, чтобы URL не загружался
+                        // повторно, но без текста и без слов, как при noindex
+                        item.result.cleanContent.clear();
+                        item.result.wordsFrequency.clear();
+                        item.result.wordOffsets.clear();
+                    }
+                }
             }
 
-            // Берём задачу из очереди
-            task = taskQueue_.front();
-            taskQueue_.pop();
+            indexStage_.processed++;
         }
 
-        // Обрабатываем страницу
-        try
-        {
-            processPage(task.url, task.depth);
-        }
-        catch (const std::exception& e)
+        if (!store)
         {
-            std::cerr << "Ошибка в рабочем потоке при обработке "
-                << task.url << ": " << e.what() << std::endl;
+            finishTask(item.task.url);
+            continue;
         }
+
+        // HTML дальше не нужен - освобождаем память до постановки в очередь
+        std::string().swap(item.html);
+        storeQueue_.push(std::move(item));
     }
 
     activeWorkers_--;
 }
 
-void Spider::processPage(const std::string& url, int depth)
+void Spider::storeWorker()
 {
-    try
-    {
-        std::cout << "[" << std::this_thread::get_id() << "] Обработка [" << depth << "]: " << url << std::endl;
+    activeWorkers_++;
 
-        // Помечаем URL как обрабатываемый
+    PageItem item;
+    while (storeQueue_.pop(item))
+    {
         {
-            std::lock_guard<std::mutex> lock(processedMutex_);
-            if (processedUrls_.find(url) != processedUrls_.end())
+            StageTimer<StageCounters> timer(storeStage_);
+            try
+            {
+                int documentId = database_.savingDocument(item.task.url, item.result.title, item.result.cleanContent,
+                    item.result.wordOffsets);
+                if (documentId > 0 && (!item.result.wordsFrequency.empty() || item.revisit))
+                {
+                    database_.savingWords(documentId, item.result.wordsFrequency);
+                }
+                storeStage_.processed++;
+                std::cout << "[" << std::this_thread::get_id() << "] Сохранено в БД (ID: " << documentId << "): " << item.task.url << std::endl;
+            }
+            catch (const std::exception& e)
             {
-                std::cout << "[" << std::this_thread::get_id() << "] URL уже обработан: " << url << std::endl;
-                return;
+                storeStage_.failed++;
+                std::cerr << "[" << std::this_thread::get_id() << "] Ошибка сохранения в БД " << item.task.url << ": " << e.what() << std::endl;
             }
-            processedUrls_.insert(url);
         }
 
-        // Проверяем, существует ли уже документ в БД
-        if (database_.urlExists(url))
-        {
-            std::cout << "[" << std::this_thread::get_id() << "] Документ уже существует в БД: " << url << std::endl;
+        finishTask(item.task.url);
+    }
 
-            return;
-        }
+    activeWorkers_--;
+}
 
-        // Скачиваем страницу
-        std::string html;
-        try
-        {
-            std::cout << "[" << std::this_thread::get_id() << "] Скачивание: " << url << std::endl;
-            html = downloader_.download(url);
-            pagesDownloaded_++;
-            std::cout << "[" << std::this_thread::get_id() << "] Успешно загружено: " << html.size() << " байт" << std::endl;
-        }
-        catch (const std::exception& e)
+RobotsCache::Access Spider::robotsAccess(const std::string& url, std::chrono::steady_clock::time_point& retryAt)
+{
+    if (!robots_)
+    {
+        return RobotsCache::Access::Allowed;
+    }
+
+    if (config_.shouldRespectRobots())
+    {
+        return robots_->check(url, retryAt);
+    }
+
+    // robots.txt загружается только ради карт сайта
+    robots_->getRules(url);
+    return RobotsCache::Access::Allowed;
+}
+
+void Spider::onRobotsFetched(const std::string& origin, const RobotsRules& rules)
+{
+    // Crawl-delay соблюдается вместе с остальными правилами robots.txt
+    if (config_.shouldRespectRobots())
+    {
+        size_t schemeEnd = origin.find("://");
+        hostHealth_.setCrawlDelay(schemeEnd == std::string::npos ? origin : origin.substr(schemeEnd + 3),
+            rules.getCrawlDelay());
+    }
+
+    if (!config_.shouldUseSitemaps())
+    {
+        return;
+    }
+
+    // При непрерывном обходе карты перечитываются при каждом обновлении
+    // robots.txt (раз в robotsCacheTtl): их <lastmod> подсказывает, какие
+    // страницы изменились
+    if (!sitemapOrigins_.insertIfAbsent(origin) && !recrawl_)
+    {
+        return;
+    }
+
+    // Без директив Sitemap пробуем адрес по умолчанию
+    std::vector<std::string> sitemaps = rules.getSitemaps();
+    if (sitemaps.empty())
+    {
+        sitemaps.push_back(origin + "/sitemap.xml");
+    }
+
+    // Карта на очереди - ещё не выполненная работа: до её разбора обход
+    // не считается завершённым
+    for (auto& sitemap : sitemaps)
+    {
+        pendingSitemaps_++;
+        if (!sitemapQueue_.tryPush({ origin, std::move(sitemap) }))
         {
-            std::cerr << "[" << std::this_thread::get_id() << "] Ошибка загрузки " << url << ": " << e.what() << std::endl;
-            return;
+            pendingSitemaps_--;
+            std::cerr << "⚠️  Очередь карт сайта заполнена, пропущена карта хоста " << origin << std::endl;
         }
+    }
+}
+
+void Spider::sitemapWorker()
+{
+    activeWorkers_++;
+
+    std::pair<std::string, std::string> job;
+    while (sitemapQueue_.pop(job))
+    {
+        processSitemap(job.first, job.second);
+        pendingSitemaps_--;
+        checkCompletion();
+    }
+
+    activeWorkers_--;
+}
+
+void Spider::processSitemap(const std::string& origin, const std::string& sitemapUrl)
+{
+    const size_t maxUrls = static_cast<size_t>(std::max(0, config_.getSpiderSitemapMaxUrls()));
+    const UrlNormalizer& normalizer = downloader_.getUrlNormalizer();
+
+    // Индекс карт может ссылаться на другие карты - обходим их стеком
+    std::vector<std::string> pending{ sitemapUrl };
+    size_t seeded = 0;
+    int filesLeft = kMaxSitemapFiles;
+
+    while (!pending.empty() && filesLeft-- > 0 && seeded < maxUrls && !stopRequested_)
+    {
+        std::string url = std::move(pending.back());
+        pending.pop_back();
+
+        std::vector<SitemapParser::Entry> entries;
+        SitemapParser parser([&](const SitemapParser::Entry& entry) {
+            if (entry.isSitemap)
+            {
+                pending.push_back(entry.loc);
+            }
+            else if (entries.size() < maxUrls - seeded)
+            {
+                entries.push_back(entry);
+            }
+            });
 
-        // Индексируем страницу
-        Indexer::IndexingResult result;
         try
         {
-            std::cout << "[" << std::this_thread::get_id() << "] Индексация: " << url << std::endl;
-            result = indexer_.indexPage(html, url);
-            pagesIndexed_++;
-            std::cout << "[" << std::this_thread::get_id() << "] Индексация завершена, слов: " << result.wordsFrequency.size() << std::endl;
+            downloader_.downloadStream(url, [&](const char* data, size_t size) {
+                parser.feed(data, size);
+                return !stopRequested_ && entries.size() < maxUrls - seeded;
+                }, kMaxSitemapSize);
         }
         catch (const std::exception& e)
         {
-            std::cerr << "[" << std::this_thread::get_id() << "] Ошибка индексации " << url << ": " << e.what() << std::endl;
-            return;
-        }
-
-        // Сохраняем в БД
-        try
-        {
-            std::cout << "[" << std::this_thread::get_id() << "] Сохранение в БД: " << url << std::endl;
-            int documentId = database_.savingDocument(url, result.title, result.cleanContent);
-            if (documentId > 0 && !result.wordsFrequency.empty())
+            // Прерванная по лимиту загрузка - не ошибка: найденное используем
+            if (entries.empty())
             {
-                database_.savingWords(documentId, result.wordsFrequency);
-                std::cout << "[" << std::this_thread::get_id() << "] Сохранено в БД (ID: " << documentId << ")" << std::endl;
+                std::cerr << "⚠️  Карта сайта " << url << " не загружена: " << e.what() << std::endl;
+                continue;
             }
         }
-        catch (const std::exception& e)
-        {
-            std::cerr << "[" << std::this_thread::get_id() << "] Ошибка сохранения в БД " << url << ": " << e.what() << std::endl;
-            return;
-        }
 
-        // Если не достигли максимальной глубины, извлекаем ссылки
-        if (depth < config_.getSpiderMaxDepth())
+        // Сначала недавно изменённые страницы
+        std::stable_sort(entries.begin(), entries.end(), [](const SitemapParser::Entry& a, const SitemapParser::Entry& b) {
+            return a.lastModified > b.lastModified;
+            });
+
+        std::shared_lock<std::shared_mutex> checkpointLock(checkpointMutex_);
+        for (const auto& entry : entries)
         {
-            try
+            // По протоколу карта сайта описывает только свой хост
+            std::string normalized = normalizer.normalize(entry.loc);
+            if (normalized.empty() || normalized.rfind(origin + "/", 0) != 0)
             {
-                std::cout << "[" << std::this_thread::get_id() << "] Извлечение ссылок из: " << url << std::endl;
-                std::vector<std::string> links = downloader_.extractLinks(html, url);
-                std::cout << "[" << std::this_thread::get_id() << "] Найдено ссылок: " << links.size() << std::endl;
-
-                int addedCount = 0;
-                for (const auto& link : links)
-                {
-                    // Проверяем, не обрабатывали ли уже эту ссылку
-                    bool alreadyProcessed;
-                    {
-                        std::lock_guard<std::mutex> lock(processedMutex_);
-                        alreadyProcessed = (processedUrls_.find(link) != processedUrls_.end());
-                    }
-
-                    if (!alreadyProcessed)
-                    {
-                        addTask(link, depth + 1);
-                        addedCount++;
-                    }
-                }
-
-                std::cout << "[" << std::this_thread::get_id() << "] Добавлено новых ссылок: " << addedCount << std::endl;
+                continue;
             }
-            catch (const std::exception& e)
+
+            // Адреса из карты - на один шаг от стартовой страницы
+            if (processedUrls_.insertIfAbsent(normalized))
             {
-                std::cerr << "[" << std::this_thread::get_id() << "] Ошибка извлечения ссылок " << url << ": " << e.what() << std::endl;
+                addTask(normalized, 1);
+                seeded++;
             }
-        }
-
-        // После обработки страницы проверяем состояние очереди
-        {
-            std::lock_guard<std::mutex> lock(queueMutex_);
-            if (taskQueue_.empty())
+            else if (recrawl_ && entry.lastModified > 0)
             {
-                std::cout << "[" << std::this_thread::get_id() << "] Очередь пуста" << std::endl;
-                // Если очередь пуста, уведомляем все потоки для проверки остановки
-                queueCV_.notify_all();
+                recrawl_->recordLastModified(normalized, entry.lastModified);
             }
         }
     }
-    catch (const std::exception& e)
+
+    sitemapUrls_ += static_cast<long long>(seeded);
+    std::cout << "🗺️  Карта сайта " << sitemapUrl << ": добавлено " << seeded << " адресов" << std::endl;
+}
+
+void Spider::startStage(StageCounters& stage, int count, void (Spider::*worker)())
+{
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    stage.workers = count;
+    for (int i = 0; i < count; ++i)
+    {
+        workers_.emplace_back(worker, this);
+    }
+}
+
+void Spider::growFetchWorkers()
+{
+    if (fetchStage_.workers >= fetchLimiter_.getLimit())
+    {
+        return;
+    }
+
+    // Лимит вырос выше числа потоков: добавляем недостающие. Когда лимит
+    // снижается, лишние потоки просто ждут слота в acquire
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    while (!stopRequested_ && fetchStage_.workers < fetchLimiter_.getLimit())
     {
-        std::cerr << "[" << std::this_thread::get_id() << "] Критическая ошибка при обработке страницы " << url << ": " << e.what() << std::endl;
+        fetchStage_.workers++;
+        workers_.emplace_back(&Spider::fetchWorker, this);
     }
 }
 
 void Spider::start()
 {
     stopRequested_ = false;
+    if (completed_)
+    {
+        completed_ = false;
+        completionPromise_ = std::promise<void>();
+        completion_ = completionPromise_.get_future().share();
+    }
+    parseQueue_.reopen();
+    indexQueue_.reopen();
+    storeQueue_.reopen();
 
-    // Создаём пул потоков
-    unsigned int numThreads = std::thread::hardware_concurrency();
-    if (numThreads == 0) numThreads = 2; // fallback
+    fetchLimiter_.reopen();
+    sitemapQueue_.reopen();
+
+    // Размеры пулов стадий. Потоков загрузки сначала столько, каков
+    // текущий лимит ограничителя; при его росте они добавляются по мере
+    // надобности (growFetchWorkers)
+    int cores = hardwareThreads();
+
+    int fetchWorkers = fetchLimiter_.getLimit();
+    int parseWorkers = resolveWorkers(config_.getSpiderParseWorkers(), cores);
+    int indexWorkers = resolveWorkers(config_.getSpiderIndexWorkers(), cores);
+    int storeWorkers = resolveWorkers(config_.getSpiderStoreWorkers(), 2);
 
     std::cout << "\n🚀 Запуск паука" << std::endl;
-    std::cout << "   Потоков: " << numThreads << std::endl;
+    std::cout << "   Потоков загрузки: " << fetchWorkers;
+    if (config_.isAdaptiveConcurrency())
+    {
+        std::cout << " (адаптивный лимит, до " << fetchLimiter_.getMaxLimit() << ")";
+    }
+    std::cout << std::endl;
+    std::cout << "   Потоков разбора: " << parseWorkers << std::endl;
+    std::cout << "   Потоков индексации: " << indexWorkers << std::endl;
+    std::cout << "   Потоков сохранения: " << storeWorkers << std::endl;
     std::cout << "   Глубина: " << config_.getSpiderMaxDepth() << std::endl;
     std::cout << "   Стартовая страница: " << config_.getSpiderStartUrl() << std::endl;
 
-    for (unsigned int i = 0; i < numThreads; ++i)
+    startStage(storeStage_, storeWorkers, &Spider::storeWorker);
+    startStage(indexStage_, indexWorkers, &Spider::indexWorker);
+    startStage(parseStage_, parseWorkers, &Spider::parseWorker);
+
+    if (robots_ && config_.shouldUseSitemaps())
+    {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        workers_.emplace_back(&Spider::sitemapWorker, this);
+    }
+
+    startStage(fetchStage_, fetchWorkers, &Spider::fetchWorker);
+
+    delayedThread_ = std::thread(&Spider::delayedLoop, this);
+
+    if (recrawl_)
+    {
+        std::cout << "   Непрерывный обход: до " << config_.getSpiderRecrawlBudget()
+            << " повторных визитов в минуту" << std::endl;
+        recrawlThread_ = std::thread(&Spider::recrawlLoop, this);
+    }
+
+    if (shardRouter_)
+    {
+        shardRouter_->start(
+            [this](const std::string& url, int depth) {
+                acceptRemoteLink(url, depth);
+            },
+            [this]() {
+                std::lock_guard<std::mutex> lock(queueMutex_);
+                return !recrawl_ && isQuiescent();
+            },
+            [this]() {
+                completeIfQuiescent();
+            });
+    }
+
+    if (frontier_.isPersistent())
     {
-        workers_.emplace_back(&Spider::workerFunction, this);
+        std::cout << "   Состояние сохраняется в: " << frontier_.statePath("") << std::endl;
+        checkpointThread_ = std::thread(&Spider::checkpointLoop, this);
     }
+
+    // Очередь могла оказаться пустой с самого начала
+    checkCompletion();
 }
 
 void Spider::stop()
 {
     stopRequested_ = true;
-    queueCV_.notify_all();
+    wakeWorkers();
 
-    for (auto& worker : workers_)
+    // Пока ждём одни потоки, загрузка может успеть добавить новые
+    while (true)
     {
-        if (worker.joinable())
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lock(workersMutex_);
+            workers.swap(workers_);
+        }
+        if (workers.empty())
+        {
+            break;
+        }
+
+        for (auto& worker : workers)
         {
-            worker.join();
+            if (worker.joinable())
+            {
+                worker.join();
+            }
         }
     }
 
-    workers_.clear();
+    if (checkpointThread_.joinable())
+    {
+        checkpointThread_.join();
+    }
+
+    if (delayedThread_.joinable())
+    {
+        delayedThread_.join();
+    }
+
+    if (recrawlThread_.joinable())
+    {
+        recrawlThread_.join();
+    }
+
+    // Обмен с шардами прекращаем, только когда потоки разбора вышли:
+    // все найденные ими ссылки уже в пачках. Оставшиеся пачки
+    // отправляются, недоставленные попадут в контрольную точку
+    if (shardRouter_)
+    {
+        shardRouter_->stop();
+    }
+
+    // Финальная контрольная точка: после перезапуска обход продолжится с этого места
+    saveCheckpoint();
 
     std::cout << "\n🛑 Паук остановлен" << std::endl;
     std::cout << "   Всего загружено: " << pagesDownloaded_ << " страниц" << std::endl;
@@ -256,9 +1432,50 @@ Spider::SpiderStats Spider::getStats() const
     stats.totalDownloaded = pagesDownloaded_;
     stats.totalIndexed = pagesIndexed_;
     stats.activeWorkers = activeWorkers_;
+    stats.wireBytes = downloader_.getTotalWireBytes();
+    stats.decodedBytes = downloader_.getTotalDecodedBytes();
+    stats.exactDuplicates = duplicates_.getExactDuplicates();
+    stats.nearDuplicates = duplicates_.getNearDuplicates();
+    stats.linksForwarded = shardRouter_ ? shardRouter_->getForwarded() : 0;
+    stats.linksReceived = shardRouter_ ? shardRouter_->getReceived() : 0;
+    stats.robotsBlocked = robots_ ? robots_->getBlocked() : 0;
+    stats.sitemapUrls = sitemapUrls_;
+    stats.retries = retries_;
+    stats.hostsParked = hostsParked_;
+    stats.openHosts = hostHealth_.getOpenHosts();
+    stats.recrawlTracked = recrawl_ ? static_cast<long long>(recrawl_->getTracked()) : 0;
+    stats.revisits = recrawl_ ? recrawl_->getRevisits() : 0;
+    stats.revisitsChanged = recrawl_ ? recrawl_->getChanged() : 0;
 
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    stats.queueSize = static_cast<int>(taskQueue_.size());
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        stats.queueSize = static_cast<int>(frontier_.size());
+        stats.inFlight = static_cast<int>(inFlightTasks_.size());
+    }
+
+    auto describe = [](const char* name, const StageCounters& stage, size_t queueSize, size_t queueCapacity) {
+        StageStats result;
+        result.name = name;
+        result.workers = stage.workers;
+        result.concurrencyLimit = stage.workers;
+        result.busy = stage.busy;
+        result.queueSize = static_cast<int>(queueSize);
+        result.queueCapacity = static_cast<int>(queueCapacity);
+        result.processed = stage.processed;
+        result.failed = stage.failed;
+        long long total = result.processed + result.failed;
+        result.avgMillis = total > 0 ? stage.busyMicros / 1000.0 / total : 0.0;
+        result.p50Millis = stage.latency.percentileMillis(50);
+        result.p90Millis = stage.latency.percentileMillis(90);
+        result.p99Millis = stage.latency.percentileMillis(99);
+        return result;
+    };
+
+    stats.stages.push_back(describe("fetch", fetchStage_, stats.queueSize, 0));
+    stats.stages.back().concurrencyLimit = fetchLimiter_.getLimit();
+    stats.stages.push_back(describe("parse", parseStage_, parseQueue_.size(), parseQueue_.capacity()));
+    stats.stages.push_back(describe("index", indexStage_, indexQueue_.size(), indexQueue_.capacity()));
+    stats.stages.push_back(describe("store", storeStage_, storeQueue_.size(), storeQueue_.capacity()));
 
     return stats;
 }
@@ -270,11 +1487,46 @@ bool Spider::isRunning() const
 
 bool Spider::isFinished() const
 {
-    if (stopRequested_)
+    return stopRequested_ || completed_;
+}
+
+bool Spider::isComplete() const
+{
+    return completed_;
+}
+
+std::shared_future<void> Spider::getCompletion() const
+{
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return completion_;
+}
+
+void Spider::onComplete(std::function<void()> callback)
+{
     {
-        return true;
+        std::lock_guard<std::mutex> lock(callbacksMutex_);
+        if (!completed_)
+        {
+            completionCallbacks_.push_back(std::move(callback));
+            return;
+        }
     }
+    callback();
+}
 
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    return taskQueue_.empty() && activeWorkers_ == 0;
+bool Spider::waitForStats(uint64_t& version, std::chrono::milliseconds minInterval) const
+{
+    auto done = [this]() { return stopRequested_ || completed_; };
+
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    statsCV_.wait_for(lock, minInterval, done);
+    statsCV_.wait(lock, [&]() { return done() || statsVersion_ != version; });
+
+    version = statsVersion_;
+    return !done();
+}
+
+bool Spider::isContinuous() const
+{
+    return recrawl_ != nullptr;
 }
\ No newline at end of file
@@ -3,18 +3,38 @@
 
 #include <iostream>
 #include <string>
-#include <queue>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include <condition_variable>
 #include <atomic>
-#include <unordered_set>
 #include <vector>
 #include <functional>
+#include <memory>
+#include <queue>
+#include <deque>
+#include <chrono>
+#include <future>
+#include <cstdint>
 #include "Config.h"
 #include "Database.h"
 #include "HTMLDownloader.h"
 #include "Indexer.h"
+#include "ConcurrentUrlSet.h"
+#include "CrawlFrontier.h"
+#include "BoundedQueue.h"
+#include "ConcurrencyLimiter.h"
+#include "DuplicateDetector.h"
+#include "LatencyHistogram.h"
+#include "ShardRouter.h"
+#include "RobotsCache.h"
+#include "SitemapParser.h"
+#include "HostHealth.h"
+#include "RecrawlScheduler.h"
+#include "PageFetcher.h"
+#include "WarcWriter.h"
+#include "WarcReplayFetcher.h"
 
 class Spider
 {
@@ -24,40 +44,247 @@ private:
     HTMLDownloader downloader_;
     Indexer indexer_;
 
+    // Запись ответов в WARC и воспроизведение из WARC
+    std::unique_ptr<WarcWriter> warcWriter_;
+    std::unique_ptr<WarcReplayFetcher> warcReplay_;
+
+    // Откуда берутся страницы: downloader_ или warcReplay_
+    PageFetcher* fetcher_;
+
     // Структура для задачи скачивания
-    struct DownloadTask
-    {
-        std::string url;
-        int depth;
-    };
+    using DownloadTask = CrawlFrontier::Task;
 
-    // Очередь задач
-    std::queue<DownloadTask> taskQueue_;
+    // Очередь задач (с выгрузкой на диск и контрольными точками)
+    CrawlFrontier frontier_;
     mutable std::mutex queueMutex_;  // <-- делаем mutable
     std::condition_variable queueCV_;
 
-    // Множество обработанных URL (для избежания дублирования)
-    std::unordered_set<std::string> processedUrls_;
-    mutable std::mutex processedMutex_;  // <-- делаем mutable
+    // Задачи, взятые в работу, но ещё не завершённые (url -> глубина).
+    // Попадают в контрольную точку, чтобы не потеряться при перезапуске
+    std::unordered_map<std::string, DownloadTask> inFlightTasks_;
+
+    // Страница между стадиями конвейера
+    struct PageItem
+    {
+        DownloadTask task;
+        std::string html;
+        Indexer::IndexingResult result;
+        PageFetcher::Validators validators;
+        bool revisit = false;  // повторный визит уже известной страницы
+    };
+
+    // Конвейер: загрузка -> разбор (текст, слова и ссылки за один проход) ->
+    // проверка изменений и дубликатов -> сохранение.
+    // Стадии связаны ограниченными очередями: если следующая стадия
+    // не успевает, предыдущая блокируется (backpressure)
+    BoundedQueue<PageItem> parseQueue_;
+    BoundedQueue<PageItem> indexQueue_;
+    BoundedQueue<PageItem> storeQueue_;
+
+    // Счётчики одной стадии конвейера
+    struct StageCounters
+    {
+        std::atomic<int> workers{ 0 };
+        std::atomic<int> busy{ 0 };
+        std::atomic<long long> processed{ 0 };
+        std::atomic<long long> failed{ 0 };
+        std::atomic<long long> busyMicros{ 0 };
+        LatencyHistogram latency;
+    };
+
+    StageCounters fetchStage_;
+    StageCounters parseStage_;
+    StageCounters indexStage_;
+    StageCounters storeStage_;
+
+    // Адаптивный лимит одновременных загрузок
+    ConcurrencyLimiter fetchLimiter_;
+
+    // Что делать с дубликатами страниц
+    enum class DuplicatePolicy
+    {
+        Off,       // не проверять
+        Skip,      // не сохранять вовсе
+        Collapse   // сохранить только URL и заголовок, без текста и слов
+    };
+
+    DuplicatePolicy duplicatePolicy_;
+    DuplicateDetector duplicates_;
+
+    // Множество уже встреченных URL (для избежания дублирования).
+    // URL попадает сюда ровно один раз - в момент обнаружения ссылки,
+    // поэтому дубликаты никогда не доходят до очереди
+    ConcurrentUrlSet processedUrls_;
+
+    // Обмен ссылками с другими шардами (nullptr - обход одним процессом)
+    std::unique_ptr<ShardRouter> shardRouter_;
+
+    // Правила robots.txt по хостам (nullptr - robots.txt не загружается)
+    std::unique_ptr<RobotsCache> robots_;
+
+    // Карты сайта на разбор: (origin хоста, URL sitemap.xml). Карты
+    // каждого хоста берутся один раз - при первой загрузке его robots.txt
+    BoundedQueue<std::pair<std::string, std::string>> sitemapQueue_;
+    ConcurrentUrlSet sitemapOrigins_;
+    std::atomic<long long> sitemapUrls_;
+
+    // Состояние хостов: отключение недоступных и адаптивные таймауты
+    HostHealth hostHealth_;
+
+    // Отложенные задачи: повторы после сбоя и пробуждения хостов.
+    // Защищены queueMutex_ и остаются в inFlightTasks_, поэтому попадают
+    // в контрольную точку и не дают обходу считаться завершённым
+    struct DelayedTask
+    {
+        std::chrono::steady_clock::time_point readyAt;
+        DownloadTask task;
+        std::string host;  // не пусто - пора вернуть задачи хоста
+
+        bool operator>(const DelayedTask& other) const { return readyAt > other.readyAt; }
+    };
+
+    std::priority_queue<DelayedTask, std::vector<DelayedTask>, std::greater<DelayedTask>> delayedTasks_;
+
+    // Задачи хостов, к которым пока нельзя обращаться (цепь разомкнута
+    // или не вышел Crawl-delay). Задачи хоста ждут вместе под одной
+    // записью в delayedTasks_, а не опрашивают хост каждая по отдельности.
+    // Защищены queueMutex_ и остаются в inFlightTasks_
+    struct ParkedHost
+    {
+        std::deque<DownloadTask> tasks;
+        std::chrono::steady_clock::time_point readyAt;  // когда вернуть задачи
+    };
+
+    std::unordered_map<std::string, ParkedHost> parkedHosts_;
+    std::condition_variable delayedCV_;
+    std::thread delayedThread_;
+    std::atomic<long long> retries_;
+    std::atomic<long long> hostsParked_;
 
-    // Пул потоков
+    // Непрерывный обход: расписание повторных визитов (nullptr - один проход)
+    std::unique_ptr<RecrawlScheduler> recrawl_;
+    std::thread recrawlThread_;
+    std::mutex recrawlWaitMutex_;
+    std::condition_variable recrawlCV_;
+
+    // Пул потоков (потоки загрузки добавляются и во время работы)
+    std::mutex workersMutex_;
     std::vector<std::thread> workers_;
     std::atomic<bool> stopRequested_;
     std::atomic<int> activeWorkers_;
 
+    // Завершение обхода. Обход завершён, когда очередь пуста, в конвейере
+    // нет задач (inFlightTasks_, включая отложенные) и не осталось карт
+    // сайта на разбор: новых задач взяться неоткуда. Проверка идёт под
+    // queueMutex_ в момент, когда задача покидает конвейер. Непрерывный
+    // обход сам не завершается: работа приходит по расписанию.
+    // Шардированный завершает ShardRouter, когда простаивают все шарды
+    // и ни одна пересылаемая ссылка не осталась в пути
+    std::atomic<int> pendingSitemaps_;
+    std::atomic<bool> completed_;
+    std::promise<void> completionPromise_;
+    std::shared_future<void> completion_;
+    std::mutex callbacksMutex_;
+    std::vector<std::function<void()>> completionCallbacks_;
+
+    // Подписка на статистику: версия растёт с каждой завершённой задачей
+    // (защищена queueMutex_)
+    uint64_t statsVersion_;
+    mutable std::condition_variable statsCV_;
+
     // Статистика
     std::atomic<int> pagesDownloaded_;
     std::atomic<int> pagesIndexed_;
 
-    // Функция рабочего потока
-    void workerFunction();
+    // Контрольные точки. Обнаружение ссылок (отметка + постановка в очередь)
+    // берёт блокировку на чтение, снимок состояния - на запись, поэтому
+    // множество посещённых URL и очередь сохраняются согласованно.
+    // Запись снимка на диск идёт уже без неё, под checkpointWriteMutex_
+    std::shared_mutex checkpointMutex_;
+    std::mutex checkpointWriteMutex_;
+    std::thread checkpointThread_;
+    std::mutex checkpointWaitMutex_;
+    std::condition_variable checkpointCV_;
+
+    // Рабочие функции стадий конвейера
+    void fetchWorker();
+    void parseWorker();
+    void indexWorker();
+    void storeWorker();
+    void sitemapWorker();
+
+    // Проверка robots.txt перед загрузкой. Для Unavailable в retryAt -
+    // когда проверить снова
+    RobotsCache::Access robotsAccess(const std::string& url, std::chrono::steady_clock::time_point& retryAt);
+
+    // robots.txt хоста загружен: запоминаем Crawl-delay и ставим
+    // карты сайта хоста в очередь
+    void onRobotsFetched(const std::string& origin, const RobotsRules& rules);
+
+    // Разбор карты сайта (и вложенных карт индекса) с добавлением адресов в очередь
+    void processSitemap(const std::string& origin, const std::string& sitemapUrl);
+
+    // Запуск потоков одной стадии
+    void startStage(StageCounters& stage, int count, void (Spider::*worker)());
+
+    // Добавление потоков загрузки до текущего лимита ограничителя
+    void growFetchWorkers();
+
+    // Отложить задачу до readyAt (она остаётся "в работе")
+    void delayTask(DownloadTask task, std::chrono::steady_clock::time_point readyAt);
+
+    // Поставить задачу в очередь ожидания хоста до readyAt
+    void parkTask(const std::string& host, DownloadTask task, std::chrono::steady_clock::time_point readyAt);
+
+    // Цепь хоста замкнулась: его задачи возвращаются в обход сразу
+    void wakeParkedHost(const std::string& host);
+
+    // Вернуть в обход задачи хоста, если запись readyAt ещё актуальна
+    // (вызывается под queueMutex_)
+    void releaseParkedHost(const std::string& host, std::chrono::steady_clock::time_point readyAt);
+
+    // Функция потока, возвращающего отложенные задачи в очередь
+    void delayedLoop();
+
+    // Функция потока, ставящего в очередь наступившие повторные визиты
+    void recrawlLoop();
+
+    // Страница исчезла с сайта: убираем её из индекса и расписания
+    void dropGonePage(const std::string& url);
+
+    // Страница покинула конвейер (сохранена или отброшена)
+    void finishTask(const std::string& url);
 
-    // Обработка одной страницы
-    void processPage(const std::string& url, int depth);
+    // Нет ли больше работы (вызывается под queueMutex_)
+    bool isQuiescent() const;
 
-    // Добавление задачи в очередь
+    // Проверка завершения после события, которое могло его вызвать
+    void checkCompletion();
+
+    // Завершение обхода, если работы больше нет
+    void completeIfQuiescent();
+
+    // Обход завершён: будим потоки, чтобы они вышли, и сообщаем подписчикам
+    void completeCrawl();
+
+    // Пробуждение всех ждущих потоков перед выходом
+    void wakeWorkers();
+
+    // Добавление задачи в очередь (URL уже должен быть отмечен в processedUrls_)
     void addTask(const std::string& url, int depth);
 
+    // Ссылка от другого шарда: отмечаем и ставим в очередь, если новая
+    void acceptRemoteLink(const std::string& url, int depth);
+
+    // Восстановление состояния из последней контрольной точки
+    bool restoreState();
+
+    // Сохранение контрольной точки (очередь + посещённые URL)
+    void saveCheckpoint();
+
+    // Функция потока периодического сохранения
+    void checkpointLoop();
+
 public:
     Spider(Config& config, Database& db);
     ~Spider();
@@ -68,13 +295,46 @@ public:
     // Остановка паука
     void stop();
 
+    // Статистика одной стадии конвейера
+    struct StageStats
+    {
+        std::string name;
+        int workers;          // потоков в стадии
+        int busy;             // из них заняты обработкой
+        int concurrencyLimit; // сколько потоков может работать одновременно
+        int queueSize;        // элементов во входной очереди
+        int queueCapacity;    // ёмкость входной очереди (0 - не ограничена)
+        long long processed;  // обработано успешно
+        long long failed;     // завершились ошибкой
+        double avgMillis;     // среднее время обработки одного элемента
+        double p50Millis;     // перцентили времени обработки
+        double p90Millis;
+        double p99Millis;
+    };
+
     // Получение статистики
     struct SpiderStats
     {
         int totalDownloaded;
         int totalIndexed;
         int queueSize;
+        int inFlight;            // страниц в конвейере (взяты из очереди, но не завершены)
         int activeWorkers;
+        long long wireBytes;     // принято по сети
+        long long decodedBytes;  // после распаковки
+        long long exactDuplicates;
+        long long nearDuplicates;
+        long long linksForwarded;  // отправлено другим шардам
+        long long linksReceived;   // получено от других шардов
+        long long robotsBlocked;   // не загружено из-за robots.txt
+        long long sitemapUrls;     // добавлено в очередь из карт сайта
+        long long retries;         // повторных загрузок после сбоя
+        long long hostsParked;     // задач ждут отключённого хоста или Crawl-delay
+        int openHosts;             // хостов отключено сейчас
+        long long recrawlTracked;  // страниц в расписании повторных визитов
+        long long revisits;        // повторных визитов
+        long long revisitsChanged; // из них страница изменилась
+        std::vector<StageStats> stages;
     };
 
     SpiderStats getStats() const;
@@ -83,6 +343,25 @@ public:
     bool isRunning() const;
 
     bool isFinished() const;
+
+    // Обход завершён сам (а не остановлен)
+    bool isComplete() const;
+
+    // Готов, как только обход завершён
+    std::shared_future<void> getCompletion() const;
+
+    // Вызов callback при завершении обхода (сразу, если он уже завершён).
+    // Вызывается в потоке, завершившем последнюю задачу (при
+    // шардированном обходе - в потоке обмена с шардами)
+    void onComplete(std::function<void()> callback);
+
+    // Ожидание изменения статистики: не раньше чем через minInterval и
+    // только если с прошлого вызова завершилась хотя бы одна задача.
+    // Возвращает false сразу при завершении или остановке обхода
+    bool waitForStats(uint64_t& version, std::chrono::milliseconds minInterval) const;
+
+    // Непрерывный обход: паук не завершается, пока его не остановят
+    bool isContinuous() const;
 };
 
 #endif // SPIDER_H
\ No newline at end of file
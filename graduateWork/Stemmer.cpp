@@ -0,0 +1,621 @@
+#include "Stemmer.h"
+#include <string_view>
+#include <iostream>
+#include <cstring>
+
+namespace
+{
+    // Условие, при котором окончание отбрасывается или заменяется
+    enum class Condition
+    {
+        None,
+        AfterAOrYa,   // перед окончанием 'а' или 'я' (она остаётся)
+        AfterL,       // перед окончанием 'l'
+        ValidLi,      // перед "li" одна из c d e g h k m n r t
+        AfterSOrT,    // перед окончанием 's' или 't'
+        InR2          // окончание целиком в области R2
+    };
+
+    struct Rule
+    {
+        std::string_view suffix;
+        std::string_view replacement;
+        Condition condition = Condition::None;
+    };
+
+    // Самое длинное окончание таблицы, начинающееся не раньше limit.
+    // Как в Snowball: если условие самого длинного не выполнено,
+    // более короткие не пробуются
+    template <size_t N>
+    const Rule* findLongest(std::string_view word, size_t limit, const Rule (&rules)[N])
+    {
+        const Rule* found = nullptr;
+        if (limit > word.size())
+        {
+            return found;
+        }
+        for (const Rule& rule : rules)
+        {
+            if (rule.suffix.size() <= word.size() - limit && word.ends_with(rule.suffix) &&
+                (found == nullptr || rule.suffix.size() > found->suffix.size()))
+            {
+                found = &rule;
+            }
+        }
+        return found;
+    }
+
+    // Замена окончания, начинающегося в start. Замена не длиннее окончания
+    size_t replaceSuffix(char* word, size_t start, std::string_view replacement)
+    {
+        std::memcpy(word + start, replacement.data(), replacement.size());
+        return start + replacement.size();
+    }
+
+    // ---- Русский ----
+    // Все буквы а-я записываются в UTF-8 двумя байтами, поэтому окончания
+    // сравниваются побайтово, а позиции всегда кратны двум
+
+    const Rule kPerfectiveGerund[] = {
+        { "в", "", Condition::AfterAOrYa }, { "вши", "", Condition::AfterAOrYa }, { "вшись", "", Condition::AfterAOrYa },
+        { "ив", "" }, { "ивши", "" }, { "ившись", "" }, { "ыв", "" }, { "ывши", "" }, { "ывшись", "" }
+    };
+
+    const Rule kAdjective[] = {
+        { "ее", "" }, { "ие", "" }, { "ые", "" }, { "ое", "" }, { "ими", "" }, { "ыми", "" }, { "ей", "" },
+        { "ий", "" }, { "ый", "" }, { "ой", "" }, { "ем", "" }, { "им", "" }, { "ым", "" }, { "ом", "" },
+        { "его", "" }, { "ого", "" }, { "ему", "" }, { "ому", "" }, { "их", "" }, { "ых", "" },
+        { "ую", "" }, { "юю", "" }, { "ая", "" }, { "яя", "" }, { "ою", "" }, { "ею", "" }
+    };
+
+    const Rule kParticiple[] = {
+        { "ем", "", Condition::AfterAOrYa }, { "нн", "", Condition::AfterAOrYa }, { "вш", "", Condition::AfterAOrYa },
+        { "ющ", "", Condition::AfterAOrYa }, { "щ", "", Condition::AfterAOrYa },
+        { "ивш", "" }, { "ывш", "" }, { "ующ", "" }
+    };
+
+    const Rule kReflexive[] = {
+        { "ся", "" }, { "сь", "" }
+    };
+
+    const Rule kVerb[] = {
+        { "ла", "", Condition::AfterAOrYa }, { "на", "", Condition::AfterAOrYa }, { "ете", "", Condition::AfterAOrYa },
+        { "йте", "", Condition::AfterAOrYa }, { "ли", "", Condition::AfterAOrYa }, { "й", "", Condition::AfterAOrYa },
+        { "л", "", Condition::AfterAOrYa }, { "ем", "", Condition::AfterAOrYa }, { "н", "", Condition::AfterAOrYa },
+        { "ло", "", Condition::AfterAOrYa }, { "но", "", Condition::AfterAOrYa }, { "ет", "", Condition::AfterAOrYa },
+        { "ют", "", Condition::AfterAOrYa }, { "ны", "", Condition::AfterAOrYa }, { "ть", "", Condition::AfterAOrYa },
+        { "ешь", "", Condition::AfterAOrYa }, { "нно", "", Condition::AfterAOrYa },
+        { "ила", "" }, { "ыла", "" }, { "ена", "" }, { "ейте", "" }, { "уйте", "" }, { "ите", "" }, { "или", "" },
+        { "ыли", "" }, { "ей", "" }, { "уй", "" }, { "ил", "" }, { "ыл", "" }, { "им", "" }, { "ым", "" },
+        { "ен", "" }, { "ило", "" }, { "ыло", "" }, { "ено", "" }, { "ят", "" }, { "ует", "" }, { "уют", "" },
+        { "ит", "" }, { "ыт", "" }, { "ены", "" }, { "ить", "" }, { "ыть", "" }, { "ишь", "" }, { "ую", "" },
+        { "ю", "" }
+    };
+
+    const Rule kNoun[] = {
+        { "а", "" }, { "ев", "" }, { "ов", "" }, { "ие", "" }, { "ье", "" }, { "е", "" }, { "иями", "" },
+        { "ями", "" }, { "ами", "" }, { "еи", "" }, { "ии", "" }, { "и", "" }, { "ией", "" }, { "ей", "" },
+        { "ой", "" }, { "ий", "" }, { "й", "" }, { "иям", "" }, { "ям", "" }, { "ием", "" }, { "ем", "" },
+        { "ам", "" }, { "ом", "" }, { "о", "" }, { "у", "" }, { "ах", "" }, { "иях", "" }, { "ях", "" },
+        { "ы", "" }, { "ь", "" }, { "ию", "" }, { "ью", "" }, { "ю", "" }, { "ия", "" }, { "ья", "" },
+        { "я", "" }
+    };
+
+    const Rule kDerivational[] = {
+        { "ост", "", Condition::InR2 }, { "ость", "", Condition::InR2 }
+    };
+
+    constexpr size_t kRussianLetter = 2;
+
+    bool isRussianLetter(const char* letter)
+    {
+        unsigned char lead = static_cast<unsigned char>(letter[0]);
+        unsigned char next = static_cast<unsigned char>(letter[1]);
+        return (lead == 0xD0 && next >= 0xB0 && next <= 0xBF) ||   // а..п
+            (lead == 0xD1 && ((next >= 0x80 && next <= 0x8F) || next == 0x91));   // р..я, ё
+    }
+
+    bool isRussianVowel(std::string_view letter)
+    {
+        static constexpr std::string_view kVowels[] = { "а", "е", "и", "о", "у", "ы", "э", "ю", "я" };
+        for (std::string_view vowel : kVowels)
+        {
+            if (letter == vowel)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Отбрасывает самое длинное подходящее окончание из rules в пределах
+    // [limit, size) и уменьшает size. false - окончание не отброшено
+    template <size_t N>
+    bool removeRussian(const char* word, size_t& size, size_t limit, size_t r2, const Rule (&rules)[N])
+    {
+        std::string_view view(word, size);
+        const Rule* rule = findLongest(view, limit, rules);
+        if (rule == nullptr)
+        {
+            return false;
+        }
+
+        size_t start = size - rule->suffix.size();
+        if (rule->condition == Condition::AfterAOrYa)
+        {
+            if (start < limit + kRussianLetter)
+            {
+                return false;
+            }
+            std::string_view before = view.substr(start - kRussianLetter, kRussianLetter);
+            if (before != "а" && before != "я")
+            {
+                return false;
+            }
+        }
+        else if (rule->condition == Condition::InR2 && start < r2)
+        {
+            return false;
+        }
+
+        size = start;
+        return true;
+    }
+
+    bool endsWithInRegion(std::string_view word, size_t limit, std::string_view suffix)
+    {
+        return word.size() >= limit + suffix.size() && word.ends_with(suffix);
+    }
+
+    bool isRussianWord(const char* word, size_t size)
+    {
+        if (size == 0 || size % kRussianLetter != 0)
+        {
+            return false;
+        }
+        for (size_t pos = 0; pos < size; pos += kRussianLetter)
+        {
+            if (!isRussianLetter(word + pos))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ---- Английский (Porter2) ----
+
+    // Слова-исключения целиком и их основы
+    struct Exception
+    {
+        std::string_view word;
+        std::string_view stem;
+    };
+
+    constexpr Exception kEnglishExceptions[] = {
+        { "skis", "ski" }, { "skies", "sky" }, { "idly", "idl" }, { "gently", "gentl" }, { "ugly", "ugli" },
+        { "early", "earli" }, { "only", "onli" }, { "singly", "singl" },
+        { "sky", "sky" }, { "news", "news" }, { "howe", "howe" }, { "atlas", "atlas" }, { "cosmos", "cosmos" },
+        { "bias", "bias" }, { "andes", "andes" }
+    };
+
+    // Приставки, после которых начинается область R1
+    constexpr std::string_view kEnglishRegionPrefixes[] = {
+        "arsen", "commun", "emerg", "gener", "inter", "later", "organ", "past", "univers"
+    };
+
+    // Основы, которые не теряют "eed" ("succeed") и "ing" ("evening")
+    constexpr std::string_view kKeepEed[] = { "succ", "proc", "exc" };
+    constexpr std::string_view kKeepIng[] = { "even", "cann", "inn", "earr", "herr", "out" };
+
+    const Rule kStep2[] = {
+        { "tional", "tion" }, { "enci", "ence" }, { "anci", "ance" }, { "abli", "able" }, { "entli", "ent" },
+        { "izer", "ize" }, { "ization", "ize" }, { "ational", "ate" }, { "ation", "ate" }, { "ator", "ate" },
+        { "alism", "al" }, { "aliti", "al" }, { "alli", "al" }, { "fulness", "ful" }, { "ousli", "ous" },
+        { "ousness", "ous" }, { "iveness", "ive" }, { "iviti", "ive" }, { "biliti", "ble" }, { "bli", "ble" },
+        { "ogist", "og" }, { "ogi", "og", Condition::AfterL }, { "fulli", "ful" }, { "lessli", "less" },
+        { "li", "", Condition::ValidLi }
+    };
+
+    const Rule kStep3[] = {
+        { "tional", "tion" }, { "ational", "ate" }, { "alize", "al" }, { "icate", "ic" }, { "iciti", "ic" },
+        { "ical", "ic" }, { "ful", "" }, { "ness", "" }, { "ative", "", Condition::InR2 }
+    };
+
+    const Rule kStep4[] = {
+        { "al", "" }, { "ance", "" }, { "ence", "" }, { "er", "" }, { "ic", "" }, { "able", "" }, { "ible", "" },
+        { "ant", "" }, { "ement", "" }, { "ment", "" }, { "ent", "" }, { "ism", "" }, { "ate", "" },
+        { "iti", "" }, { "ous", "" }, { "ive", "" }, { "ize", "" }, { "ion", "", Condition::AfterSOrT }
+    };
+
+    bool isEnglishVowel(char c)
+    {
+        return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u' || c == 'y';
+    }
+
+    bool isOneOf(char c, std::string_view set)
+    {
+        return set.find(c) != std::string_view::npos;
+    }
+
+    bool hasEnglishVowel(const char* word, size_t end)
+    {
+        for (size_t i = 0; i < end; ++i)
+        {
+            if (isEnglishVowel(word[i]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Слово word[0, end) оканчивается коротким слогом
+    bool endsWithShortSyllable(const char* word, size_t end)
+    {
+        if (end >= 3 && !isEnglishVowel(word[end - 3]) && isEnglishVowel(word[end - 2]) &&
+            !isEnglishVowel(word[end - 1]) && !isOneOf(word[end - 1], "wxY"))
+        {
+            return true;
+        }
+        if (end == 2 && isEnglishVowel(word[0]) && !isEnglishVowel(word[1]))
+        {
+            return true;
+        }
+        return std::string_view(word, end).ends_with("past");
+    }
+
+    // Позиция после первой не гласной, идущей за гласной, начиная с from
+    size_t nextRegion(const char* word, size_t size, size_t from)
+    {
+        size_t pos = from;
+        while (pos < size && !isEnglishVowel(word[pos]))
+        {
+            pos++;
+        }
+        while (pos < size && isEnglishVowel(word[pos]))
+        {
+            pos++;
+        }
+        return pos < size ? pos + 1 : size;
+    }
+
+    bool isEnglishWord(const char* word, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (word[i] < 'a' || word[i] > 'z')
+            {
+                return false;
+            }
+        }
+        return size > 0;
+    }
+}
+
+Stemmer::Stemmer(unsigned languages)
+    : languages_(languages)
+{
+}
+
+unsigned Stemmer::parseLanguages(const std::vector<std::string>& names)
+{
+    unsigned languages = None;
+    for (const std::string& name : names)
+    {
+        if (name == "russian")
+        {
+            languages |= Russian;
+        }
+        else if (name == "english")
+        {
+            languages |= English;
+        }
+        else if (name != "none")
+        {
+            std::cerr << "⚠️  Неизвестный язык: " << name << std::endl;
+        }
+    }
+    return languages;
+}
+
+Stemmer Stemmer::fromNames(const std::vector<std::string>& names)
+{
+    return Stemmer(parseLanguages(names));
+}
+
+unsigned Stemmer::getLanguages() const
+{
+    return languages_;
+}
+
+size_t Stemmer::stem(char* word, size_t size) const
+{
+    if ((languages_ & English) && isEnglishWord(word, size))
+    {
+        return stemEnglish(word, size);
+    }
+    if ((languages_ & Russian) && isRussianWord(word, size))
+    {
+        return stemRussian(word, size);
+    }
+    return size;
+}
+
+size_t Stemmer::stemRussian(char* word, size_t size)
+{
+    // 'ё' приравнивается к 'е' (та же длина в байтах)
+    for (size_t pos = 0; pos < size; pos += kRussianLetter)
+    {
+        if (std::string_view(word + pos, kRussianLetter) == "ё")
+        {
+            std::memcpy(word + pos, "е", kRussianLetter);
+        }
+    }
+
+    // Области: RV - после первой гласной, R2 - после второго сочетания
+    // "гласная, затем согласная"
+    auto isVowelAt = [&](size_t pos) {
+        return isRussianVowel(std::string_view(word + pos, kRussianLetter));
+    };
+    auto goPast = [&](size_t& pos, bool vowel) {
+        while (pos < size)
+        {
+            bool found = isVowelAt(pos) == vowel;
+            pos += kRussianLetter;
+            if (found)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    size_t rv = size;
+    size_t r2 = size;
+    size_t pos = 0;
+    if (goPast(pos, true))
+    {
+        rv = pos;
+        if (goPast(pos, false) && goPast(pos, true) && goPast(pos, false))
+        {
+            r2 = pos;
+        }
+    }
+
+    // Шаг 1: деепричастие, иначе возвратная частица и затем
+    // прилагательное (с причастием), глагол или существительное
+    if (!removeRussian(word, size, rv, r2, kPerfectiveGerund))
+    {
+        removeRussian(word, size, rv, r2, kReflexive);
+        if (removeRussian(word, size, rv, r2, kAdjective))
+        {
+            removeRussian(word, size, rv, r2, kParticiple);
+        }
+        else if (!removeRussian(word, size, rv, r2, kVerb))
+        {
+            removeRussian(word, size, rv, r2, kNoun);
+        }
+    }
+
+    // Шаг 2: конечная 'и'
+    if (endsWithInRegion(std::string_view(word, size), rv, "и"))
+    {
+        size -= kRussianLetter;
+    }
+
+    // Шаг 3: словообразовательные "ост", "ость" в R2
+    removeRussian(word, size, rv, r2, kDerivational);
+
+    // Шаг 4: превосходная степень, двойная 'н', мягкий знак
+    std::string_view view(word, size);
+    if (endsWithInRegion(view, rv, "ейше") || endsWithInRegion(view, rv, "ейш"))
+    {
+        size -= view.ends_with("ейше") ? 4 * kRussianLetter : 3 * kRussianLetter;
+        if (endsWithInRegion(std::string_view(word, size), rv, "нн"))
+        {
+            size -= kRussianLetter;
+        }
+    }
+    else if (endsWithInRegion(view, rv, "нн"))
+    {
+        size -= kRussianLetter;
+    }
+    else if (endsWithInRegion(view, rv, "ь"))
+    {
+        size -= kRussianLetter;
+    }
+
+    return size;
+}
+
+size_t Stemmer::stemEnglish(char* word, size_t size)
+{
+    std::string_view original(word, size);
+    for (const Exception& exception : kEnglishExceptions)
+    {
+        if (original == exception.word)
+        {
+            return replaceSuffix(word, 0, exception.stem);
+        }
+    }
+    if (size < 3)
+    {
+        return size;
+    }
+
+    // 'y' в начале слова и после гласной - согласная, помечается 'Y'
+    bool yFound = false;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (word[i] == 'y' && (i == 0 || isEnglishVowel(word[i - 1])))
+        {
+            word[i] = 'Y';
+            yFound = true;
+        }
+    }
+
+    // Области R1 и R2
+    size_t r1 = size;
+    for (std::string_view prefix : kEnglishRegionPrefixes)
+    {
+        if (original.starts_with(prefix))
+        {
+            r1 = prefix.size();
+            break;
+        }
+    }
+    if (r1 == size)
+    {
+        r1 = nextRegion(word, size, 0);
+    }
+    size_t r2 = nextRegion(word, size, r1);
+
+    auto view = [&]() { return std::string_view(word, size); };
+
+    // Шаг 1a: множественное число
+    if (view().ends_with("sses"))
+    {
+        size -= 2;
+    }
+    else if (view().ends_with("ied") || view().ends_with("ies"))
+    {
+        // "i", если перед окончанием больше одной буквы, иначе "ie"
+        size -= size > 4 ? 2 : 1;
+    }
+    else if (!view().ends_with("ss") && !view().ends_with("us") && view().ends_with("s") &&
+        hasEnglishVowel(word, size - 2))
+    {
+        size -= 1;
+    }
+
+    // Шаг 1b: -eed, -ed, -ing
+    static const Rule kStep1b[] = { { "eed", "ee" }, { "eedly", "ee" }, { "ed", "" }, { "edly", "" }, { "ing", "" }, { "ingly", "" } };
+    if (const Rule* rule = findLongest(view(), 0, kStep1b))
+    {
+        size_t start = size - rule->suffix.size();
+        std::string_view stem = view().substr(0, start);
+        bool keep = false;
+        if (!rule->replacement.empty())
+        {
+            keep = true;
+            bool exception = false;
+            for (std::string_view exceptionStem : kKeepEed)
+            {
+                exception = exception || stem == exceptionStem;
+            }
+            if (start >= r1 && !exception)
+            {
+                size = replaceSuffix(word, start, rule->replacement);
+            }
+        }
+        else if (rule->suffix == "ing")
+        {
+            // "dying" -> "die", "evening" и подобные не меняются
+            if (start == 2 && stem[1] == 'y' && !isEnglishVowel(stem[0]))
+            {
+                size = replaceSuffix(word, 1, "ie");
+                keep = true;
+            }
+            for (std::string_view exceptionStem : kKeepIng)
+            {
+                keep = keep || stem == exceptionStem;
+            }
+        }
+
+        if (!keep && hasEnglishVowel(word, start))
+        {
+            size = start;
+            if (view().ends_with("at") || view().ends_with("bl") || view().ends_with("iz"))
+            {
+                word[size++] = 'e';
+            }
+            else if (size >= 2 && word[size - 1] == word[size - 2] && isOneOf(word[size - 1], "bdfgmnprt"))
+            {
+                // Двойная согласная, кроме слов вида "add", "egg", "off"
+                if (size != 3 || !isOneOf(word[0], "aeo"))
+                {
+                    size--;
+                }
+            }
+            else if (size == r1 && endsWithShortSyllable(word, size))
+            {
+                word[size++] = 'e';
+            }
+        }
+    }
+
+    // Шаг 1c: конечная 'y' после согласной (не первой буквы) -> 'i'
+    if (size >= 3 && (word[size - 1] == 'y' || word[size - 1] == 'Y') && !isEnglishVowel(word[size - 2]))
+    {
+        word[size - 1] = 'i';
+    }
+
+    // Шаги 2-4: суффиксы в областях R1 и R2
+    if (const Rule* rule = findLongest(view(), 0, kStep2))
+    {
+        size_t start = size - rule->suffix.size();
+        bool allowed = start >= r1;
+        if (rule->condition == Condition::AfterL)
+        {
+            allowed = allowed && start > 0 && word[start - 1] == 'l';
+        }
+        else if (rule->condition == Condition::ValidLi)
+        {
+            allowed = allowed && start > 0 && isOneOf(word[start - 1], "cdeghkmnrt");
+        }
+        if (allowed)
+        {
+            size = replaceSuffix(word, start, rule->replacement);
+        }
+    }
+
+    if (const Rule* rule = findLongest(view(), 0, kStep3))
+    {
+        size_t start = size - rule->suffix.size();
+        if (start >= r1 && (rule->condition != Condition::InR2 || start >= r2))
+        {
+            size = replaceSuffix(word, start, rule->replacement);
+        }
+    }
+
+    if (const Rule* rule = findLongest(view(), 0, kStep4))
+    {
+        size_t start = size - rule->suffix.size();
+        if (start >= r2 && (rule->condition != Condition::AfterSOrT ||
+            (start > 0 && isOneOf(word[start - 1], "st"))))
+        {
+            size = start;
+        }
+    }
+
+    // Шаг 5: конечные 'e' и 'l'
+    if (size > 0 && word[size - 1] == 'e')
+    {
+        size_t start = size - 1;
+        if (start >= r2 || (start >= r1 && !endsWithShortSyllable(word, start)))
+        {
+            size = start;
+        }
+    }
+    else if (size > 0 && word[size - 1] == 'l')
+    {
+        size_t start = size - 1;
+        if (start >= r2 && start > 0 && word[start - 1] == 'l')
+        {
+            size = start;
+        }
+    }
+
+    if (yFound)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (word[i] == 'Y')
+            {
+                word[i] = 'y';
+            }
+        }
+    }
+    return size;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef STEMMER_H
+#define STEMMER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Приведение слова к основе: "программирования", "программированию" ->
+// "программирован", "running", "runs" -> "run". Разные формы одного слова
+// попадают в индекс одним термином, и запрос находит их все.
+//
+// Алгоритмы повторяют стеммеры Snowball для русского и английского
+// (Porter2) - окончания и условия перенесены таблицами. Основа пишется на
+// место слова: она никогда не длиннее исходного слова, поэтому память
+// не выделяется. Слово должно быть свёрнуто WordTokenizer::foldCase.
+// Язык определяется по алфавиту слова: только a-z - английский, только
+// а-я - русский; смешанные слова и слова с цифрами не меняются.
+class Stemmer
+{
+public:
+    enum Language : unsigned
+    {
+        None = 0,
+        Russian = 1,
+        English = 2
+    };
+
+    // Без языков - слова не меняются
+    Stemmer() = default;
+    explicit Stemmer(unsigned languages);
+
+    // Маска языков по названиям из конфигурации ("russian", "english";
+    // "none" или пустой список - ни одного)
+    static unsigned parseLanguages(const std::vector<std::string>& names);
+
+    // Стеммер для языков из конфигурации
+    static Stemmer fromNames(const std::vector<std::string>& names);
+
+    unsigned getLanguages() const;
+
+    // Основа слова на месте, возвращает её длину в байтах
+    size_t stem(char* word, size_t size) const;
+
+    static size_t stemRussian(char* word, size_t size);
+    static size_t stemEnglish(char* word, size_t size);
+
+private:
+    unsigned languages_ = None;
+};
+
+#endif // STEMMER_H
\ No newline at end of file
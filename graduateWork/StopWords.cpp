@@ -0,0 +1,238 @@
+#include "StopWords.h"
+#include "Stemmer.h"
+#include "WordTokenizer.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+
+namespace
+{
+    // Списки Snowball с самыми частыми словами сверх них. Слова короче
+    // трёх символов не индексируются и в списки не входят
+    constexpr std::string_view kRussianWords[] = {
+        "что", "как", "все", "она", "так", "его", "только", "мне", "было", "вот", "меня", "еще", "нет",
+        "ему", "теперь", "когда", "даже", "вдруг", "если", "уже", "или", "быть", "был", "него", "вас",
+        "нибудь", "опять", "вам", "ведь", "там", "потом", "себя", "ничего", "может", "они", "тут", "где",
+        "есть", "надо", "ней", "для", "тебя", "чем", "была", "сам", "чтоб", "без", "будто", "чего",
+        "раз", "тоже", "себе", "под", "будет", "тогда", "кто", "этот", "того", "потому", "этого", "какой",
+        "совсем", "ним", "здесь", "этом", "один", "почти", "мой", "тем", "чтобы", "нее", "сейчас", "были",
+        "куда", "зачем", "всех", "никогда", "можно", "при", "наконец", "два", "другой", "хоть", "после",
+        "над", "больше", "тот", "через", "эти", "нас", "про", "всего", "них", "какая", "много", "разве",
+        "три", "эту", "моя", "впрочем", "хорошо", "свою", "этой", "перед", "иногда", "лучше", "чуть", "том",
+        "нельзя", "такой", "более", "всегда", "конечно", "всю", "между",
+        "это", "эта", "этих", "этим", "этими", "также", "который", "которая", "которое", "которые",
+        "которых", "которым", "которой", "которого", "свой", "своей", "своих", "свои", "весь", "вся",
+        "всем", "тех", "лишь", "либо", "очень", "сама", "само", "сами", "будут", "нам", "ими", "наш",
+        "ваш", "такие", "такая", "такое", "однако", "поэтому", "кроме"
+    };
+
+    constexpr std::string_view kEnglishWords[] = {
+        "the", "and", "for", "are", "but", "not", "you", "all", "any", "can", "had", "her", "was", "one",
+        "our", "out", "his", "has", "him", "how", "its", "who", "did", "does", "doing", "she", "too",
+        "very", "own", "same", "than", "nor", "few", "more", "most", "other", "some", "such", "only",
+        "ours", "ourselves", "your", "yours", "yourself", "yourselves", "himself", "hers", "herself",
+        "itself", "they", "them", "their", "theirs", "themselves", "what", "which", "whom", "this",
+        "that", "these", "those", "were", "been", "being", "have", "having", "would", "should", "could",
+        "ought", "because", "until", "while", "with", "about", "against", "between", "into", "through",
+        "during", "before", "after", "above", "below", "from", "down", "off", "over", "under", "again",
+        "further", "then", "once", "here", "there", "when", "where", "why", "both", "each", "will",
+        "just", "also", "myself"
+    };
+
+    constexpr size_t kRussianCount = std::size(kRussianWords);
+    constexpr size_t kWordCount = kRussianCount + std::size(kEnglishWords);
+
+    constexpr std::string_view wordAt(size_t index)
+    {
+        return index < kRussianCount ? kRussianWords[index] : kEnglishWords[index - kRussianCount];
+    }
+
+    // FNV-1a, как у TermCounter
+    constexpr uint64_t hashWord(std::string_view word)
+    {
+        uint64_t value = 14695981039346656037ull;
+        for (char c : word)
+        {
+            value ^= static_cast<unsigned char>(c);
+            value *= 1099511628211ull;
+        }
+        return value;
+    }
+
+    // Совершенный хеш "хеширование со смещением": слово попадает в корзину,
+    // у каждой корзины своё смещение, подобранное так, чтобы все слова
+    // таблицы заняли разные ячейки
+    constexpr size_t kBucketCount = 128;
+    constexpr size_t kSlotCount = 1024;   // степень двойки
+    constexpr size_t kMaxBucketSize = 16;
+    constexpr uint32_t kMaxDisplacement = 4096;
+    constexpr uint16_t kEmptySlot = 0xFFFF;
+
+    static_assert(kWordCount < kSlotCount / 2, "таблица стоп-слов заполнена больше чем наполовину");
+
+    constexpr size_t bucketOf(uint64_t hash)
+    {
+        return static_cast<size_t>(hash >> 48) % kBucketCount;
+    }
+
+    constexpr size_t slotOf(uint64_t hash, uint32_t displacement)
+    {
+        uint32_t base = static_cast<uint32_t>(hash);
+        uint32_t step = static_cast<uint32_t>(hash >> 32) | 1u;
+        return static_cast<size_t>(base + displacement * step) & (kSlotCount - 1);
+    }
+
+    struct PerfectHash
+    {
+        uint16_t displacements[kBucketCount]{};
+        uint16_t slots[kSlotCount]{};
+        bool built = false;
+    };
+
+    constexpr PerfectHash buildPerfectHash()
+    {
+        PerfectHash table;
+        for (uint16_t& slot : table.slots)
+        {
+            slot = kEmptySlot;
+        }
+
+        // Слова по корзинам. Повтор слова в списках попадает в ту же
+        // корзину с тем же хешем - таким словам не найти разных ячеек
+        uint64_t hashes[kWordCount]{};
+        uint16_t members[kBucketCount][kMaxBucketSize]{};
+        size_t sizes[kBucketCount]{};
+        for (size_t i = 0; i < kWordCount; ++i)
+        {
+            hashes[i] = hashWord(wordAt(i));
+            size_t bucket = bucketOf(hashes[i]);
+            if (sizes[bucket] == kMaxBucketSize)
+            {
+                return table;
+            }
+            for (size_t k = 0; k < sizes[bucket]; ++k)
+            {
+                if (hashes[members[bucket][k]] == hashes[i])
+                {
+                    return table;
+                }
+            }
+            members[bucket][sizes[bucket]++] = static_cast<uint16_t>(i);
+        }
+
+        // Большие корзины размещаются первыми, пока таблица свободна
+        size_t order[kBucketCount]{};
+        size_t ordered = 0;
+        for (size_t size = kMaxBucketSize; size > 0; --size)
+        {
+            for (size_t bucket = 0; bucket < kBucketCount; ++bucket)
+            {
+                if (sizes[bucket] == size)
+                {
+                    order[ordered++] = bucket;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < ordered; ++i)
+        {
+            size_t bucket = order[i];
+            bool placed = false;
+            for (uint32_t displacement = 0; !placed && displacement <= kMaxDisplacement; ++displacement)
+            {
+                placed = true;
+                size_t chosen[kMaxBucketSize]{};
+                for (size_t k = 0; placed && k < sizes[bucket]; ++k)
+                {
+                    chosen[k] = slotOf(hashes[members[bucket][k]], displacement);
+                    placed = table.slots[chosen[k]] == kEmptySlot;
+                    for (size_t prev = 0; placed && prev < k; ++prev)
+                    {
+                        placed = chosen[prev] != chosen[k];
+                    }
+                }
+
+                if (placed)
+                {
+                    table.displacements[bucket] = static_cast<uint16_t>(displacement);
+                    for (size_t k = 0; k < sizes[bucket]; ++k)
+                    {
+                        table.slots[chosen[k]] = members[bucket][k];
+                    }
+                }
+            }
+
+            if (!placed)
+            {
+                return table;
+            }
+        }
+
+        table.built = true;
+        return table;
+    }
+
+    constexpr PerfectHash kTable = buildPerfectHash();
+    static_assert(kTable.built, "совершенный хеш стоп-слов не построен - слово повторяется в списках?");
+}
+
+StopWords::StopWords(unsigned languages, const std::string& extraFile)
+    : languages_(languages)
+{
+    if (!extraFile.empty())
+    {
+        loadExtra(extraFile);
+    }
+}
+
+bool StopWords::isBuiltin(std::string_view word, unsigned languages)
+{
+    uint64_t hash = hashWord(word);
+    uint16_t index = kTable.slots[slotOf(hash, kTable.displacements[bucketOf(hash)])];
+    if (index == kEmptySlot || wordAt(index) != word)
+    {
+        return false;
+    }
+    unsigned language = index < kRussianCount ? Stemmer::Russian : Stemmer::English;
+    return (languages & language) != 0;
+}
+
+bool StopWords::contains(std::string_view word) const
+{
+    if (isBuiltin(word, languages_))
+    {
+        return true;
+    }
+    return !extra_.empty() && std::binary_search(extra_.begin(), extra_.end(), word);
+}
+
+size_t StopWords::getExtraCount() const
+{
+    return extra_.size();
+}
+
+void StopWords::loadExtra(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::cerr << "⚠️  Не удалось открыть файл стоп-слов: " << path << std::endl;
+        return;
+    }
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        line = line.substr(0, line.find('#'));
+
+        // Слова файла нормализуются так же, как слова страниц
+        WordTokenizer::forEachWord(line, [this](std::string_view word) {
+            extra_.emplace_back(word);
+        });
+    }
+
+    std::sort(extra_.begin(), extra_.end());
+    extra_.erase(std::unique(extra_.begin(), extra_.end()), extra_.end());
+    std::cout << "🚫 Дополнительных стоп-слов: " << extra_.size() << " (" << path << ")" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef STOPWORDS_H
+#define STOPWORDS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// Стоп-слова: служебные и самые частые слова ("что", "это", "для",
+// "the", "and"), которые не попадают в индекс и отбрасываются из запроса.
+// Их списки документов самые длинные и при этом ничего не уточняют.
+//
+// Встроенные списки для русского и английского лежат в совершенной
+// хеш-таблице, построенной при компиляции: проверка слова - один хеш и
+// одно сравнение строк. Дополнительные слова читаются из файла при запуске
+// (по слову или несколько через пробел в строке, '#' - комментарий).
+// Слова сравниваются в свёрнутой форме (WordTokenizer::foldCase), до
+// приведения к основе. Только для чтения - безопасно из любых потоков.
+class StopWords
+{
+public:
+    // Пустой фильтр
+    StopWords() = default;
+
+    // languages - маска Stemmer::Language для встроенных списков,
+    // extraFile - файл дополнительных слов (пусто - без него)
+    explicit StopWords(unsigned languages, const std::string& extraFile = "");
+
+    bool contains(std::string_view word) const;
+
+    // Число дополнительных слов из файла
+    size_t getExtraCount() const;
+
+    // Слово из встроенного списка одного из языков
+    static bool isBuiltin(std::string_view word, unsigned languages);
+
+private:
+    unsigned languages_ = 0;
+    std::vector<std::string> extra_;   // отсортированы для двоичного поиска
+
+    void loadExtra(const std::string& path);
+};
+
+#endif // STOPWORDS_H
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "SyntheticSite.h"
+#include <random>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+    std::string formatResponse(int statusCode, const std::string& statusText, const std::string& body)
+    {
+        std::ostringstream response;
+        response << "HTTP/1.1 " << statusCode << " " << statusText << "\r\n"
+            << "Content-Type: text/html; charset=utf-8\r\n"
+            << "Content-Length: " << body.size() << "\r\n"
+            << "Connection: close\r\n"
+            << "\r\n"
+            << body;
+        return response.str();
+    }
+}
+
+// Состояние одного соединения: живёт, пока на него ссылаются обработчики
+struct SyntheticSite::Session
+{
+    explicit Session(boost::asio::io_context& ioContext)
+        : socket(ioContext)
+        , timer(ioContext)
+    {
+    }
+
+    tcp::socket socket;
+    boost::asio::steady_timer timer;
+    boost::asio::streambuf request;
+    std::string response;
+};
+
+SyntheticSite::SyntheticSite(const Options& options)
+    : options_(options)
+    , requestsServed_(0)
+    , errorsServed_(0)
+    , bytesServed_(0)
+{
+    options_.pages = std::max(1, options_.pages);
+    options_.fanout = std::max(1, options_.fanout);
+    options_.hosts = std::max(1, options_.hosts);
+    options_.threads = std::max(1, options_.threads);
+
+    // Словарь из псевдослов: латинские и русские слоги
+    static const char* syllables[] = {
+        "ka", "lo", "mi", "ne", "tor", "sa", "vi", "den", "ru", "pol",
+        "ма", "ро", "ли", "на", "ста", "вер", "ко", "ды", "пе", "шу"
+    };
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> syllable(0, 19);
+    std::uniform_int_distribution<int> length(2, 4);
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::string word;
+        int count = length(generator);
+        bool cyrillic = i % 2 == 1;
+        for (int j = 0; j < count; ++j)
+        {
+            word += syllables[syllable(generator) % 10 + (cyrillic ? 10 : 0)];
+        }
+        vocabulary_.push_back(std::move(word));
+    }
+}
+
+SyntheticSite::~SyntheticSite()
+{
+    stop();
+}
+
+std::string SyntheticSite::pageUrl(int page) const
+{
+    return "http://site" + std::to_string(page % options_.hosts) + ".localhost:" + std::to_string(options_.port) +
+        "/" + options_.runId + "/page" + std::to_string(page) + ".html";
+}
+
+std::string SyntheticSite::getStartUrl() const
+{
+    return pageUrl(0);
+}
+
+int SyntheticSite::requiredDepth() const
+{
+    // Полное дерево глубины d с ветвлением fanout содержит 1 + f + ... + f^d страниц
+    long long covered = 1;
+    long long level = 1;
+    int depth = 0;
+    while (covered < options_.pages)
+    {
+        level *= options_.fanout;
+        covered += level;
+        depth++;
+    }
+    return depth;
+}
+
+std::string SyntheticSite::buildPage(int page) const
+{
+    // Генератор от номера страницы: содержимое одинаково при каждом запросе
+    std::mt19937 generator(static_cast<unsigned>(page) * 2654435761u + 1);
+
+    // Распределение слов близко к закону Ципфа: частые слова встречаются
+    // на многих страницах, редкие - на немногих
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto pickWord = [&]() -> const std::string& {
+        double x = uniform(generator);
+        size_t index = static_cast<size_t>(vocabulary_.size() * x * x * x);
+        return vocabulary_[std::min(index, vocabulary_.size() - 1)];
+    };
+
+    std::string html;
+    html.reserve(static_cast<size_t>(options_.pageSize) + 1024);
+    html += "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>Страница " +
+        std::to_string(page) + " " + pickWord() + "</title>\n</head>\n<body>\n<h1>" + pickWord() + " " + pickWord() + "</h1>\n";
+
+    // Ссылки: дочерние страницы дерева и случайные перекрёстные
+    html += "<ul>\n";
+    std::uniform_int_distribution<int> anyPage(0, options_.pages - 1);
+    long long firstChild = static_cast<long long>(page) * options_.fanout + 1;
+    for (int i = 0; i < options_.fanout; ++i)
+    {
+        long long child = firstChild + i;
+        int target = child < options_.pages ? static_cast<int>(child) : anyPage(generator);
+        html += "<li><a href=\"" + pageUrl(target) + "\">" + pickWord() + "</a></li>\n";
+    }
+    for (int i = 0; i < options_.fanout / 2; ++i)
+    {
+        html += "<li><a href=\"" + pageUrl(anyPage(generator)) + "\">" + pickWord() + "</a></li>\n";
+    }
+    html += "</ul>\n";
+
+    // Текст абзацами до нужного размера
+    while (html.size() < static_cast<size_t>(options_.pageSize))
+    {
+        html += "<p>";
+        for (int i = 0; i < 40; ++i)
+        {
+            html += pickWord();
+            html += ' ';
+        }
+        html += "</p>\n";
+    }
+
+    html += "</body>\n</html>\n";
+    return html;
+}
+
+std::string SyntheticSite::buildResponse(const std::string& requestLine)
+{
+    std::istringstream stream(requestLine);
+    std::string method, path;
+    stream >> method >> path;
+
+    // Путь вида /<runId>/page<N>.html
+    std::string prefix = "/" + options_.runId + "/page";
+    int page = -1;
+    if (method == "GET" && path.rfind(prefix, 0) == 0)
+    {
+        try
+        {
+            page = std::stoi(path.substr(prefix.size()));
+        }
+        catch (const std::exception&)
+        {
+            page = -1;
+        }
+    }
+
+    if (page < 0 || page >= options_.pages)
+    {
+        errorsServed_++;
+        return formatResponse(404, "Not Found", "<html><body>404</body></html>");
+    }
+
+    if (options_.errorRate > 0.0)
+    {
+        thread_local std::mt19937 generator(std::random_device{}());
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        double roll = uniform(generator);
+        if (roll < options_.errorRate)
+        {
+            errorsServed_++;
+            // Половина ошибок - перегрузка (503), половина - сбой сервера
+            return roll < options_.errorRate / 2
+                ? formatResponse(503, "Service Unavailable", "<html><body>503</body></html>")
+                : formatResponse(500, "Internal Server Error", "<html><body>500</body></html>");
+        }
+    }
+
+    return formatResponse(200, "OK", buildPage(page));
+}
+
+void SyntheticSite::start()
+{
+    tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), static_cast<unsigned short>(options_.port));
+    acceptor_ = std::make_unique<tcp::acceptor>(ioContext_, endpoint);
+
+    doAccept();
+
+    for (int i = 0; i < options_.threads; ++i)
+    {
+        threads_.emplace_back([this]() {
+            ioContext_.run();
+            });
+    }
+
+    std::cout << "🧪 Синтетический сайт: " << options_.pages << " страниц на " << options_.hosts
+        << " хостах, порт " << options_.port << std::endl;
+}
+
+void SyntheticSite::stop()
+{
+    ioContext_.stop();
+
+    for (auto& thread : threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    threads_.clear();
+
+    if (acceptor_)
+    {
+        boost::system::error_code ec;
+        acceptor_->close(ec);
+        acceptor_.reset();
+    }
+}
+
+void SyntheticSite::doAccept()
+{
+    auto session = std::make_shared<Session>(ioContext_);
+    acceptor_->async_accept(session->socket, [this, session](const boost::system::error_code& ec) {
+        if (!acceptor_ || !acceptor_->is_open())
+        {
+            return;
+        }
+        if (!ec)
+        {
+            handleSession(session);
+        }
+        doAccept();
+        });
+}
+
+void SyntheticSite::handleSession(std::shared_ptr<Session> session)
+{
+    boost::asio::async_read_until(session->socket, session->request, "\r\n\r\n",
+        [this, session](const boost::system::error_code& ec, size_t) {
+            if (ec)
+            {
+                return;
+            }
+
+            std::istream stream(&session->request);
+            std::string requestLine;
+            std::getline(stream, requestLine);
+
+            session->response = buildResponse(requestLine);
+            requestsServed_++;
+            bytesServed_ += static_cast<long long>(session->response.size());
+
+            auto send = [this, session]() {
+                boost::asio::async_write(session->socket, boost::asio::buffer(session->response),
+                    [session](const boost::system::error_code&, size_t) {
+                        boost::system::error_code ignored;
+                        session->socket.shutdown(tcp::socket::shutdown_both, ignored);
+                        session->socket.close(ignored);
+                    });
+            };
+
+            // Задержка без блокировки потока: ответ отправится по таймеру
+            if (options_.latencyMs > 0)
+            {
+                session->timer.expires_after(std::chrono::milliseconds(options_.latencyMs));
+                session->timer.async_wait([send](const boost::system::error_code& ec) {
+                    if (!ec)
+                    {
+                        send();
+                    }
+                    });
+            }
+            else
+            {
+                send();
+            }
+        });
+}
+
+long long SyntheticSite::getRequestsServed() const
+{
+    return requestsServed_;
+}
+
+long long SyntheticSite::getErrorsServed() const
+{
+    return errorsServed_;
+}
+
+long long SyntheticSite::getBytesServed() const
+{
+    return bytesServed_;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef SYNTHETICSITE_H
+#define SYNTHETICSITE_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <boost/asio.hpp>
+
+using boost::asio::ip::tcp;
+
+// Локальный HTTP-сервер с синтетическим графом страниц для замеров паука.
+// Страница N ссылается на N*fanout+1 ... N*fanout+fanout (дерево, чтобы весь
+// сайт был достижим за небольшую глубину) и на несколько случайных страниц.
+// Страницы распределены по виртуальным хостам siteK.localhost (libcurl
+// разрешает *.localhost в адрес локальной петли без DNS).
+// Содержимое детерминировано номером страницы, задержка и ошибки 500/503
+// добавляются по параметрам. Все запросы обслуживаются асинхронно
+class SyntheticSite
+{
+public:
+    struct Options
+    {
+        int pages = 1000;        // число страниц
+        int fanout = 10;         // ссылок на страницу
+        int pageSize = 16384;    // примерный размер страницы (байт)
+        int latencyMs = 0;       // задержка перед ответом
+        double errorRate = 0.0;  // доля ответов с ошибкой
+        int hosts = 1;           // число виртуальных хостов
+        int port = 8090;
+        int threads = 4;         // потоков io_context
+        std::string runId;       // префикс путей: у каждого запуска свои URL
+    };
+
+    explicit SyntheticSite(const Options& options);
+    ~SyntheticSite();
+
+    SyntheticSite(const SyntheticSite&) = delete;
+    SyntheticSite& operator=(const SyntheticSite&) = delete;
+
+    void start();
+    void stop();
+
+    // URL страницы по номеру (страница 0 - стартовая)
+    std::string pageUrl(int page) const;
+    std::string getStartUrl() const;
+
+    // Глубина обхода, на которой достижимы все страницы
+    int requiredDepth() const;
+
+    // HTML страницы по номеру (без запуска сервера)
+    std::string buildPage(int page) const;
+
+    long long getRequestsServed() const;
+    long long getErrorsServed() const;
+    long long getBytesServed() const;
+
+private:
+    struct Session;
+
+    Options options_;
+    std::vector<std::string> vocabulary_;
+
+    boost::asio::io_context ioContext_;
+    std::unique_ptr<tcp::acceptor> acceptor_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<long long> requestsServed_;
+    std::atomic<long long> errorsServed_;
+    std::atomic<long long> bytesServed_;
+
+    void doAccept();
+    void handleSession(std::shared_ptr<Session> session);
+
+    // Ответ на строку запроса "GET /path HTTP/1.1"
+    std::string buildResponse(const std::string& requestLine);
+};
+
+#endif // SYNTHETICSITE_H
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "TermCounter.h"
+#include <cstring>
+
+namespace
+{
+    constexpr size_t kInitialCapacity = 1024;
+}
+
+TermCounter::TermCounter()
+    : slots_(kInitialCapacity)
+{
+}
+
+uint64_t TermCounter::hash(std::string_view term)
+{
+    // FNV-1a: слова короткие, а качества хватает для линейного пробирования
+    uint64_t value = 14695981039346656037ull;
+    for (char c : term)
+    {
+        value ^= static_cast<unsigned char>(c);
+        value *= 1099511628211ull;
+    }
+    return value;
+}
+
+void TermCounter::add(std::string_view term, uint32_t position)
+{
+    if ((used_.size() + 1) * 2 > slots_.size())
+    {
+        grow();
+    }
+
+    uint64_t termHash = hash(term);
+    size_t mask = slots_.size() - 1;
+    size_t index = static_cast<size_t>(termHash) & mask;
+    while (true)
+    {
+        Slot& slot = slots_[index];
+        if (!slot.data)
+        {
+            slot.data = term.data();
+            slot.length = static_cast<uint32_t>(term.size());
+            slot.count = 1;
+            slot.hash = termHash;
+            slot.ordinal = static_cast<uint32_t>(used_.size());
+            used_.push_back(static_cast<uint32_t>(index));
+            occurrences_.push_back({ slot.ordinal, position });
+            return;
+        }
+        if (slot.hash == termHash && slot.length == term.size() &&
+            std::memcmp(slot.data, term.data(), term.size()) == 0)
+        {
+            slot.count++;
+            occurrences_.push_back({ slot.ordinal, position });
+            return;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+void TermCounter::grow()
+{
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+
+    size_t mask = slots_.size() - 1;
+    for (uint32_t& position : used_)
+    {
+        const Slot& slot = old[position];
+        size_t index = static_cast<size_t>(slot.hash) & mask;
+        while (slots_[index].data)
+        {
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+        position = static_cast<uint32_t>(index);
+    }
+}
+
+size_t TermCounter::size() const
+{
+    return used_.size();
+}
+
+void TermCounter::extract(TermList& out, bool byFrequency)
+{
+    // Раскладка позиций по словам подсчётом: ends_[i] сначала указывает
+    // на начало группы слова i и после раскладки - на её конец.
+    // Внутри группы позиции остаются в порядке текста
+    ends_.resize(used_.size());
+    size_t bytes = 0;
+    uint32_t offset = 0;
+    for (size_t i = 0; i < used_.size(); ++i)
+    {
+        const Slot& slot = slots_[used_[i]];
+        bytes += slot.length;
+        ends_[i] = offset;
+        offset += static_cast<uint32_t>(slot.count);
+    }
+    positions_.resize(occurrences_.size());
+    for (const Occurrence& occurrence : occurrences_)
+    {
+        positions_[ends_[occurrence.ordinal]++] = occurrence.position;
+    }
+
+    out.clear();
+    out.reserve(used_.size(), bytes, positions_.size() * 2);
+    uint32_t begin = 0;
+    for (size_t i = 0; i < used_.size(); ++i)
+    {
+        const Slot& slot = slots_[used_[i]];
+        out.add(std::string_view(slot.data, slot.length), slot.count,
+            std::span<const uint32_t>(positions_.data() + begin, ends_[i] - begin));
+        begin = ends_[i];
+    }
+
+    if (byFrequency)
+    {
+        out.sortByFrequency();
+    }
+}
+
+void TermCounter::clear()
+{
+    for (uint32_t position : used_)
+    {
+        slots_[position] = Slot();
+    }
+    used_.clear();
+    occurrences_.clear();
+}
\ No newline at end of file
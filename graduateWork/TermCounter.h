@@ -0,0 +1,69 @@
+#ifndef TERMCOUNTER_H
+#define TERMCOUNTER_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "TermList.h"
+
+// Подсчёт частот и позиций слов страницы в хеш-таблице с открытой
+// адресацией (линейное пробирование, заполнение не больше половины).
+// Вхождения копятся одним массивом в порядке текста и раскладываются по
+// словам подсчётом при extract().
+// Ключи не копируются: таблица хранит string_view, и строки должны жить
+// до clear() - индексатор держит их в BumpArena страницы. Таблица и
+// список занятых ячеек после clear() сохраняют ёмкость, поэтому подсчёт
+// на установившемся потоке страниц не выделяет память.
+// Объект не потокобезопасен: одна таблица на поток.
+class TermCounter
+{
+public:
+    TermCounter();
+
+    // Учёт одного вхождения слова; position - номер слова в тексте,
+    // позиции передаются по возрастанию
+    void add(std::string_view term, uint32_t position);
+
+    // Число различных слов
+    size_t size() const;
+
+    // Слова, частоты и позиции в порядке первого появления. С byFrequency -
+    // по убыванию частоты (сортировка нужна не всем, поэтому по запросу)
+    void extract(TermList& out, bool byFrequency = false);
+
+    // Очистка с сохранением ёмкости
+    void clear();
+
+private:
+    struct Slot
+    {
+        const char* data = nullptr;   // nullptr - ячейка свободна
+        uint32_t length = 0;
+        int count = 0;
+        uint64_t hash = 0;
+        uint32_t ordinal = 0;         // номер слова в used_
+    };
+
+    struct Occurrence
+    {
+        uint32_t ordinal;
+        uint32_t position;
+    };
+
+    std::vector<Slot> slots_;       // размер - степень двойки
+    std::vector<uint32_t> used_;    // занятые ячейки в порядке появления
+    std::vector<Occurrence> occurrences_;
+
+    // Рабочие массивы extract(): позиции, сгруппированные по словам,
+    // и границы групп
+    std::vector<uint32_t> positions_;
+    std::vector<uint32_t> ends_;
+
+    static uint64_t hash(std::string_view term);
+
+    // Удвоение таблицы с перераспределением ключей
+    void grow();
+};
+
+#endif // TERMCOUNTER_H
\ No newline at end of file
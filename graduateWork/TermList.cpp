@@ -0,0 +1,66 @@
+#include "TermList.h"
+#include "PositionList.h"
+#include <algorithm>
+
+void TermList::reserve(size_t terms, size_t bytes, size_t positionBytes)
+{
+    entries_.reserve(terms);
+    text_.reserve(bytes);
+    positions_.reserve(positionBytes);
+}
+
+void TermList::add(std::string_view term, int count, std::span<const uint32_t> positions)
+{
+    size_t positionsOffset = positions_.size();
+    PositionList::encode(positions, positions_);
+    entries_.push_back({ static_cast<uint32_t>(text_.size()), static_cast<uint32_t>(term.size()), count,
+        static_cast<uint32_t>(positionsOffset), static_cast<uint32_t>(positions_.size() - positionsOffset) });
+    text_.append(term);
+}
+
+TermList::value_type TermList::operator[](size_t index) const
+{
+    const Entry& entry = entries_[index];
+    return { std::string_view(text_).substr(entry.offset, entry.length), entry.count };
+}
+
+std::string_view TermList::getPositions(size_t index) const
+{
+    const Entry& entry = entries_[index];
+    return std::string_view(positions_).substr(entry.positionsOffset, entry.positionsLength);
+}
+
+size_t TermList::size() const
+{
+    return entries_.size();
+}
+
+bool TermList::empty() const
+{
+    return entries_.empty();
+}
+
+void TermList::clear()
+{
+    text_.clear();
+    positions_.clear();
+    entries_.clear();
+}
+
+void TermList::sortByFrequency()
+{
+    std::stable_sort(entries_.begin(), entries_.end(),
+        [](const Entry& a, const Entry& b) {
+            return a.count > b.count;
+        });
+}
+
+TermList::Iterator TermList::begin() const
+{
+    return Iterator(this, 0);
+}
+
+TermList::Iterator TermList::end() const
+{
+    return Iterator(this, entries_.size());
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#ifndef TERMLIST_H
+#define TERMLIST_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+// Слова страницы с частотами и позициями. Слова лежат подряд в одном
+// буфере, позиции (PositionList) - в другом, а записи хранят смещения,
+// поэтому список из тысяч слов - это три аллокации, а не строка на
+// каждое слово. Смещения (а не указатели) позволяют свободно перемещать
+// список между стадиями конвейера.
+// Элемент при обходе - пара (слово, частота), как у вектора пар.
+class TermList
+{
+public:
+    using value_type = std::pair<std::string_view, int>;
+
+    class Iterator
+    {
+    public:
+        Iterator(const TermList* list, size_t index)
+            : list_(list)
+            , index_(index)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return (*list_)[index_];
+        }
+
+        Iterator& operator++()
+        {
+            ++index_;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return index_ == other.index_;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return index_ != other.index_;
+        }
+
+    private:
+        const TermList* list_;
+        size_t index_;
+    };
+
+    TermList() = default;
+
+    // Место под terms слов общей длиной bytes байт и positionBytes
+    // байт закодированных позиций
+    void reserve(size_t terms, size_t bytes, size_t positionBytes = 0);
+
+    // Слово с частотой и позициями по возрастанию (могут отсутствовать)
+    void add(std::string_view term, int count, std::span<const uint32_t> positions = {});
+
+    value_type operator[](size_t index) const;
+
+    // Позиции слова в формате PositionList (пусто - не записаны)
+    std::string_view getPositions(size_t index) const;
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    // Упорядочить по убыванию частоты (равные - в прежнем порядке)
+    void sortByFrequency();
+
+    Iterator begin() const;
+    Iterator end() const;
+
+private:
+    struct Entry
+    {
+        uint32_t offset;
+        uint32_t length;
+        int count;
+        uint32_t positionsOffset;
+        uint32_t positionsLength;
+    };
+
+    std::string text_;
+    std::string positions_;
+    std::vector<Entry> entries_;
+};
+
+#endif // TERMLIST_H
\ No newline at end of file
@@ -0,0 +1,419 @@
+#include "TextScan.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TEXTSCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC разрешает встроенные функции любого набора инструкций без ключей
+// компилятора, GCC и Clang - только в функциях с атрибутом target
+#if defined(_MSC_VER)
+#define TEXTSCAN_TARGET(name)
+#else
+#define TEXTSCAN_TARGET(name) __attribute__((target(name)))
+#endif
+
+namespace
+{
+    // Классы байт для скалярного просмотра
+    constexpr uint8_t kWord = 1;       // латинская буква, цифра, '_'
+    constexpr uint8_t kLead = 2;       // ведущий байт U+0400..U+07FF (0xD0..0xDF)
+    constexpr uint8_t kCont = 4;       // байт продолжения UTF-8 (0x80..0xBF)
+    constexpr uint8_t kNonAscii = 8;   // любой байт вне ASCII
+    constexpr uint8_t kMarkup = 16;    // '<' и '&'
+    constexpr uint8_t kSpace = 32;     // пробельный символ
+
+    constexpr std::array<uint8_t, 256> kClasses = [] {
+        std::array<uint8_t, 256> classes{};
+        for (int c = 0; c < 256; ++c)
+        {
+            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_')
+            {
+                classes[c] |= kWord;
+            }
+            if (c >= 0xD0 && c <= 0xDF)
+            {
+                classes[c] |= kLead;
+            }
+            if (c >= 0x80 && c <= 0xBF)
+            {
+                classes[c] |= kCont;
+            }
+            if (c >= 0x80)
+            {
+                classes[c] |= kNonAscii;
+            }
+            if (c == '<' || c == '&')
+            {
+                classes[c] |= kMarkup;
+            }
+            if (c == ' ' || (c >= '\t' && c <= '\r'))
+            {
+                classes[c] |= kSpace;
+            }
+        }
+        return classes;
+    }();
+
+    // Маски классов блока до проверки пар UTF-8
+    struct RawMasks
+    {
+        uint64_t word = 0;
+        uint64_t leads = 0;
+        uint64_t conts = 0;
+        uint64_t nonAscii = 0;
+        uint64_t markup = 0;
+        uint64_t space = 0;
+    };
+
+    // Двухбайтовый символ входит в слово, только если ведущий байт стоит
+    // прямо перед продолжением. Прочие байты вне ASCII (в том числе пара,
+    // разрезанная границей блока) остаются вызывающему коду
+    inline TextScan::Block finishBlock(const RawMasks& raw)
+    {
+        uint64_t pairLeads = raw.leads & (raw.conts >> 1);
+        uint64_t pairs = pairLeads | (pairLeads << 1);
+        return { raw.word | pairs, raw.markup | (raw.nonAscii & ~pairs), raw.space };
+    }
+
+    TextScan::Block classifyScalar(const char* data)
+    {
+        RawMasks raw;
+        for (size_t i = 0; i < TextScan::kBlockSize; ++i)
+        {
+            uint8_t cls = kClasses[static_cast<unsigned char>(data[i])];
+            uint64_t bit = uint64_t{ 1 } << i;
+            raw.word |= (cls & kWord) ? bit : 0;
+            raw.leads |= (cls & kLead) ? bit : 0;
+            raw.conts |= (cls & kCont) ? bit : 0;
+            raw.nonAscii |= (cls & kNonAscii) ? bit : 0;
+            raw.markup |= (cls & kMarkup) ? bit : 0;
+            raw.space |= (cls & kSpace) ? bit : 0;
+        }
+        return finishBlock(raw);
+    }
+
+    size_t findAnyTail(const char* data, size_t pos, size_t size, char a, char b, char c)
+    {
+        for (; pos < size; ++pos)
+        {
+            char byte = data[pos];
+            if (byte == a || byte == b || byte == c)
+            {
+                return pos;
+            }
+        }
+        return size;
+    }
+
+    size_t findAnyScalar(const char* data, size_t size, char a, char b, char c)
+    {
+        return findAnyTail(data, 0, size, a, b, c);
+    }
+
+#ifdef TEXTSCAN_X86
+    // Байты v в диапазоне [low, low + count): сравнение без знака через
+    // минимум, так как в SSE2 нет беззнакового сравнения байт
+    TEXTSCAN_TARGET("sse2")
+    inline __m128i inRange128(__m128i v, char low, int count)
+    {
+        __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(low));
+        return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(count - 1))), shifted);
+    }
+
+    TEXTSCAN_TARGET("sse2")
+    inline __m128i wordMask128(__m128i v)
+    {
+        __m128i digit = inRange128(v, '0', 10);
+        __m128i letter = inRange128(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+        __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        return _mm_or_si128(_mm_or_si128(digit, letter), underscore);
+    }
+
+    // Старшие биты байт маски, сдвинутые на shift
+    TEXTSCAN_TARGET("sse2")
+    inline uint64_t maskBits128(__m128i mask, unsigned shift)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(mask))) << shift;
+    }
+
+    // Маски классов 16 байт с data, сдвинутые на shift бит
+    TEXTSCAN_TARGET("sse2")
+    inline void classify128(const char* data, unsigned shift, RawMasks& raw)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        raw.word |= maskBits128(wordMask128(v), shift);
+        raw.leads |= maskBits128(inRange128(v, static_cast<char>(0xD0), 16), shift);
+        raw.conts |= maskBits128(inRange128(v, static_cast<char>(0x80), 64), shift);
+        raw.nonAscii |= maskBits128(v, shift);
+        raw.markup |= maskBits128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('<')), _mm_cmpeq_epi8(v, _mm_set1_epi8('&'))), shift);
+        raw.space |= maskBits128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange128(v, '\t', 5)), shift);
+    }
+
+    TEXTSCAN_TARGET("sse2")
+    TextScan::Block classifySse2(const char* data)
+    {
+        RawMasks raw;
+        classify128(data, 0, raw);
+        classify128(data + 16, 16, raw);
+        classify128(data + 32, 32, raw);
+        classify128(data + 48, 48, raw);
+        return finishBlock(raw);
+    }
+
+    TEXTSCAN_TARGET("sse2")
+    size_t findAnySse2(const char* data, size_t size, char a, char b, char c)
+    {
+        __m128i va = _mm_set1_epi8(a);
+        __m128i vb = _mm_set1_epi8(b);
+        __m128i vc = _mm_set1_epi8(c);
+        size_t pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(found));
+            if (mask)
+            {
+                return pos + static_cast<size_t>(std::countr_zero(mask));
+            }
+        }
+        return findAnyTail(data, pos, size, a, b, c);
+    }
+
+    TEXTSCAN_TARGET("avx2")
+    inline __m256i inRange256(__m256i v, char low, int count)
+    {
+        __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(low));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(count - 1))), shifted);
+    }
+
+    TEXTSCAN_TARGET("avx2")
+    inline __m256i wordMask256(__m256i v)
+    {
+        __m256i digit = inRange256(v, '0', 10);
+        __m256i letter = inRange256(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26);
+        __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        return _mm256_or_si256(_mm256_or_si256(digit, letter), underscore);
+    }
+
+    TEXTSCAN_TARGET("avx2")
+    inline uint64_t maskBits256(__m256i mask, unsigned shift)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(mask))) << shift;
+    }
+
+    TEXTSCAN_TARGET("avx2")
+    inline void classify256(const char* data, unsigned shift, RawMasks& raw)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        raw.word |= maskBits256(wordMask256(v), shift);
+        raw.leads |= maskBits256(inRange256(v, static_cast<char>(0xD0), 16), shift);
+        raw.conts |= maskBits256(inRange256(v, static_cast<char>(0x80), 64), shift);
+        raw.nonAscii |= maskBits256(v, shift);
+        raw.markup |= maskBits256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('&'))), shift);
+        raw.space |= maskBits256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), inRange256(v, '\t', 5)), shift);
+    }
+
+    TEXTSCAN_TARGET("avx2")
+    TextScan::Block classifyAvx2(const char* data)
+    {
+        RawMasks raw;
+        classify256(data, 0, raw);
+        classify256(data + 32, 32, raw);
+        return finishBlock(raw);
+    }
+
+    TEXTSCAN_TARGET("avx2")
+    size_t findAnyAvx2(const char* data, size_t size, char a, char b, char c)
+    {
+        __m256i va = _mm256_set1_epi8(a);
+        __m256i vb = _mm256_set1_epi8(b);
+        __m256i vc = _mm256_set1_epi8(c);
+        size_t pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)), _mm256_cmpeq_epi8(v, vc));
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(found));
+            if (mask)
+            {
+                return pos + static_cast<size_t>(std::countr_zero(mask));
+            }
+        }
+        return findAnyTail(data, pos, size, a, b, c);
+    }
+
+    void cpuid(int regs[4], int leaf, int subleaf)
+    {
+#if defined(_MSC_VER)
+        __cpuidex(regs, leaf, subleaf);
+#else
+        unsigned a = 0, b = 0, c = 0, d = 0;
+        __cpuid_count(leaf, subleaf, a, b, c, d);
+        regs[0] = static_cast<int>(a);
+        regs[1] = static_cast<int>(b);
+        regs[2] = static_cast<int>(c);
+        regs[3] = static_cast<int>(d);
+#endif
+    }
+
+    // Регистры, которые сохраняет ОС (XCR0)
+    uint64_t enabledStateMask()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned low = 0, high = 0;
+        __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+        return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+    }
+#endif
+
+    TextScan::Level detectLevel()
+    {
+#ifdef TEXTSCAN_X86
+        int regs[4];
+        cpuid(regs, 0, 0);
+        int maxLeaf = regs[0];
+
+        cpuid(regs, 1, 0);
+        bool sse2 = (regs[3] & (1 << 26)) != 0;
+        bool osxsave = (regs[2] & (1 << 27)) != 0;
+        bool avx = (regs[2] & (1 << 28)) != 0;
+        if (!sse2)
+        {
+            return TextScan::Level::Scalar;
+        }
+
+        // AVX2 годится, только если ОС сохраняет регистры YMM
+        if (maxLeaf >= 7 && osxsave && avx && (enabledStateMask() & 0x6) == 0x6)
+        {
+            cpuid(regs, 7, 0);
+            if (regs[1] & (1 << 5))
+            {
+                return TextScan::Level::Avx2;
+            }
+        }
+        return TextScan::Level::Sse2;
+#else
+        return TextScan::Level::Scalar;
+#endif
+    }
+
+    struct Kernels
+    {
+        TextScan::Level level;
+        TextScan::Block (*classify)(const char*);
+        size_t (*findAny)(const char*, size_t, char, char, char);
+    };
+
+    constexpr Kernels kScalarKernels{ TextScan::Level::Scalar, classifyScalar, findAnyScalar };
+#ifdef TEXTSCAN_X86
+    constexpr Kernels kSse2Kernels{ TextScan::Level::Sse2, classifySse2, findAnySse2 };
+    constexpr Kernels kAvx2Kernels{ TextScan::Level::Avx2, classifyAvx2, findAnyAvx2 };
+#endif
+
+    const Kernels& kernelsFor(TextScan::Level level)
+    {
+#ifdef TEXTSCAN_X86
+        switch (level)
+        {
+        case TextScan::Level::Avx2:
+            return kAvx2Kernels;
+        case TextScan::Level::Sse2:
+            return kSse2Kernels;
+        default:
+            break;
+        }
+#endif
+        return kScalarKernels;
+    }
+
+    std::atomic<const Kernels*> g_kernels{ nullptr };
+
+    const Kernels& kernels()
+    {
+        const Kernels* current = g_kernels.load(std::memory_order_acquire);
+        if (!current)
+        {
+            current = &kernelsFor(TextScan::getBestLevel());
+            g_kernels.store(current, std::memory_order_release);
+        }
+        return *current;
+    }
+}
+
+TextScan::Block TextScan::classify(const char* data)
+{
+    return kernels().classify(data);
+}
+
+size_t TextScan::findAny(const char* data, size_t size, char a, char b, char c)
+{
+    return kernels().findAny(data, size, a, b, c);
+}
+
+size_t TextScan::findByte(const char* data, size_t size, char c)
+{
+    // Один байт ищет memchr: в стандартной библиотеке он уже векторный
+    // и на длинных расстояниях быстрее общего ядра на три байта
+    const void* found = std::memchr(data, c, size);
+    return found ? static_cast<size_t>(static_cast<const char*>(found) - data) : size;
+}
+
+size_t TextScan::findByte(std::string_view text, size_t pos, char c)
+{
+    if (pos >= text.size())
+    {
+        return std::string_view::npos;
+    }
+    size_t found = pos + findByte(text.data() + pos, text.size() - pos, c);
+    return found < text.size() ? found : std::string_view::npos;
+}
+
+TextScan::Level TextScan::getLevel()
+{
+    return kernels().level;
+}
+
+TextScan::Level TextScan::getBestLevel()
+{
+    static const Level best = detectLevel();
+    return best;
+}
+
+TextScan::Level TextScan::setLevel(Level level)
+{
+    Level best = getBestLevel();
+    if (static_cast<int>(level) > static_cast<int>(best))
+    {
+        level = best;
+    }
+    g_kernels.store(&kernelsFor(level), std::memory_order_release);
+    return level;
+}
+
+const char* TextScan::getLevelName(Level level)
+{
+    switch (level)
+    {
+    case Level::Avx2:
+        return "AVX2";
+    case Level::Sse2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef TEXTSCAN_H
+#define TEXTSCAN_H
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+// Векторные примитивы просмотра текста для разбора HTML и подсчёта слов.
+// Байты сравниваются по 16 (SSE2) или 32 (AVX2) за инструкцию, хвост
+// короче вектора и процессоры без SSE2 обрабатываются таблицей классов.
+// Набор инструкций выбирается при первом вызове по CPUID, его можно
+// понизить через setLevel (для замеров и проверки совпадения результатов).
+//
+// Слова в тексте короткие, поэтому классификация возвращает битовые
+// маски классов сразу для блока: границы всех серий в нём находятся
+// операциями над масками, без отдельного вызова на каждую серию.
+//
+// Слово - как в HtmlTokenizer: латинские буквы, цифры, '_' и двухбайтовые
+// символы UTF-8 U+0400..U+07FF (кириллица и соседние алфавиты). Остальные
+// символы вне ASCII разбираются вызывающим кодом.
+class TextScan
+{
+public:
+    enum class Level
+    {
+        Scalar,
+        Sse2,
+        Avx2
+    };
+
+    // Классы байт блока текста: бит i - байт i блока
+    struct Block
+    {
+        uint64_t word;     // символы слова
+        uint64_t special;  // '<', '&' и символы вне ASCII, кроме символов слова
+        uint64_t space;    // пробельные символы (' ', \t, \n, \v, \f, \r)
+    };
+    // Остальные байты - разделители ASCII (пробелы и знаки препинания)
+
+    static constexpr size_t kBlockSize = 64;
+
+    // Классификация kBlockSize байт с data. Символ из двух байт, не
+    // поместившийся в блок целиком, попадает в special
+    static Block classify(const char* data);
+
+    // Позиция первого из байтов a, b, c, иначе size
+    static size_t findAny(const char* data, size_t size, char a, char b, char c);
+
+    // Позиция первого байта c, иначе size
+    static size_t findByte(const char* data, size_t size, char c);
+
+    // Аналог text.find(c, pos): позиция или std::string_view::npos
+    static size_t findByte(std::string_view text, size_t pos, char c);
+
+    // Текущий и лучший доступный на этом процессоре набор инструкций
+    static Level getLevel();
+    static Level getBestLevel();
+
+    // Выбор набора инструкций (не выше лучшего доступного).
+    // Возвращает установленный уровень
+    static Level setLevel(Level level);
+
+    static const char* getLevelName(Level level);
+};
+
+#endif // TEXTSCAN_H
\ No newline at end of file
@@ -0,0 +1,750 @@
+#include "UrlNormalizer.h"
+#include "WordTokenizer.h"
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <limits>
+
+namespace
+{
+    bool isAlpha(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    bool isDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    char toLower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // unreserved = ALPHA / DIGIT / "-" / "." / "_" / "~"
+    bool isUnreserved(char c)
+    {
+        return isAlpha(c) || isDigit(c) || c == '-' || c == '.' || c == '_' || c == '~';
+    }
+
+    // Символы, допустимые в пути и запросе без кодирования
+    bool isAllowed(char c, bool inQuery)
+    {
+        if (isUnreserved(c))
+        {
+            return true;
+        }
+
+        switch (c)
+        {
+        case '!': case '$': case '&': case '\'': case '(': case ')':
+        case '*': case '+': case ',': case ';': case '=':
+        case ':': case '@': case '/':
+            return true;
+        case '?':
+            return inQuery;
+        default:
+            return false;
+        }
+    }
+
+    void appendPercent(std::string& out, unsigned char c)
+    {
+        static const char digits[] = "0123456789ABCDEF";
+        out.push_back('%');
+        out.push_back(digits[c >> 4]);
+        out.push_back(digits[c & 0x0F]);
+    }
+
+    // Нормализация percent-encoding: незарезервированные символы
+    // декодируются, остальные кодируются с цифрами в верхнем регистре
+    void appendNormalized(std::string& out, std::string_view in, bool inQuery)
+    {
+        for (size_t i = 0; i < in.size(); ++i)
+        {
+            char c = in[i];
+
+            if (c == '%')
+            {
+                int high = (i + 2 < in.size()) ? hexValue(in[i + 1]) : -1;
+                int low = (high >= 0) ? hexValue(in[i + 2]) : -1;
+
+                if (high >= 0 && low >= 0)
+                {
+                    char decoded = static_cast<char>((high << 4) | low);
+                    if (isUnreserved(decoded))
+                    {
+                        out.push_back(decoded);
+                    }
+                    else
+                    {
+                        appendPercent(out, static_cast<unsigned char>(decoded));
+                    }
+                    i += 2;
+                }
+                else
+                {
+                    // Одиночный '%' кодируем сам по себе
+                    appendPercent(out, '%');
+                }
+            }
+            else if (isAllowed(c, inQuery))
+            {
+                out.push_back(c);
+            }
+            else
+            {
+                appendPercent(out, static_cast<unsigned char>(c));
+            }
+        }
+    }
+
+    // Кодирование метки домена в punycode (RFC 3492, 6.3), без префикса "xn--".
+    // false - метка слишком длинная (переполнение счётчика)
+    bool appendPunycode(std::string& out, const std::vector<uint32_t>& label)
+    {
+        constexpr uint32_t kBase = 36;
+        constexpr uint32_t kTMin = 1;
+        constexpr uint32_t kTMax = 26;
+        constexpr uint32_t kSkew = 38;
+        constexpr uint32_t kDamp = 700;
+        constexpr uint32_t kMax = std::numeric_limits<uint32_t>::max();
+
+        auto digit = [](uint32_t d) {
+            return static_cast<char>(d < 26 ? 'a' + d : '0' + (d - 26));
+        };
+
+        auto adapt = [](uint32_t delta, uint32_t points, bool first) {
+            delta = first ? delta / kDamp : delta / 2;
+            delta += delta / points;
+            uint32_t k = 0;
+            while (delta > ((kBase - kTMin) * kTMax) / 2)
+            {
+                delta /= kBase - kTMin;
+                k += kBase;
+            }
+            return k + (kBase - kTMin + 1) * delta / (delta + kSkew);
+        };
+
+        // Сначала ASCII-символы метки как есть
+        uint32_t basic = 0;
+        for (uint32_t c : label)
+        {
+            if (c < 0x80)
+            {
+                out.push_back(static_cast<char>(c));
+                ++basic;
+            }
+        }
+        if (basic > 0)
+        {
+            out.push_back('-');
+        }
+
+        uint32_t n = 0x80;
+        uint32_t delta = 0;
+        uint32_t bias = 72;
+        uint32_t handled = basic;
+        while (handled < label.size())
+        {
+            uint32_t next = kMax;
+            for (uint32_t c : label)
+            {
+                if (c >= n && c < next)
+                {
+                    next = c;
+                }
+            }
+
+            if (next - n > (kMax - delta) / (handled + 1))
+            {
+                return false;
+            }
+            delta += (next - n) * (handled + 1);
+            n = next;
+
+            for (uint32_t c : label)
+            {
+                if (c < n && ++delta == 0)
+                {
+                    return false;
+                }
+                if (c != n)
+                {
+                    continue;
+                }
+
+                uint32_t q = delta;
+                for (uint32_t k = kBase;; k += kBase)
+                {
+                    uint32_t t = k <= bias ? kTMin : (k >= bias + kTMax ? kTMax : k - bias);
+                    if (q < t)
+                    {
+                        break;
+                    }
+                    out.push_back(digit(t + (q - t) % (kBase - t)));
+                    q = (q - t) / (kBase - t);
+                }
+                out.push_back(digit(q));
+
+                bias = adapt(delta, handled + 1, handled == basic);
+                delta = 0;
+                ++handled;
+            }
+
+            ++delta;
+            ++n;
+        }
+        return true;
+    }
+
+    // Запись хоста. Регистр меняется только у букв, percent-encoding
+    // в имени не остаётся:
+    //  - IP-литерал в скобках ("[::1]") переносится как есть;
+    //  - ASCII-метки - в нижнем регистре;
+    //  - метки с не-ASCII символами (в том числе записанными через %XX
+    //    в UTF-8) - в нижнем регистре и в punycode ("xn--..."), иначе
+    //    такой хост не разрешится через DNS.
+    // false - хост некорректен
+    bool appendHost(std::string& out, std::string_view host)
+    {
+        if (host.front() == '[')
+        {
+            if (host.back() != ']')
+            {
+                return false;
+            }
+            for (char c : host)
+            {
+                out.push_back(toLower(c));
+            }
+            return true;
+        }
+
+        std::string decoded;
+        decoded.reserve(host.size());
+        for (size_t i = 0; i < host.size(); ++i)
+        {
+            if (host[i] != '%')
+            {
+                decoded.push_back(host[i]);
+                continue;
+            }
+
+            int high = (i + 2 < host.size()) ? hexValue(host[i + 1]) : -1;
+            int low = (high >= 0) ? hexValue(host[i + 2]) : -1;
+            if (low < 0)
+            {
+                return false;
+            }
+            decoded.push_back(static_cast<char>((high << 4) | low));
+            i += 2;
+        }
+
+        std::vector<uint32_t> codepoints;
+        std::string_view rest = decoded;
+        while (true)
+        {
+            size_t dotPos = rest.find('.');
+            std::string_view label = rest.substr(0, dotPos);
+
+            bool ascii = std::all_of(label.begin(), label.end(),
+                [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+            if (ascii)
+            {
+                for (char c : label)
+                {
+                    if (isAllowed(c, false) && c != ':' && c != '@' && c != '/')
+                    {
+                        out.push_back(toLower(c));
+                    }
+                    else
+                    {
+                        appendPercent(out, static_cast<unsigned char>(c));
+                    }
+                }
+            }
+            else
+            {
+                codepoints.clear();
+                for (size_t pos = 0; pos < label.size();)
+                {
+                    size_t length = 1;
+                    uint32_t c = WordTokenizer::decode(label, pos, length);
+                    if (c == 0xFFFD && length == 1)
+                    {
+                        return false;
+                    }
+
+                    // В именах доменов 'ё' и 'е' - разные буквы, а İ по UTS 46 -
+                    // это 'i' с комбинируемой точкой сверху
+                    if (c == 0x130)
+                    {
+                        codepoints.push_back('i');
+                        codepoints.push_back(0x307);
+                    }
+                    else
+                    {
+                        codepoints.push_back((c == 0x401 || c == 0x451) ? 0x451 : WordTokenizer::foldCase(c));
+                    }
+                    pos += length;
+                }
+
+                out.append("xn--");
+                if (!appendPunycode(out, codepoints))
+                {
+                    return false;
+                }
+            }
+
+            if (dotPos == std::string_view::npos)
+            {
+                break;
+            }
+            out.push_back('.');
+            rest.remove_prefix(dotPos + 1);
+        }
+        return true;
+    }
+
+    bool startsWith(std::string_view s, std::string_view prefix)
+    {
+        return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    // Удаление последнего сегмента из уже записанного пути
+    void popSegment(std::string& out, size_t pathStart)
+    {
+        size_t slash = out.find_last_of('/');
+        if (slash == std::string::npos || slash < pathStart)
+        {
+            out.resize(pathStart);
+        }
+        else
+        {
+            out.resize(slash);
+        }
+    }
+
+    // remove_dot_segments (RFC 3986, 5.2.4) с записью результата в out
+    void appendWithoutDotSegments(std::string& out, std::string_view input)
+    {
+        static constexpr std::string_view kSlash = "/";
+        size_t pathStart = out.size();
+
+        while (!input.empty())
+        {
+            if (startsWith(input, "../"))
+            {
+                input.remove_prefix(3);
+            }
+            else if (startsWith(input, "./"))
+            {
+                input.remove_prefix(2);
+            }
+            else if (startsWith(input, "/./"))
+            {
+                input.remove_prefix(2);
+            }
+            else if (input == "/.")
+            {
+                input = kSlash;
+            }
+            else if (startsWith(input, "/../"))
+            {
+                input.remove_prefix(3);
+                popSegment(out, pathStart);
+            }
+            else if (input == "/..")
+            {
+                input = kSlash;
+                popSegment(out, pathStart);
+            }
+            else if (input == "." || input == "..")
+            {
+                input = {};
+            }
+            else
+            {
+                // Переносим первый сегмент вместе с ведущим '/'
+                size_t next = input.find('/', input[0] == '/' ? 1 : 0);
+                if (next == std::string_view::npos)
+                {
+                    next = input.size();
+                }
+                out.append(input.substr(0, next));
+                input.remove_prefix(next);
+            }
+        }
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (toLower(a[i]) != toLower(b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+UrlNormalizer::UrlNormalizer(Rules rules)
+    : rules_(std::move(rules))
+{
+}
+
+UrlNormalizer::Components UrlNormalizer::parse(std::string_view url)
+{
+    Components result;
+
+    // scheme = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ) ":"
+    if (!url.empty() && isAlpha(url[0]))
+    {
+        size_t i = 1;
+        while (i < url.size() && (isAlpha(url[i]) || isDigit(url[i]) || url[i] == '+' || url[i] == '-' || url[i] == '.'))
+        {
+            ++i;
+        }
+        if (i < url.size() && url[i] == ':')
+        {
+            result.scheme = url.substr(0, i);
+            url.remove_prefix(i + 1);
+        }
+    }
+
+    if (startsWith(url, "//"))
+    {
+        url.remove_prefix(2);
+        size_t end = url.find_first_of("/?#");
+        if (end == std::string_view::npos)
+        {
+            end = url.size();
+        }
+        result.authority = url.substr(0, end);
+        result.hasAuthority = true;
+        url.remove_prefix(end);
+    }
+
+    size_t hashPos = url.find('#');
+    if (hashPos != std::string_view::npos)
+    {
+        result.fragment = url.substr(hashPos + 1);
+        result.hasFragment = true;
+        url = url.substr(0, hashPos);
+    }
+
+    size_t queryPos = url.find('?');
+    if (queryPos != std::string_view::npos)
+    {
+        result.query = url.substr(queryPos + 1);
+        result.hasQuery = true;
+        url = url.substr(0, queryPos);
+    }
+
+    result.path = url;
+    return result;
+}
+
+bool UrlNormalizer::isStripped(std::string_view name) const
+{
+    for (const auto& pattern : rules_.stripParams)
+    {
+        if (!pattern.empty() && pattern.back() == '*')
+        {
+            std::string_view prefix(pattern.data(), pattern.size() - 1);
+            if (name.size() >= prefix.size() && equalsIgnoreCase(name.substr(0, prefix.size()), prefix))
+            {
+                return true;
+            }
+        }
+        else if (equalsIgnoreCase(name, pattern))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UrlNormalizer::build(std::string_view scheme, std::string_view authority,
+    std::string_view path, std::string_view query, bool hasQuery,
+    std::string& out) const
+{
+    // Схема: обходим только http и https
+    bool isHttps;
+    if (equalsIgnoreCase(scheme, "http"))
+    {
+        isHttps = false;
+    }
+    else if (equalsIgnoreCase(scheme, "https"))
+    {
+        isHttps = true;
+    }
+    else
+    {
+        return false;
+    }
+
+    // authority = [ userinfo "@" ] host [ ":" port ]
+    std::string_view userinfo;
+    size_t atPos = authority.rfind('@');
+    if (atPos != std::string_view::npos)
+    {
+        userinfo = authority.substr(0, atPos);
+        authority.remove_prefix(atPos + 1);
+    }
+
+    std::string_view host = authority;
+    std::string_view port;
+    size_t colonPos = authority.rfind(':');
+    size_t bracketPos = authority.rfind(']');
+    if (colonPos != std::string_view::npos && (bracketPos == std::string_view::npos || colonPos > bracketPos))
+    {
+        host = authority.substr(0, colonPos);
+        port = authority.substr(colonPos + 1);
+    }
+
+    // Точка в конце хоста ("example.com.") не меняет адрес
+    if (!host.empty() && host.back() == '.')
+    {
+        host.remove_suffix(1);
+    }
+    if (host.empty())
+    {
+        return false;
+    }
+
+    for (char c : port)
+    {
+        if (!isDigit(c))
+        {
+            return false;
+        }
+    }
+    while (port.size() > 1 && port[0] == '0')
+    {
+        port.remove_prefix(1);
+    }
+    if ((isHttps && port == "443") || (!isHttps && port == "80"))
+    {
+        port = {};
+    }
+
+    out.clear();
+    out.reserve(scheme.size() + authority.size() + path.size() + query.size() + 8);
+    out.append(isHttps ? "https://" : "http://");
+
+    if (!userinfo.empty())
+    {
+        appendNormalized(out, userinfo, false);
+        out.push_back('@');
+    }
+
+    if (!appendHost(out, host))
+    {
+        return false;
+    }
+
+    if (!port.empty())
+    {
+        out.push_back(':');
+        out.append(port);
+    }
+
+    // Путь: сначала percent-encoding (чтобы %2E стало '.'), затем точки
+    std::string normalizedPath;
+    normalizedPath.reserve(path.size());
+    appendNormalized(normalizedPath, path, false);
+
+    size_t pathStart = out.size();
+    appendWithoutDotSegments(out, normalizedPath);
+    if (out.size() == pathStart)
+    {
+        out.push_back('/');
+    }
+
+    if (!hasQuery || query.empty())
+    {
+        return true;
+    }
+
+    // Параметры запроса: нормализуем каждый, отбрасываем лишние, сортируем
+    std::string params;
+    params.reserve(query.size());
+    std::vector<std::pair<size_t, size_t>> ranges;
+
+    while (!query.empty())
+    {
+        size_t ampPos = query.find('&');
+        std::string_view param = query.substr(0, ampPos);
+        query.remove_prefix(ampPos == std::string_view::npos ? query.size() : ampPos + 1);
+
+        if (param.empty())
+        {
+            continue;
+        }
+
+        size_t start = params.size();
+        appendNormalized(params, param, true);
+
+        std::string_view normalizedParam(params.data() + start, params.size() - start);
+        if (isStripped(normalizedParam.substr(0, normalizedParam.find('='))))
+        {
+            params.resize(start);
+            continue;
+        }
+
+        ranges.emplace_back(start, params.size() - start);
+    }
+
+    if (ranges.empty())
+    {
+        return true;
+    }
+
+    if (rules_.sortParams)
+    {
+        std::stable_sort(ranges.begin(), ranges.end(),
+            [&params](const auto& a, const auto& b) {
+                return std::string_view(params.data() + a.first, a.second) <
+                    std::string_view(params.data() + b.first, b.second);
+            });
+    }
+
+    out.push_back('?');
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        if (i > 0)
+        {
+            out.push_back('&');
+        }
+        out.append(params, ranges[i].first, ranges[i].second);
+    }
+
+    return true;
+}
+
+std::string UrlNormalizer::normalize(std::string_view url) const
+{
+    // Обрезаем пробельные символы по краям
+    while (!url.empty() && static_cast<unsigned char>(url.front()) <= ' ')
+    {
+        url.remove_prefix(1);
+    }
+    while (!url.empty() && static_cast<unsigned char>(url.back()) <= ' ')
+    {
+        url.remove_suffix(1);
+    }
+
+    Components parts = parse(url);
+    std::string result;
+    std::string withScheme;
+
+    // Адрес вида "example.com/page" или "example.com:8080" - считаем,
+    // что это http. "mailto:..." и подобные схемы так не трактуются
+    if (!parts.hasAuthority && (parts.scheme.empty() || (!parts.path.empty() && isDigit(parts.path[0]))))
+    {
+        withScheme.reserve(url.size() + 7);
+        withScheme.append("http://");
+        withScheme.append(url);
+        parts = parse(withScheme);
+    }
+
+    if (!build(parts.scheme, parts.authority, parts.path, parts.query, parts.hasQuery, result))
+    {
+        result.clear();
+    }
+    return result;
+}
+
+std::string UrlNormalizer::resolve(std::string_view baseUrl, std::string_view reference) const
+{
+    while (!reference.empty() && static_cast<unsigned char>(reference.front()) <= ' ')
+    {
+        reference.remove_prefix(1);
+    }
+    while (!reference.empty() && static_cast<unsigned char>(reference.back()) <= ' ')
+    {
+        reference.remove_suffix(1);
+    }
+
+    Components ref = parse(reference);
+    std::string result;
+
+    // Ссылка только на фрагмент указывает на ту же страницу
+    if (ref.scheme.empty() && !ref.hasAuthority && ref.path.empty() && !ref.hasQuery)
+    {
+        return result;
+    }
+
+    if (!ref.scheme.empty())
+    {
+        if (!build(ref.scheme, ref.authority, ref.path, ref.query, ref.hasQuery, result))
+        {
+            result.clear();
+        }
+        return result;
+    }
+
+    Components base = parse(baseUrl);
+    if (base.scheme.empty() || !base.hasAuthority)
+    {
+        return result;
+    }
+
+    bool ok;
+    if (ref.hasAuthority)
+    {
+        ok = build(base.scheme, ref.authority, ref.path, ref.query, ref.hasQuery, result);
+    }
+    else if (ref.path.empty())
+    {
+        ok = ref.hasQuery
+            ? build(base.scheme, base.authority, base.path, ref.query, true, result)
+            : build(base.scheme, base.authority, base.path, base.query, base.hasQuery, result);
+    }
+    else if (ref.path[0] == '/')
+    {
+        ok = build(base.scheme, base.authority, ref.path, ref.query, ref.hasQuery, result);
+    }
+    else
+    {
+        // Слияние путей (RFC 3986, 5.2.3)
+        std::string merged;
+        size_t lastSlash = base.path.rfind('/');
+        if (lastSlash == std::string_view::npos)
+        {
+            merged.reserve(ref.path.size() + 1);
+            merged.push_back('/');
+        }
+        else
+        {
+            merged.reserve(lastSlash + 1 + ref.path.size());
+            merged.append(base.path.substr(0, lastSlash + 1));
+        }
+        merged.append(ref.path);
+
+        ok = build(base.scheme, base.authority, merged, ref.query, ref.hasQuery, result);
+    }
+
+    if (!ok)
+    {
+        result.clear();
+    }
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef URLNORMALIZER_H
+#define URLNORMALIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Разбор и нормализация URL по RFC 3986.
+// Приводит разные написания одного адреса к единой форме, чтобы одна
+// и та же страница не попадала в очередь несколько раз:
+//  - разрешает относительные ссылки и убирает сегменты "." и "..";
+//  - приводит схему и хост к нижнему регистру, убирает порт по умолчанию;
+//  - записывает интернационализированные имена хостов в punycode;
+//  - нормализует percent-encoding (декодирует незарезервированные символы,
+//    шестнадцатеричные цифры пишет в верхнем регистре);
+//  - убирает фрагмент (#...), параметры отслеживания и сортирует параметры запроса.
+// Разбор работает через string_view, результат пишется в один буфер.
+class UrlNormalizer
+{
+public:
+    // Правила обработки параметров запроса
+    struct Rules
+    {
+        // Имена удаляемых параметров (без учёта регистра).
+        // Шаблон с '*' на конце задаёт префикс, например "utm_*"
+        std::vector<std::string> stripParams;
+
+        // Сортировать ли параметры запроса
+        bool sortParams = true;
+    };
+
+    // Компоненты URL (указывают на исходную строку)
+    struct Components
+    {
+        std::string_view scheme;
+        std::string_view authority;
+        std::string_view path;
+        std::string_view query;
+        std::string_view fragment;
+        bool hasAuthority = false;
+        bool hasQuery = false;
+        bool hasFragment = false;
+    };
+
+    UrlNormalizer() = default;
+    explicit UrlNormalizer(Rules rules);
+
+    // Разбор URL на компоненты (RFC 3986, приложение B)
+    static Components parse(std::string_view url);
+
+    // Нормализация абсолютного URL. Адрес без схемы считается http://.
+    // Возвращает пустую строку, если URL некорректен или схема не http(s)
+    std::string normalize(std::string_view url) const;
+
+    // Разрешение ссылки reference относительно baseUrl (RFC 3986, 5.2)
+    // с последующей нормализацией. Пустая строка - ссылку нужно пропустить
+    std::string resolve(std::string_view baseUrl, std::string_view reference) const;
+
+private:
+    Rules rules_;
+
+    // Сборка нормализованного URL из компонентов
+    bool build(std::string_view scheme, std::string_view authority,
+        std::string_view path, std::string_view query, bool hasQuery,
+        std::string& out) const;
+
+    // Нужно ли удалить параметр запроса с таким именем
+    bool isStripped(std::string_view name) const;
+};
+
+#endif // URLNORMALIZER_H
\ No newline at end of file
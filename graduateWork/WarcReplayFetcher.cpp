@@ -0,0 +1,317 @@
+#include "WarcReplayFetcher.h"
+#include "HTMLDownloader.h"
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+#include <cctype>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Сравнение имени заголовка без учёта регистра
+    bool startsWithNoCase(std::string_view line, std::string_view prefix)
+    {
+        if (line.size() < prefix.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < prefix.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(line[i])) != std::tolower(static_cast<unsigned char>(prefix[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view trimView(std::string_view value)
+    {
+        size_t start = value.find_first_not_of(" \t\r\n");
+        if (start == std::string_view::npos)
+        {
+            return {};
+        }
+        size_t end = value.find_last_not_of(" \t\r\n");
+        return value.substr(start, end - start + 1);
+    }
+
+    // Следующая строка начиная с pos (без \r\n). pos сдвигается за строку
+    std::string_view nextLine(std::string_view data, size_t& pos)
+    {
+        size_t end = data.find('\n', pos);
+        if (end == std::string_view::npos)
+        {
+            end = data.size();
+        }
+        std::string_view line = data.substr(pos, end - pos);
+        pos = end < data.size() ? end + 1 : end;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+}
+
+WarcReplayFetcher::WarcReplayFetcher(const std::string& path, const UrlNormalizer& normalizer)
+    : normalizer_(normalizer)
+    , data_(nullptr)
+    , size_(0)
+#ifdef _WIN32
+    , fileHandle_(INVALID_HANDLE_VALUE)
+    , mappingHandle_(nullptr)
+#else
+    , fileDescriptor_(-1)
+#endif
+{
+    mapFile(path);
+    buildIndex();
+
+    std::cout << "WARC-архив " << path << ": " << records_.size() << " страниц" << std::endl;
+}
+
+WarcReplayFetcher::~WarcReplayFetcher()
+{
+    unmapFile();
+}
+
+void WarcReplayFetcher::mapFile(const std::string& path)
+{
+#ifdef _WIN32
+    fileHandle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle_ == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Не удалось открыть WARC-архив: " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle_, &fileSize))
+    {
+        unmapFile();
+        throw std::runtime_error("Не удалось определить размер WARC-архива: " + path);
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ == 0)
+    {
+        return;
+    }
+
+    mappingHandle_ = CreateFileMappingA(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle_)
+    {
+        data_ = static_cast<const char*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    fileDescriptor_ = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor_ < 0)
+    {
+        throw std::runtime_error("Не удалось открыть WARC-архив: " + path);
+    }
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor_, &fileStat) != 0)
+    {
+        unmapFile();
+        throw std::runtime_error("Не удалось определить размер WARC-архива: " + path);
+    }
+    size_ = static_cast<size_t>(fileStat.st_size);
+    if (size_ == 0)
+    {
+        return;
+    }
+
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fileDescriptor_, 0);
+    if (mapped != MAP_FAILED)
+    {
+        data_ = static_cast<const char*>(mapped);
+    }
+#endif
+
+    if (!data_)
+    {
+        unmapFile();
+        throw std::runtime_error("Не удалось отобразить WARC-архив в память: " + path);
+    }
+}
+
+void WarcReplayFetcher::unmapFile()
+{
+#ifdef _WIN32
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_)
+    {
+        CloseHandle(mappingHandle_);
+        mappingHandle_ = nullptr;
+    }
+    if (fileHandle_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(fileHandle_);
+        fileHandle_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data_)
+    {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (fileDescriptor_ >= 0)
+    {
+        close(fileDescriptor_);
+        fileDescriptor_ = -1;
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void WarcReplayFetcher::buildIndex()
+{
+    std::string_view data(data_ ? data_ : "", size_);
+    size_t pos = 0;
+
+    while (pos < data.size())
+    {
+        // Пропускаем пустые строки между записями
+        size_t recordStart = pos;
+        std::string_view versionLine = nextLine(data, pos);
+        if (versionLine.empty())
+        {
+            continue;
+        }
+        if (versionLine.rfind("WARC/", 0) != 0)
+        {
+            throw std::runtime_error("Повреждённый WARC-архив: ожидалась запись по смещению " +
+                std::to_string(recordStart));
+        }
+
+        // Заголовки записи
+        std::string_view type;
+        std::string_view targetUri;
+        long long contentLength = -1;
+        for (std::string_view line = nextLine(data, pos); !line.empty(); line = nextLine(data, pos))
+        {
+            size_t colonPos = line.find(':');
+            if (colonPos == std::string_view::npos)
+            {
+                continue;
+            }
+            std::string_view value = trimView(line.substr(colonPos + 1));
+            if (startsWithNoCase(line, "WARC-Type:"))
+            {
+                type = value;
+            }
+            else if (startsWithNoCase(line, "WARC-Target-URI:"))
+            {
+                targetUri = value;
+            }
+            else if (startsWithNoCase(line, "Content-Length:"))
+            {
+                contentLength = std::strtoll(std::string(value).c_str(), nullptr, 10);
+            }
+        }
+
+        if (contentLength < 0 || pos + static_cast<size_t>(contentLength) > data.size())
+        {
+            throw std::runtime_error("Повреждённый WARC-архив: неверная длина записи по смещению " +
+                std::to_string(recordStart));
+        }
+
+        size_t blockStart = pos;
+        size_t blockEnd = pos + static_cast<size_t>(contentLength);
+        pos = blockEnd;
+
+        if (type != "response" || targetUri.empty())
+        {
+            continue;
+        }
+
+        // Блок записи - HTTP-ответ: строка статуса, заголовки, пустая строка, тело
+        std::string_view block = data.substr(blockStart, blockEnd - blockStart);
+        size_t statusPos = 0;
+        std::string_view statusLine = nextLine(block, statusPos);
+        size_t spacePos = statusLine.find(' ');
+
+        Record record;
+        record.statusCode = spacePos != std::string_view::npos ?
+            std::strtol(std::string(statusLine.substr(spacePos + 1)).c_str(), nullptr, 10) : 0;
+
+        size_t headersEnd = block.find("\r\n\r\n");
+        size_t separator = 4;
+        if (headersEnd == std::string_view::npos)
+        {
+            headersEnd = block.find("\n\n");
+            separator = 2;
+        }
+        if (headersEnd == std::string_view::npos)
+        {
+            continue;
+        }
+
+        record.bodyOffset = blockStart + headersEnd + separator;
+        record.bodyLength = blockEnd - record.bodyOffset;
+
+        // Ключ - нормализованный URL, как его ищет паук. Повторные записи
+        // одного URL замещают старые: в архиве остаётся последняя версия.
+        // Ответ 304 версию не меняет - остаётся предыдущая запись
+        std::string key = normalizer_.normalize(std::string(targetUri));
+        if (key.empty())
+        {
+            continue;
+        }
+
+        auto [it, inserted] = records_.try_emplace(key, record);
+        if (!inserted && record.statusCode != 304)
+        {
+            it->second = record;
+        }
+    }
+}
+
+std::string WarcReplayFetcher::download(const std::string& url)
+{
+    auto it = records_.find(normalizer_.normalize(url));
+    if (it == records_.end())
+    {
+        throw DownloadError(DownloadError::Kind::Http, 404, "Нет в WARC-архиве: " + url);
+    }
+
+    const Record& record = it->second;
+    if (record.statusCode != 200)
+    {
+        throw DownloadError(DownloadError::Kind::Http, record.statusCode,
+            "HTTP ошибка " + std::to_string(record.statusCode) + " для URL: " + url);
+    }
+
+    return std::string(data_ + record.bodyOffset, record.bodyLength);
+}
+
+size_t WarcReplayFetcher::getRecordCount() const
+{
+    return records_.size();
+}
+
+std::vector<std::string> WarcReplayFetcher::getUrls() const
+{
+    std::vector<std::string> urls;
+    urls.reserve(records_.size());
+    for (const auto& [url, record] : records_)
+    {
+        if (record.statusCode == 200)
+        {
+            urls.push_back(url);
+        }
+    }
+    return urls;
+}
\ No newline at end of file
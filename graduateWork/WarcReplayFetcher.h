@@ -0,0 +1,60 @@
+#ifndef WARCREPLAYFETCHER_H
+#define WARCREPLAYFETCHER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include "PageFetcher.h"
+#include "UrlNormalizer.h"
+
+// Источник страниц из WARC-архива вместо сети.
+// Файл отображается в память целиком, при открытии строится индекс
+// URL -> положение тела ответа, после чего download() лишь копирует
+// тело из отображения. Обход по архиву воспроизводим и не зависит от
+// скорости сети, поэтому подходит для замеров производительности.
+class WarcReplayFetcher : public PageFetcher
+{
+public:
+    WarcReplayFetcher(const std::string& path, const UrlNormalizer& normalizer);
+    ~WarcReplayFetcher();
+
+    WarcReplayFetcher(const WarcReplayFetcher&) = delete;
+    WarcReplayFetcher& operator=(const WarcReplayFetcher&) = delete;
+
+    // Тело сохранённого ответа. Отсутствующий URL - DownloadError с кодом 404
+    std::string download(const std::string& url) override;
+
+    size_t getRecordCount() const;
+
+    // URL всех сохранённых успешных ответов (200)
+    std::vector<std::string> getUrls() const;
+
+private:
+    struct Record
+    {
+        size_t bodyOffset = 0;
+        size_t bodyLength = 0;
+        long statusCode = 0;
+    };
+
+    const UrlNormalizer& normalizer_;
+
+    // Отображение файла в память
+    const char* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* fileHandle_;
+    void* mappingHandle_;
+#else
+    int fileDescriptor_;
+#endif
+
+    std::unordered_map<std::string, Record> records_;
+
+    void mapFile(const std::string& path);
+    void unmapFile();
+    void buildIndex();
+};
+
+#endif // WARCREPLAYFETCHER_H
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "WarcWriter.h"
+#include <stdexcept>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cctype>
+
+namespace
+{
+    // Заголовки, которые после распаковки тела больше не соответствуют
+    // сохраняемым данным
+    bool isStaleHeader(const std::string& line)
+    {
+        std::string name = line.substr(0, line.find(':'));
+        for (auto& c : name)
+        {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return name == "content-encoding" || name == "content-length" || name == "transfer-encoding";
+    }
+}
+
+WarcWriter::WarcWriter(const std::string& path)
+    : path_(path)
+    , out_(path, std::ios::binary | std::ios::app)
+    , recordsWritten_(0)
+{
+    if (!out_)
+    {
+        throw std::runtime_error("Не удалось открыть WARC-файл для записи: " + path);
+    }
+
+    // Запись warcinfo в начале каждого сеанса записи
+    writeRecord("warcinfo", "", "application/warc-fields",
+        "software: SearchEngineBot/1.0\r\nformat: WARC File Format 1.0\r\n");
+}
+
+std::string WarcWriter::makeRecordId()
+{
+    // UUID версии 4
+    thread_local std::mt19937_64 generator(std::random_device{}() ^
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    uint64_t high = generator();
+    uint64_t low = generator();
+    high = (high & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
+    low = (low & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "<urn:uuid:%08x-%04x-%04x-%04x-%012llx>",
+        static_cast<unsigned>(high >> 32),
+        static_cast<unsigned>((high >> 16) & 0xFFFF),
+        static_cast<unsigned>(high & 0xFFFF),
+        static_cast<unsigned>(low >> 48),
+        static_cast<unsigned long long>(low & 0xFFFFFFFFFFFFULL));
+    return buffer;
+}
+
+std::string WarcWriter::currentDate()
+{
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+void WarcWriter::writeRecord(const std::string& type, const std::string& url,
+    const std::string& contentType, const std::string& payload)
+{
+    std::ostringstream header;
+    header << "WARC/1.0\r\n"
+        << "WARC-Type: " << type << "\r\n"
+        << "WARC-Record-ID: " << makeRecordId() << "\r\n"
+        << "WARC-Date: " << currentDate() << "\r\n";
+    if (!url.empty())
+    {
+        header << "WARC-Target-URI: " << url << "\r\n";
+    }
+    header << "Content-Type: " << contentType << "\r\n"
+        << "Content-Length: " << payload.size() << "\r\n"
+        << "\r\n";
+
+    std::string headerText = header.str();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_.write(headerText.data(), static_cast<std::streamsize>(headerText.size()));
+    out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    out_.write("\r\n\r\n", 4);
+    out_.flush();
+
+    if (!out_)
+    {
+        throw std::runtime_error("Ошибка записи в WARC-файл: " + path_);
+    }
+}
+
+void WarcWriter::writeResponse(const std::string& url, const std::string& httpHeaders, const std::string& body)
+{
+    // Пересобираем блок заголовков: тело уже распаковано, поэтому
+    // Content-Encoding и Content-Length заменяем фактическим размером
+    std::string payload;
+    payload.reserve(httpHeaders.size() + body.size() + 64);
+
+    std::istringstream lines(httpHeaders);
+    std::string line;
+    bool statusWritten = false;
+    while (std::getline(lines, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty())
+        {
+            continue;
+        }
+        if (!statusWritten)
+        {
+            payload += line + "\r\n";
+            statusWritten = true;
+            continue;
+        }
+        if (!isStaleHeader(line))
+        {
+            payload += line + "\r\n";
+        }
+    }
+
+    if (!statusWritten)
+    {
+        payload += "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n";
+    }
+
+    payload += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+    payload += body;
+
+    writeRecord("response", url, "application/http; msgtype=response", payload);
+    recordsWritten_++;
+}
+
+long long WarcWriter::getRecordsWritten() const
+{
+    return recordsWritten_;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef WARCWRITER_H
+#define WARCWRITER_H
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+
+// Запись полученных ответов в архив формата WARC 1.0 (ISO 28500).
+// Каждый ответ на запрос страницы (включая 304, редиректы и ошибки)
+// сохраняется записью типа "response" с HTTP-заголовками и телом. Такой архив потом можно проиграть через
+// WarcReplayFetcher без доступа к сети.
+class WarcWriter
+{
+public:
+    // Открывает файл на дозапись (создаёт при отсутствии)
+    explicit WarcWriter(const std::string& path);
+
+    WarcWriter(const WarcWriter&) = delete;
+    WarcWriter& operator=(const WarcWriter&) = delete;
+
+    // Запись ответа. httpHeaders - строка статуса и заголовки в том виде,
+    // в каком их прислал сервер; body - тело после распаковки
+    void writeResponse(const std::string& url, const std::string& httpHeaders, const std::string& body);
+
+    long long getRecordsWritten() const;
+
+private:
+    std::string path_;
+    std::ofstream out_;
+    std::mutex mutex_;
+    std::atomic<long long> recordsWritten_;
+
+    void writeRecord(const std::string& type, const std::string& url,
+        const std::string& contentType, const std::string& payload);
+
+    static std::string makeRecordId();
+    static std::string currentDate();
+};
+
+#endif // WARCWRITER_H
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "WordTokenizer.h"
+#include <array>
+
+namespace
+{
+    // Свёртка регистра для кодовых точек ниже kFoldLimit, выше - без изменений
+    constexpr uint32_t kFoldLimit = 0x500;
+
+    constexpr std::array<uint16_t, kFoldLimit> kFold = [] {
+        std::array<uint16_t, kFoldLimit> fold{};
+        for (uint32_t c = 0; c < kFoldLimit; ++c)
+        {
+            fold[c] = static_cast<uint16_t>(c);
+        }
+
+        // Пары "заглавная - строчная" на соседних кодах
+        auto pairs = [&fold](uint32_t first, uint32_t last, uint32_t upperParity) {
+            for (uint32_t c = first; c <= last; ++c)
+            {
+                if (c % 2 == upperParity)
+                {
+                    fold[c] = static_cast<uint16_t>(c + 1);
+                }
+            }
+        };
+
+        // ASCII и Latin-1 (кроме знака умножения)
+        for (uint32_t c = 'A'; c <= 'Z'; ++c)
+        {
+            fold[c] = static_cast<uint16_t>(c + 0x20);
+        }
+        for (uint32_t c = 0xC0; c <= 0xDE; ++c)
+        {
+            if (c != 0xD7)
+            {
+                fold[c] = static_cast<uint16_t>(c + 0x20);
+            }
+        }
+
+        // Latin Extended-A. İ (I с точкой) - это заглавная обычной 'i',
+        // а не соседней ı без точки
+        pairs(0x100, 0x137, 0);
+        fold[0x130] = 'i';
+        pairs(0x139, 0x148, 1);
+        pairs(0x14A, 0x177, 0);
+        fold[0x178] = 0xFF;
+        pairs(0x179, 0x17E, 1);
+
+        // Кириллица: Ѐ..Џ, А..Я и расширенные буквы парами
+        for (uint32_t c = 0x400; c <= 0x40F; ++c)
+        {
+            fold[c] = static_cast<uint16_t>(c + 0x50);
+        }
+        for (uint32_t c = 0x410; c <= 0x42F; ++c)
+        {
+            fold[c] = static_cast<uint16_t>(c + 0x20);
+        }
+        pairs(0x460, 0x481, 0);
+        pairs(0x48A, 0x4BF, 0);
+        fold[0x4C0] = 0x4CF;
+        pairs(0x4C1, 0x4CE, 1);
+        pairs(0x4D0, 0x4FF, 0);
+
+        // 'ё' и 'е' пишут вперемешку - в индексе это одна буква
+        fold[0x401] = 0x435;
+        fold[0x451] = 0x435;
+        return fold;
+    }();
+
+    // Свёртка на месте возможна, только если запись в UTF-8 не удлиняется
+    constexpr size_t utf8Length(uint32_t codepoint)
+    {
+        return codepoint < 0x80 ? 1 : codepoint < 0x800 ? 2 : 3;
+    }
+
+    constexpr bool neverGrows()
+    {
+        for (uint32_t c = 0; c < kFoldLimit; ++c)
+        {
+            if (utf8Length(kFold[c]) > utf8Length(c))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(neverGrows(), "свёртка регистра не должна удлинять запись в байтах");
+
+    // Первые байты двухбайтовых последовательностей для кодов ниже kFoldLimit
+    constexpr unsigned char kFoldLeadFirst = 0xC2;
+    constexpr unsigned char kFoldLeadLast = 0xC0 | ((kFoldLimit - 1) >> 6);
+
+    constexpr bool isAsciiDigit(uint32_t codepoint)
+    {
+        return codepoint >= '0' && codepoint <= '9';
+    }
+}
+
+uint32_t WordTokenizer::decode(std::string_view text, size_t pos, size_t& length)
+{
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    length = 1;
+    if (lead < 0x80)
+    {
+        return lead;
+    }
+
+    size_t expected;
+    uint32_t codepoint;
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        expected = 2;
+        codepoint = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        expected = 3;
+        codepoint = lead & 0x0F;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        expected = 4;
+        codepoint = lead & 0x07;
+    }
+    else
+    {
+        return 0xFFFD;
+    }
+
+    if (pos + expected > text.size())
+    {
+        return 0xFFFD;
+    }
+    for (size_t i = 1; i < expected; ++i)
+    {
+        unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xC0) != 0x80)
+        {
+            return 0xFFFD;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+
+    // Избыточная запись и суррогаты
+    if ((expected == 3 && (codepoint < 0x800 || (codepoint >= 0xD800 && codepoint <= 0xDFFF))) ||
+        (expected == 4 && (codepoint < 0x10000 || codepoint > 0x10FFFF)))
+    {
+        return 0xFFFD;
+    }
+
+    length = expected;
+    return codepoint;
+}
+
+uint32_t WordTokenizer::foldCase(uint32_t codepoint)
+{
+    return codepoint < kFoldLimit ? kFold[codepoint] : codepoint;
+}
+
+bool WordTokenizer::isWordCodepoint(uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        return isAsciiDigit(codepoint) || (codepoint >= 'a' && codepoint <= 'z') ||
+            (codepoint >= 'A' && codepoint <= 'Z') || codepoint == '_';
+    }
+    if (codepoint <= 0xBF)
+    {
+        return codepoint == 0xAA || codepoint == 0xB5 || codepoint == 0xBA;
+    }
+    if (codepoint == 0xD7 || codepoint == 0xF7)
+    {
+        return false;
+    }
+    if ((codepoint >= 0x2000 && codepoint <= 0x2BFF) ||   // пунктуация, валюты, стрелки, математика
+        (codepoint >= 0x3000 && codepoint <= 0x303F) ||   // пунктуация CJK
+        (codepoint >= 0xE000 && codepoint <= 0xF8FF) ||   // частное использование
+        (codepoint >= 0xFE30 && codepoint <= 0xFE4F) ||
+        codepoint == 0xFFFD || codepoint >= 0x1F000)      // эмодзи и прочие символы
+    {
+        return false;
+    }
+    return true;
+}
+
+bool WordTokenizer::isLetter(uint32_t codepoint)
+{
+    return isWordCodepoint(codepoint) && !isAsciiDigit(codepoint) && codepoint != '_';
+}
+
+size_t WordTokenizer::foldCase(char* data, size_t size)
+{
+    // Запись идёт не дальше чтения: строчная форма не длиннее
+    size_t out = 0;
+    size_t pos = 0;
+    while (pos < size)
+    {
+        unsigned char c = static_cast<unsigned char>(data[pos]);
+        if (c < 0x80)
+        {
+            data[out++] = static_cast<char>(kFold[c]);
+            pos++;
+            continue;
+        }
+
+        // Таблица покрывает только двухбайтовые символы. Байты продолжения
+        // не попадают в диапазон ведущих, поэтому прочие символы
+        // проходятся по байту без изменений
+        if (c >= kFoldLeadFirst && c <= kFoldLeadLast && pos + 1 < size &&
+            (static_cast<unsigned char>(data[pos + 1]) & 0xC0) == 0x80)
+        {
+            uint32_t codepoint = ((c & 0x1Fu) << 6) | (static_cast<unsigned char>(data[pos + 1]) & 0x3Fu);
+            uint32_t folded = kFold[codepoint];
+            if (folded < 0x80)
+            {
+                data[out++] = static_cast<char>(folded);
+            }
+            else
+            {
+                data[out++] = static_cast<char>(0xC0 | (folded >> 6));
+                data[out++] = static_cast<char>(0x80 | (folded & 0x3F));
+            }
+            pos += 2;
+            continue;
+        }
+        data[out++] = data[pos++];
+    }
+    return out;
+}
+
+std::string WordTokenizer::fold(std::string_view word)
+{
+    std::string folded(word);
+    folded.resize(foldCase(folded.data(), folded.size()));
+    return folded;
+}
+
+bool WordTokenizer::isIndexable(std::string_view word)
+{
+    size_t characters = 0;
+    bool hasLetter = false;
+    size_t pos = 0;
+    while (pos < word.size() && characters <= kMaxWordLength)
+    {
+        size_t length;
+        uint32_t codepoint = decode(word, pos, length);
+        hasLetter = hasLetter || isLetter(codepoint);
+        characters++;
+        pos += length;
+    }
+    return characters >= kMinWordLength && characters <= kMaxWordLength && hasLetter;
+}
\ No newline at end of file
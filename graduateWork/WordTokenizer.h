@@ -0,0 +1,93 @@
+#ifndef WORDTOKENIZER_H
+#define WORDTOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+// Разбиение текста UTF-8 на слова и приведение слов к единой форме.
+// Общее для индексации и поиска: слово страницы и слово запроса
+// совпадают, только если обе стороны нормализованы одинаково.
+//
+// Регистр сворачивается по таблицам, построенным при компиляции:
+// латиница (ASCII, Latin-1, Latin Extended-A) и кириллица
+// (U+0400..U+04FF), 'ё' приравнивается к 'е'. Локаль не используется.
+// Свёртка никогда не удлиняет строку в байтах, но может укоротить её:
+// 'İ' (U+0130, два байта) сворачивается в ASCII 'i'.
+class WordTokenizer
+{
+public:
+    // Допустимая длина слова в символах. Верхняя граница - ширина
+    // столбца words.word (VARCHAR(32))
+    static constexpr size_t kMinWordLength = 3;
+    static constexpr size_t kMaxWordLength = 32;
+
+    // Кодовая точка в позиции pos, в length - её длина в байтах.
+    // Некорректная последовательность - U+FFFD длиной 1 байт
+    static uint32_t decode(std::string_view text, size_t pos, size_t& length);
+
+    // Строчная форма кодовой точки
+    static uint32_t foldCase(uint32_t codepoint);
+
+    // Часть слова: буквы и цифры любых алфавитов и '_'
+    static bool isWordCodepoint(uint32_t codepoint);
+
+    // Символ слова, кроме цифр и '_'
+    static bool isLetter(uint32_t codepoint);
+
+    // Свёртка регистра на месте. Возвращает новую длину: строчная
+    // форма бывает короче (İ -> i)
+    static size_t foldCase(char* data, size_t size);
+
+    // Слово в строчной форме
+    static std::string fold(std::string_view word);
+
+    // Подходит ли свёрнутое слово для индекса: длина в пределах
+    // [kMinWordLength, kMaxWordLength] и хотя бы одна буква
+    static bool isIndexable(std::string_view word);
+
+    // handler(std::string_view) для каждого слова text в строчной форме.
+    // Слово - наибольшая серия символов слова, остальное разделяет слова.
+    // Строка, переданная handler, действительна только во время вызова
+    template <typename Handler>
+    static void forEachWord(std::string_view text, Handler&& handler);
+};
+
+template <typename Handler>
+void WordTokenizer::forEachWord(std::string_view text, Handler&& handler)
+{
+    std::string word;
+    auto emit = [&](size_t start, size_t end) {
+        word.assign(text.data() + start, end - start);
+        word.resize(foldCase(word.data(), word.size()));
+        handler(std::string_view(word));
+    };
+
+    size_t start = 0;
+    bool inWord = false;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        size_t length = 1;
+        bool wordChar = isWordCodepoint(decode(text, pos, length));
+        if (wordChar && !inWord)
+        {
+            start = pos;
+            inWord = true;
+        }
+        else if (!wordChar && inWord)
+        {
+            emit(start, pos);
+            inWord = false;
+        }
+        pos += length;
+    }
+
+    if (inWord)
+    {
+        emit(start, text.size());
+    }
+}
+
+#endif // WORDTOKENIZER_H
\ No newline at end of file
@@ -4,10 +4,17 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <future>
+#include <algorithm>
+#include <cstdint>
 #include "Config.h"
 #include "Database.h"
 #include "Spider.h"
 #include "SearchServer.h"
+#include "CrawlBenchmark.h"
+#include "ScanBenchmark.h"
+#include "Indexer.h"
+#include "WarcReplayFetcher.h"
 #include <Windows.h>
 
 // Глобальные указатели для обработки сигналов
@@ -34,43 +41,196 @@ void signalHandler(int signal)
     }
 }
 
-// Функция для мониторинга паука
+// Функция для мониторинга паука. Статистика печатается по мере
+// завершения задач, но не чаще раза в pollInterval; завершение обхода
+// будит монитор сразу
 void spiderMonitor(Spider* spider)
 {
-    int idleCounter = 0;
+    const auto pollInterval = std::chrono::seconds(2);
 
-    while (g_running && spider && spider->isRunning())
+    // Обработано стадиями на прошлом выводе (для расчёта скорости)
+    std::vector<long long> lastProcessed;
+    auto lastTime = std::chrono::steady_clock::now();
+    uint64_t version = 0;
+
+    bool running = true;
+    while (g_running && spider && running)
     {
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        running = spider->waitForStats(version, pollInterval);
 
         auto stats = spider->getStats();
+        auto now = std::chrono::steady_clock::now();
+        double elapsedSeconds = std::max(0.001, std::chrono::duration<double>(now - lastTime).count());
+        lastTime = now;
 
         std::cout << "\n📊 Статистика паука:" << std::endl;
         std::cout << "   Активных потоков: " << stats.activeWorkers << std::endl;
         std::cout << "   В очереди: " << stats.queueSize << std::endl;
         std::cout << "   Загружено: " << stats.totalDownloaded << std::endl;
         std::cout << "   Проиндексировано: " << stats.totalIndexed << std::endl;
+        std::cout << "   Трафик: " << stats.wireBytes / 1024 << " КБ по сети, "
+            << stats.decodedBytes / 1024 << " КБ HTML" << std::endl;
+        std::cout << "   Дубликатов: " << stats.exactDuplicates
+            << ", почти-дубликатов: " << stats.nearDuplicates << std::endl;
+        if (stats.retries > 0 || stats.openHosts > 0)
+        {
+            std::cout << "   Повторов: " << stats.retries << ", отключено хостов: " << stats.openHosts
+                << " (отложено задач: " << stats.hostsParked << ")" << std::endl;
+        }
+        if (spider->isContinuous())
+        {
+            std::cout << "   Страниц в расписании: " << stats.recrawlTracked
+                << ", повторных визитов: " << stats.revisits
+                << " (изменилось: " << stats.revisitsChanged << ")" << std::endl;
+        }
+        if (stats.robotsBlocked > 0 || stats.sitemapUrls > 0)
+        {
+            std::cout << "   Запрещено robots.txt: " << stats.robotsBlocked
+                << ", из карт сайта: " << stats.sitemapUrls << std::endl;
+        }
+        if (stats.linksForwarded > 0 || stats.linksReceived > 0)
+        {
+            std::cout << "   Ссылок другим шардам: " << stats.linksForwarded
+                << ", от других шардов: " << stats.linksReceived << std::endl;
+        }
 
-        // Если очередь пуста и нет активных потоков - паук завершил работу
-        if (stats.queueSize == 0 && stats.activeWorkers == 0)
+        // Состояние стадий конвейера: по очередям и занятости видно узкое место
+        lastProcessed.resize(stats.stages.size(), 0);
+        for (size_t i = 0; i < stats.stages.size(); ++i)
         {
-            idleCounter++;
-            if (idleCounter > 3) // Даем время на завершение всех потоков
+            const auto& stage = stats.stages[i];
+            double rate = static_cast<double>(stage.processed - lastProcessed[i]) / elapsedSeconds;
+            lastProcessed[i] = stage.processed;
+
+            std::cout << "   [" << stage.name << "] потоков: " << stage.busy << "/" << stage.concurrencyLimit
+                << ", очередь: " << stage.queueSize;
+            if (stage.queueCapacity > 0)
             {
-                std::cout << "\n✅ Паук завершил обход всех страниц!" << std::endl;
-                break;
+                std::cout << "/" << stage.queueCapacity;
             }
+            std::cout << ", обработано: " << stage.processed << " (" << rate << "/с)"
+                << ", ошибок: " << stage.failed
+                << ", среднее: " << stage.avgMillis << " мс"
+                << ", p99: " << stage.p99Millis << " мс" << std::endl;
         }
-        else
+    }
+
+    // Обход завершён сам: дожидаемся выхода потоков и сохраняем состояние
+    if (spider && spider->isComplete())
+    {
+        std::cout << "\n✅ Паук завершил обход всех страниц!" << std::endl;
+        spider->stop();
+    }
+}
+
+// Переиндексация записанного обхода (WARC) без паука и сети: страницы
+// индексируются пакетами во всех ядрах и сохраняются в БД порциями
+void indexCorpus(const Config& config, Database& db, const std::string& path)
+{
+    // Сколько страниц архива держать в памяти одновременно
+    const size_t sliceSize = 1024;
+
+    UrlNormalizer normalizer(UrlNormalizer::Rules{ config.getSpiderStripQueryParams(), config.shouldSortQueryParams() });
+    WarcReplayFetcher archive(path, normalizer);
+    std::vector<std::string> urls = archive.getUrls();
+
+    Indexer indexer(Stemmer::fromNames(config.getIndexStemmers()),
+        StopWords(Stemmer::parseLanguages(config.getIndexStopWords()), config.getIndexStopWordsFile()));
+
+    std::cout << "   Страниц в архиве: " << urls.size() << std::endl;
+
+    std::atomic<long long> stored{ 0 };
+    std::atomic<long long> failed{ 0 };
+    auto start = std::chrono::steady_clock::now();
+
+    // Порция сохраняется одной транзакцией, пока индексируется следующая.
+    // Ошибка откатывает всю порцию - тогда документы сохраняются по одному
+    auto saveSlice = [&db, &stored, &failed](std::vector<Database::DocumentData> documents) {
+        try
         {
-            idleCounter = 0;
+            db.savingDocuments(documents);
+            stored += static_cast<long long>(documents.size());
+            return;
         }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Ошибка сохранения порции в БД: " << e.what() << std::endl;
+        }
+
+        for (const auto& document : documents)
+        {
+            try
+            {
+                db.savingDocuments(std::span<const Database::DocumentData>(&document, 1));
+                stored++;
+            }
+            catch (const std::exception& e)
+            {
+                failed++;
+                std::cerr << "Ошибка сохранения в БД " << document.url << ": " << e.what() << std::endl;
+            }
+        }
+    };
+    std::future<void> saving;
+
+    std::vector<std::string> bodies;
+    std::vector<Indexer::PageInput> inputs;
+    for (size_t first = 0; first < urls.size() && g_running; first += sliceSize)
+    {
+        size_t last = std::min(urls.size(), first + sliceSize);
+        bodies.clear();
+        inputs.clear();
+        for (size_t i = first; i < last; ++i)
+        {
+            bodies.push_back(archive.download(urls[i]));
+        }
+        for (size_t i = first; i < last; ++i)
+        {
+            inputs.push_back({ urls[i], bodies[i - first] });
+        }
+
+        std::vector<Indexer::IndexingResult> results = indexer.indexBatch(inputs);
+
+        // Неразобранная страница не должна затереть в БД прошлую версию
+        std::vector<Database::DocumentData> documents;
+        documents.reserve(results.size());
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            Indexer::IndexingResult& result = results[i];
+            if (!result.indexed)
+            {
+                failed++;
+                continue;
+            }
+
+            Database::DocumentData& document = documents.emplace_back();
+            document.url = urls[first + i];
+            document.title = std::move(result.title);
+            if (!result.noIndex)
+            {
+                document.content = std::move(result.cleanContent);
+                document.wordOffsets = std::move(result.wordOffsets);
+                document.words = std::move(result.wordsFrequency);
+            }
+        }
+
+        if (saving.valid())
+        {
+            saving.get();
+        }
+        saving = std::async(std::launch::async, saveSlice, std::move(documents));
+
+        double seconds = std::max(0.001, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        std::cout << "📊 Проиндексировано: " << last << "/" << urls.size()
+            << " (" << static_cast<long long>(last / seconds) << " стр/с)" << std::endl;
     }
 
-    if (spider && spider->isRunning())
+    if (saving.valid())
     {
-        spider->stop();
+        saving.get();
     }
+
+    std::cout << "\n✅ Переиндексация завершена: сохранено " << stored << ", ошибок " << failed << std::endl;
 }
 
 int main(int argc, char* argv[])
@@ -89,17 +249,61 @@ int main(int argc, char* argv[])
         std::signal(SIGINT, signalHandler);
         std::signal(SIGTERM, signalHandler);
 
-        // Определяем путь к конфигурационному файлу
+        // Разбираем аргументы: путь к конфигурационному файлу и режим замера
         std::string configFile = "config.ini";
-        if (argc > 1)
+        bool benchmarkMode = false;
+        bool scanBenchmarkMode = false;
+        std::string scanCorpusPath;
+        std::string indexCorpusPath;
+        int shardIndex = -1;
+        for (int i = 1; i < argc; ++i)
         {
-            configFile = argv[1];
+            std::string argument = argv[i];
+            if (argument == "--bench")
+            {
+                benchmarkMode = true;
+            }
+            else if (argument == "--bench-scan" || argument.rfind("--bench-scan=", 0) == 0)
+            {
+                // Путь к WARC-архиву или каталогу со страницами (необязательно)
+                scanBenchmarkMode = true;
+                scanCorpusPath = argument.size() > 13 ? argument.substr(13) : "";
+            }
+            else if (argument.rfind("--index-corpus=", 0) == 0)
+            {
+                // WARC-архив для переиндексации без паука
+                indexCorpusPath = argument.substr(15);
+            }
+            else if (argument.rfind("--shard=", 0) == 0)
+            {
+                shardIndex = std::stoi(argument.substr(8));
+            }
+            else
+            {
+                configFile = argument;
+            }
         }
 
         std::cout << "\n📄 Загрузка конфигурации из: " << configFile << std::endl;
 
         // Загружаем конфигурацию
         Config config(configFile);
+        if (shardIndex >= 0)
+        {
+            config.setSpiderShardIndex(shardIndex);
+        }
+
+        // Замер разбора страниц: без базы данных и сети
+        if (scanBenchmarkMode)
+        {
+            std::cout << "\n⏱️  Замер просмотра страниц" << std::endl;
+            ScanBenchmark benchmark(config);
+            ScanBenchmark::printReport(benchmark.run(scanCorpusPath));
+            return 0;
+        }
+
+        // Поисковый сервер запускает только шард 0: все шарды пишут в одну БД
+        bool runSearchServer = config.getSpiderShardIndex() == 0;
 
         // Подключаемся к базе данных
         std::cout << "💾 Подключение к базе данных..." << std::endl;
@@ -109,6 +313,23 @@ int main(int argc, char* argv[])
         std::cout << "🗃️  Создание таблиц БД..." << std::endl;
         db.creatingTables();
 
+        // Переиндексация архива: без паука и поискового сервера
+        if (!indexCorpusPath.empty())
+        {
+            std::cout << "\n📚 Переиндексация архива: " << indexCorpusPath << std::endl;
+            indexCorpus(config, db, indexCorpusPath);
+            return 0;
+        }
+
+        // Режим замера: только паук на синтетическом сайте, без поискового сервера
+        if (benchmarkMode)
+        {
+            std::cout << "\n⏱️  Нагрузочный замер паука" << std::endl;
+            CrawlBenchmark benchmark(config, db);
+            CrawlBenchmark::printReport(benchmark.run());
+            return 0;
+        }
+
         // Получаем начальную статистику
         auto initialStats = db.getStatistics();
         std::cout << "\n📈 Текущая статистика базы данных:" << std::endl;
@@ -116,18 +337,27 @@ int main(int argc, char* argv[])
         std::cout << "   Уникальных слов: " << initialStats.wordsCount << std::endl;
 
         // ЗАПУСКАЕМ ПОИСКОВЫЙ СЕРВЕР
-        std::cout << "\n🌐 Инициализация поискового сервера..." << std::endl;
-        std::cout << "   Порт: " << config.getSearcherPort() << std::endl;
+        std::thread serverThread;
+        if (runSearchServer)
+        {
+            std::cout << "\n🌐 Инициализация поискового сервера..." << std::endl;
+            std::cout << "   Порт: " << config.getSearcherPort() << std::endl;
 
-        g_searchServer = std::make_unique<SearchServer>(config, db);
+            g_searchServer = std::make_unique<SearchServer>(config, db);
 
-        // Запускаем сервер в отдельном потоке
-        std::thread serverThread([&]() {
-            g_searchServer->start();
-            });
+            // Запускаем сервер в отдельном потоке
+            serverThread = std::thread([&]() {
+                g_searchServer->start();
+                });
 
-        // Даем серверу время запуститься
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+            // Даем серверу время запуститься
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+        else
+        {
+            std::cout << "\n🔀 Шард " << config.getSpiderShardIndex()
+                << ": поисковый сервер работает в шарде 0" << std::endl;
+        }
 
         std::thread spiderMonitorThread;
         std::thread spiderThread;
@@ -140,6 +370,14 @@ int main(int argc, char* argv[])
 
             g_spider = std::make_unique<Spider>(config, db);
 
+            // Сообщение о завершении обхода выводится один раз, в момент завершения
+            g_spider->onComplete([]() {
+                if (g_searchServer && g_searchServer->isRunning())
+                {
+                    std::cout << "🔄 Сервер продолжает работу. Нажмите Ctrl+C для выхода." << std::endl;
+                }
+                });
+
             // Запускаем паука в отдельном потоке
             spiderThread = std::thread([&]() {
                 g_spider->start();
@@ -171,18 +409,6 @@ int main(int argc, char* argv[])
         while (g_running)
         {
             std::this_thread::sleep_for(std::chrono::seconds(1));
-
-            // Проверяем, не завершился ли паук самостоятельно
-            if (config.shouldRunSpider() && g_spider && !g_spider->isRunning())
-            {
-                std::cout << "\n✅ Паук завершил работу автоматически" << std::endl;
-
-                // Если паук завершился, но сервер продолжает работу
-                if (g_searchServer && g_searchServer->isRunning())
-                {
-                    std::cout << "🔄 Сервер продолжает работу. Нажмите Ctrl+C для выхода." << std::endl;
-                }
-            }
         }
 
         std::cout << "\n👋 Завершение работы поисковой системы" << std::endl;